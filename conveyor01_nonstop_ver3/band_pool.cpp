@@ -0,0 +1,70 @@
+#include "band_pool.hpp"
+#include <algorithm>
+
+BandWorkerPool::BandWorkerPool(int threads, std::function<void(int)> onWorkerStart)
+    : bands_(std::max(threads, 1)) {
+    workers_.reserve(bands_ - 1);
+    for (int band = 1; band < bands_; band++) {
+        workers_.emplace_back(&BandWorkerPool::workerLoop, this, band, onWorkerStart);
+    }
+}
+
+BandWorkerPool::~BandWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    startCond_.notify_all();
+    for (auto& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void BandWorkerPool::dispatch(TaskFn fn, void* ctx) {
+    if (bands_ == 1) {
+        fn(ctx, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = fn;
+        taskCtx_ = ctx;
+        pending_ = bands_ - 1;
+        generation_++;
+    }
+    startCond_.notify_all();
+
+    // 호출 스레드는 0번 띠 처리
+    fn(ctx, 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCond_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void BandWorkerPool::workerLoop(int band, std::function<void(int)> onWorkerStart) {
+    if (onWorkerStart) onWorkerStart(band);
+
+    uint64_t seen = 0;
+    while (true) {
+        TaskFn fn;
+        void* ctx;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            startCond_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+            fn = task_;
+            ctx = taskCtx_;
+        }
+
+        fn(ctx, band);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last = (--pending_ == 0);
+        }
+        if (last) doneCond_.notify_one();
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef BAND_POOL_HPP
+#define BAND_POOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+/*
+ * 프레임을 가로 띠(band)로 나눠 병렬 처리하는 고정 작업자 풀
+ * - 스레드는 생성자에서 한 번만 만들고 프레임마다 깨워서 사용 (프레임당 스레드 생성 없음)
+ * - 띠 i는 항상 같은 스레드가 처리 (0번 띠는 run()을 호출한 스레드)
+ * - 띠 경계는 bandRange()로 결정 - 같은 스레드 수면 항상 같은 분할
+ * - run()은 한 스레드에서만 호출
+ */
+class BandWorkerPool {
+public:
+    /*
+     * threads: 띠 수 = 전체 스레드 수 (호출 스레드 포함, 1이면 작업자 없음)
+     * onWorkerStart: 각 작업자 스레드 시작 시 호출 (우선순위/CPU 설정용, 인자는 띠 번호)
+     */
+    explicit BandWorkerPool(int threads, std::function<void(int)> onWorkerStart = nullptr);
+    ~BandWorkerPool();
+
+    BandWorkerPool(const BandWorkerPool&) = delete;
+    BandWorkerPool& operator=(const BandWorkerPool&) = delete;
+
+    int bands() const { return bands_; }
+
+    /*
+     * 띠 band의 행 범위 [y0, y1)
+     */
+    static void bandRange(int band, int bands, int rows, int& y0, int& y1) {
+        y0 = static_cast<int>(static_cast<int64_t>(rows) * band / bands);
+        y1 = static_cast<int>(static_cast<int64_t>(rows) * (band + 1) / bands);
+    }
+
+    /*
+     * 모든 띠에 fn(band)를 실행하고 전부 끝날 때까지 대기
+     * - fn은 호출이 끝날 때까지만 참조하므로 지역 람다를 그대로 넘겨도 됨 (할당 없음)
+     */
+    template <typename F>
+    void run(F& fn) {
+        dispatch(&invoke<F>, &fn);
+    }
+
+private:
+    using TaskFn = void (*)(void* ctx, int band);
+
+    template <typename F>
+    static void invoke(void* ctx, int band) { (*static_cast<F*>(ctx))(band); }
+
+    void dispatch(TaskFn fn, void* ctx);
+    void workerLoop(int band, std::function<void(int)> onWorkerStart);
+
+    int bands_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable startCond_;
+    std::condition_variable doneCond_;
+    uint64_t generation_ = 0;   // run() 호출마다 증가
+    int pending_ = 0;           // 아직 끝나지 않은 작업자 수
+    bool stopping_ = false;
+    TaskFn task_ = nullptr;
+    void* taskCtx_ = nullptr;
+};
+
+#endif
@@ -0,0 +1,334 @@
+#include "camera_capture.hpp"
+#include <opencv2/imgproc.hpp>
+#include <chrono>
+#include <iostream>
+#include <cstring>
+
+namespace {
+
+// 평면 하나를 stride를 제거하며 연속 버퍼로 복사하고 다음 기록 위치를 반환
+uint8_t* packPlane(uint8_t* dst, const GstVideoFrame& frame, int plane, int rowBytes, int rows) {
+    const uint8_t* src = static_cast<const uint8_t*>(GST_VIDEO_FRAME_PLANE_DATA(&frame, plane));
+    const int stride = GST_VIDEO_FRAME_PLANE_STRIDE(&frame, plane);
+    for (int y = 0; y < rows; y++) {
+        std::memcpy(dst, src + static_cast<size_t>(y) * stride, rowBytes);
+        dst += rowBytes;
+    }
+    return dst;
+}
+
+// 프레임 없이 이만큼 지날 때마다 읽기 실패 1회
+const int64_t kStallNs = 1000000000LL;
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t bufferPts(GstBuffer* buffer) {
+    GstClockTime pts = GST_BUFFER_PTS(buffer);
+    return GST_CLOCK_TIME_IS_VALID(pts) ? static_cast<int64_t>(pts) : -1;
+}
+
+}
+
+CameraCapture::~CameraCapture() {
+    close();
+}
+
+std::string CameraCapture::buildPipeline(const CaptureConfig& cfg) {
+    const std::string lowCaps =
+        "video/x-raw,width=" + std::to_string(cfg.width) +
+        ",height=" + std::to_string(cfg.height) +
+        ",framerate=" + std::to_string(cfg.fps) + "/1";
+    // 감지 스트림은 BGR 1장만 유지 (늦게 읽으면 이전 프레임은 버림)
+    const std::string detectBranch =
+        lowCaps + " ! videoconvert ! videoscale ! video/x-raw,format=BGR ! "
+        "appsink name=detect drop=true max-buffers=1 sync=false";
+
+    if (cfg.hiresWidth <= 0 || cfg.hiresHeight <= 0) {
+        return "libcamerasrc ! " + detectBranch;
+    }
+
+    // libcamera 다중 스트림: src는 감지용, src_0은 고해상도 (둘 다 ISP에서 스케일)
+    // 고해상도 쪽은 변환 없이 원본 포맷으로 최신 1장만 보관
+    return "libcamerasrc name=cam src::stream-role=video-recording src_0::stream-role=still-capture "
+           "cam.src ! " + detectBranch + " "
+           "cam.src_0 ! video/x-raw,width=" + std::to_string(cfg.hiresWidth) +
+           ",height=" + std::to_string(cfg.hiresHeight) + " ! "
+           "queue leaky=downstream max-size-buffers=1 ! "
+           "appsink name=hires drop=true max-buffers=1 sync=false";
+}
+
+bool CameraCapture::open(const CaptureConfig& cfg) {
+    close();
+    cfg_ = cfg;
+    framePeriodNs_ = cfg.fps > 0 ? 1000000000LL / cfg.fps : 0;
+    lastPtsNs_ = -1;
+    lastFrameNs_ = stallMarkNs_ = steadyNowNs();
+
+    GError* err = nullptr;
+    if (!gst_init_check(nullptr, nullptr, &err)) {
+        std::cerr << "[캡처] GStreamer 초기화 실패 - " << (err ? err->message : "?") << std::endl;
+        g_clear_error(&err);
+        return false;
+    }
+
+    const std::string desc = buildPipeline(cfg);
+    pipeline_ = gst_parse_launch(desc.c_str(), &err);
+    if (err) {
+        std::cerr << "[캡처] 파이프라인 생성 실패 - " << err->message << "\n  " << desc << std::endl;
+        g_clear_error(&err);
+        close();
+        return false;
+    }
+
+    detectSink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "detect");
+    if (cfg.hiresWidth > 0 && cfg.hiresHeight > 0) {
+        hiresSink_ = gst_bin_get_by_name(GST_BIN(pipeline_), "hires");
+    }
+    if (!detectSink_ || (cfg.hiresWidth > 0 && !hiresSink_)) {
+        std::cerr << "[캡처] appsink를 찾을 수 없습니다." << std::endl;
+        close();
+        return false;
+    }
+
+    // 감지 스트림은 콜백으로 받음 (emit-signals 없이 직접 호출되므로 오버헤드 최소)
+    GstAppSinkCallbacks callbacks = {};
+    callbacks.eos = &CameraCapture::onEos;
+    callbacks.new_sample = &CameraCapture::onNewSample;
+    gst_app_sink_set_callbacks(GST_APP_SINK(detectSink_), &callbacks, this, nullptr);
+
+    if (gst_element_set_state(pipeline_, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        std::cerr << "[캡처] 파이프라인 시작 실패" << std::endl;
+        reportErrors();
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CameraCapture::close() {
+    if (pipeline_) {
+        gst_element_set_state(pipeline_, GST_STATE_NULL);
+    }
+    // 스트리밍이 멈춘 뒤 슬롯에 남은 버퍼 반납 (감지 스레드도 더 이상 프레임을 쓰지 않아야 함)
+    slot_.forEach(releaseFrame);
+    {
+        std::lock_guard<std::mutex> lock(hiresMutex_);
+        if (hiresSample_) {
+            gst_sample_unref(hiresSample_);
+            hiresSample_ = nullptr;
+        }
+    }
+    if (detectSink_) {
+        gst_object_unref(detectSink_);
+        detectSink_ = nullptr;
+    }
+    if (hiresSink_) {
+        gst_object_unref(hiresSink_);
+        hiresSink_ = nullptr;
+    }
+    if (pipeline_) {
+        gst_object_unref(pipeline_);
+        pipeline_ = nullptr;
+    }
+}
+
+void CameraCapture::releaseFrame(CapturedFrame& frame) {
+    if (!frame.sample) return;
+    gst_video_frame_unmap(&frame.map);
+    gst_sample_unref(frame.sample);
+    frame.sample = nullptr;
+    frame.image = cv::Mat();
+}
+
+// GStreamer 스트리밍 스레드에서 호출 - 매핑만 하고 바로 게시 (복사 없음)
+GstFlowReturn CameraCapture::onNewSample(GstAppSink* sink, gpointer self) {
+    CameraCapture* cap = static_cast<CameraCapture*>(self);
+    const int64_t captureNs = steadyNowNs();
+
+    if (cap->streamingThread_ != std::this_thread::get_id()) {
+        cap->streamingThread_ = std::this_thread::get_id();
+        if (cap->cfg_.streamingThreadInit) cap->cfg_.streamingThreadInit();
+    }
+
+    GstSample* sample = gst_app_sink_pull_sample(sink);
+    if (!sample) return GST_FLOW_OK;
+
+    // 이전에 덮어쓴 프레임 / 감지 스레드가 다 쓴 프레임은 여기서 반납
+    CapturedFrame& frame = cap->slot_.writeBuffer();
+    releaseFrame(frame);
+
+    GstBuffer* buffer = gst_sample_get_buffer(sample);
+    GstVideoInfo info;
+    if (!buffer || !gst_video_info_from_caps(&info, gst_sample_get_caps(sample)) ||
+        !gst_video_frame_map(&frame.map, &info, buffer, GST_MAP_READ)) {
+        gst_sample_unref(sample);
+        cap->readFailures_.fetch_add(1, std::memory_order_relaxed);
+        return GST_FLOW_OK;
+    }
+
+    // 협상된 framerate가 있으면 그 주기로 PTS 간격을 판정
+    if (GST_VIDEO_INFO_FPS_N(&info) > 0 && GST_VIDEO_INFO_FPS_D(&info) > 0) {
+        cap->framePeriodNs_.store(1000000000LL * GST_VIDEO_INFO_FPS_D(&info) / GST_VIDEO_INFO_FPS_N(&info),
+                                  std::memory_order_relaxed);
+    }
+
+    frame.sample = sample;
+    frame.image = cv::Mat(GST_VIDEO_FRAME_HEIGHT(&frame.map), GST_VIDEO_FRAME_WIDTH(&frame.map), CV_8UC3,
+                          GST_VIDEO_FRAME_PLANE_DATA(&frame.map, 0),
+                          GST_VIDEO_FRAME_PLANE_STRIDE(&frame.map, 0));
+    frame.ptsNs = bufferPts(buffer);
+    frame.captureNs = captureNs;
+    cap->accountPts(frame.ptsNs);
+
+    cap->slot_.publish();
+    return GST_FLOW_OK;
+}
+
+void CameraCapture::onEos(GstAppSink*, gpointer self) {
+    CameraCapture* cap = static_cast<CameraCapture*>(self);
+    cap->eos_.store(true, std::memory_order_release);
+    cap->slot_.stop();
+}
+
+const CapturedFrame* CameraCapture::waitFrame(int timeoutMs) {
+    if (slot_.waitLatest(std::chrono::milliseconds(timeoutMs))) {
+        lastFrameNs_ = stallMarkNs_ = steadyNowNs();
+        return &slot_.readBuffer();
+    }
+
+    if (!finished() && !stopped_.load(std::memory_order_acquire)) {
+        const int64_t now = steadyNowNs();
+        if (now - stallMarkNs_ >= kStallNs) {
+            readFailures_.fetch_add(1, std::memory_order_relaxed);
+            stallMarkNs_ = now;
+        }
+    }
+    return nullptr;
+}
+
+int64_t CameraCapture::stalledNs() const {
+    return steadyNowNs() - lastFrameNs_;
+}
+
+void CameraCapture::stop() {
+    stopped_.store(true, std::memory_order_release);
+    slot_.stop();
+}
+
+void CameraCapture::accountPts(int64_t ptsNs) {
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    const int64_t prev = lastPtsNs_.exchange(ptsNs, std::memory_order_relaxed);
+    const int64_t period = framePeriodNs_.load(std::memory_order_relaxed);
+    if (ptsNs < 0 || prev < 0 || period <= 0 || ptsNs <= prev) return;
+
+    // 간격을 프레임 주기로 반올림 (타이밍 흔들림은 무시, 주기 1.5배 이상부터 손실로 셈)
+    const int64_t missing = (ptsNs - prev + period / 2) / period - 1;
+    if (missing > 0) {
+        droppedFrames_.fetch_add(static_cast<uint64_t>(missing), std::memory_order_relaxed);
+        gapEvents_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+CaptureCounters CameraCapture::counters() const {
+    CaptureCounters c;
+    c.frames = frames_.load(std::memory_order_relaxed);
+    c.droppedFrames = droppedFrames_.load(std::memory_order_relaxed);
+    c.gapEvents = gapEvents_.load(std::memory_order_relaxed);
+    c.slotSkipped = slot_.skippedFrames();
+    c.readFailures = readFailures_.load(std::memory_order_relaxed);
+    return c;
+}
+
+bool CameraCapture::grabHighRes(cv::Mat& dst, int64_t& ptsNs) {
+    if (!hiresSink_) return false;
+    std::lock_guard<std::mutex> lock(hiresMutex_);
+
+    // appsink에 대기 중인 최신 1장을 꺼냄 (없으면 직전 샘플 재사용)
+    GstSample* latest = gst_app_sink_try_pull_sample(GST_APP_SINK(hiresSink_), 0);
+    if (latest) {
+        if (hiresSample_) gst_sample_unref(hiresSample_);
+        hiresSample_ = latest;
+    }
+    if (!hiresSample_) return false;
+
+    GstBuffer* buffer = gst_sample_get_buffer(hiresSample_);
+    GstVideoInfo info;
+    GstVideoFrame frame;
+    if (!buffer || !gst_video_info_from_caps(&info, gst_sample_get_caps(hiresSample_)) ||
+        !gst_video_frame_map(&frame, &info, buffer, GST_MAP_READ)) {
+        return false;
+    }
+
+    const int w = GST_VIDEO_FRAME_WIDTH(&frame);
+    const int h = GST_VIDEO_FRAME_HEIGHT(&frame);
+    void* plane0 = GST_VIDEO_FRAME_PLANE_DATA(&frame, 0);
+    const size_t stride0 = GST_VIDEO_FRAME_PLANE_STRIDE(&frame, 0);
+
+    bool ok = true;
+    switch (GST_VIDEO_FRAME_FORMAT(&frame)) {
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21: {
+        hiresPacked_.create(h * 3 / 2, w, CV_8UC1);
+        uint8_t* p = packPlane(hiresPacked_.data, frame, 0, w, h);
+        packPlane(p, frame, 1, w, h / 2);
+        cv::cvtColor(hiresPacked_, dst, GST_VIDEO_FRAME_FORMAT(&frame) == GST_VIDEO_FORMAT_NV12
+                                            ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_NV21);
+        break;
+    }
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12: {
+        hiresPacked_.create(h * 3 / 2, w, CV_8UC1);
+        uint8_t* p = packPlane(hiresPacked_.data, frame, 0, w, h);
+        p = packPlane(p, frame, 1, w / 2, h / 2);
+        packPlane(p, frame, 2, w / 2, h / 2);
+        cv::cvtColor(hiresPacked_, dst, GST_VIDEO_FRAME_FORMAT(&frame) == GST_VIDEO_FORMAT_I420
+                                            ? cv::COLOR_YUV2BGR_I420 : cv::COLOR_YUV2BGR_YV12);
+        break;
+    }
+    case GST_VIDEO_FORMAT_YUY2:
+        cv::cvtColor(cv::Mat(h, w, CV_8UC2, plane0, stride0), dst, cv::COLOR_YUV2BGR_YUY2);
+        break;
+    case GST_VIDEO_FORMAT_BGR:
+        cv::Mat(h, w, CV_8UC3, plane0, stride0).copyTo(dst);
+        break;
+    case GST_VIDEO_FORMAT_BGRx:
+    case GST_VIDEO_FORMAT_BGRA:
+        cv::cvtColor(cv::Mat(h, w, CV_8UC4, plane0, stride0), dst, cv::COLOR_BGRA2BGR);
+        break;
+    case GST_VIDEO_FORMAT_RGB:
+        cv::cvtColor(cv::Mat(h, w, CV_8UC3, plane0, stride0), dst, cv::COLOR_RGB2BGR);
+        break;
+    default:
+        std::cerr << "[캡처] 지원하지 않는 고해상도 포맷: "
+                  << gst_video_format_to_string(GST_VIDEO_FRAME_FORMAT(&frame)) << std::endl;
+        ok = false;
+        break;
+    }
+    gst_video_frame_unmap(&frame);
+
+    ptsNs = bufferPts(buffer);
+    return ok;
+}
+
+void CameraCapture::reportErrors() {
+    if (!pipeline_) return;
+    GstBus* bus = gst_element_get_bus(pipeline_);
+    if (!bus) return;
+
+    while (GstMessage* msg = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR)) {
+        GError* err = nullptr;
+        gchar* debug = nullptr;
+        gst_message_parse_error(msg, &err, &debug);
+        std::cerr << "[캡처] " << GST_OBJECT_NAME(GST_MESSAGE_SRC(msg)) << ": "
+                  << (err ? err->message : "?");
+        if (debug) std::cerr << " (" << debug << ")";
+        std::cerr << std::endl;
+        g_clear_error(&err);
+        g_free(debug);
+        gst_message_unref(msg);
+    }
+    gst_object_unref(bus);
+}
@@ -0,0 +1,175 @@
+#ifndef CAMERA_CAPTURE_HPP
+#define CAMERA_CAPTURE_HPP
+
+#include <opencv2/core.hpp>
+#include <gst/gst.h>
+#include <gst/app/gstappsink.h>
+#include <gst/video/video.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "frame_slot.hpp"
+
+/*
+ * 카메라 캡처 설정
+ * - width/height/fps: 감지용 저해상도 스트림 (매 프레임 BGR로 받아 감지에 사용)
+ * - hiresWidth/hiresHeight: 증거 이미지용 고해상도 스트림 (0이면 사용 안 함)
+ * - streamingThreadInit: 감지 스트림 콜백을 부르는 GStreamer 스트리밍 스레드에서 처음 한 번 호출
+ *   (CPU 고정 / SCHED_FIFO 등 - 예전 캡처 스레드 설정에 해당)
+ */
+struct CaptureConfig {
+    int width = 320;
+    int height = 240;
+    int fps = 30;
+    int hiresWidth = 0;
+    int hiresHeight = 0;
+    std::function<void()> streamingThreadInit;
+};
+
+/*
+ * 감지 스트림 프레임 하나 (appsink 버퍼를 매핑한 채로 보관 - 복사 없음)
+ * - image: 매핑된 버퍼를 가리키는 BGR Mat 헤더 (행 stride 포함)
+ * - captureNs: new-sample 콜백 시각 (steady_clock 기준)
+ * - 다음 waitFrame() 호출 전까지 유효
+ */
+struct CapturedFrame {
+    cv::Mat image;
+    int64_t ptsNs = -1;
+    int64_t captureNs = 0;
+    GstSample* sample = nullptr;
+    GstVideoFrame map;           // sample이 있을 때만 유효
+};
+
+/*
+ * 감지 스트림 누적 카운터 (캡처 스레드가 갱신, 다른 스레드에서 조회)
+ * - frames: 읽은 프레임
+ * - droppedFrames: 연속 프레임의 PTS 간격이 프레임 주기의 정수배로 벌어진 만큼 빠진 프레임
+ *   (카메라/appsink drop=true 단계에서 버려져 감지 스레드가 볼 수 없었던 프레임)
+ * - gapEvents: 빠진 프레임이 한 장 이상 있었던 간격 수
+ * - slotSkipped: 감지 스레드가 가져가기 전에 더 새 프레임으로 덮어쓴 프레임
+ * - readFailures: 프레임 없이 1초가 지난 횟수 / 샘플 매핑 실패
+ */
+struct CaptureCounters {
+    uint64_t frames = 0;
+    uint64_t droppedFrames = 0;
+    uint64_t gapEvents = 0;
+    uint64_t slotSkipped = 0;
+    uint64_t readFailures = 0;
+};
+
+/*
+ * libcamerasrc → appsink 캡처 (GStreamer appsink API 직접 사용)
+ *
+ * 감지 스트림은 push 방식
+ * - appsink new-sample 콜백(GStreamer 스트리밍 스레드)에서 버퍼를 매핑한 채로 lock-free 슬롯에 게시
+ * - 감지 스레드는 waitFrame()으로 새 프레임이 게시되는 즉시 깨어나 항상 가장 최신 프레임을 받음
+ *   (따로 캡처 스레드가 read()에서 막혀 있다가 오래된 프레임을 넘기는 일이 없음)
+ * - 다 쓴 프레임과 덮어쓴 프레임의 버퍼 반납은 스트리밍 스레드가 다음 콜백에서 처리
+ *
+ * 고해상도 스트림을 켜면 같은 카메라에서 두 개의 출력을 받음
+ * - 감지 스트림: ISP가 저해상도로 줄여서 주므로 감지 비용은 그대로
+ * - 고해상도 스트림: 원본 포맷(NV12 등) 그대로 appsink에 최신 1장만 유지
+ *   (max-buffers=1 drop=true → 새 프레임이 오면 이전 버퍼는 버려짐)
+ *   grabHighRes()를 호출할 때만 버퍼를 꺼내 BGR로 변환하므로 평소에는 복사/변환 없음
+ *
+ * cv::VideoCapture는 appsink 하나만 다룰 수 있어서 직접 파이프라인을 구성함
+ */
+class CameraCapture {
+public:
+    CameraCapture() = default;
+    ~CameraCapture();
+
+    CameraCapture(const CameraCapture&) = delete;
+    CameraCapture& operator=(const CameraCapture&) = delete;
+
+    /*
+     * 파이프라인 생성 및 재생 시작
+     * - 실패 시 원인을 출력하고 false
+     */
+    bool open(const CaptureConfig& cfg);
+    void close();
+    bool isOpened() const { return pipeline_ != nullptr; }
+    bool hasHighRes() const { return hiresSink_ != nullptr; }
+
+    /*
+     * 감지 스레드: 새 프레임이 게시될 때까지 대기 후 최신 프레임 반환
+     * - 직전에 받은 프레임은 이 호출로 반납됨 (포인터는 다음 호출 전까지만 유효)
+     * - timeoutMs 안에 프레임이 없으면 nullptr
+     *   (프레임 없이 1초가 지날 때마다 읽기 실패 1회로 집계 - 예전 read() 타임아웃과 같은 기준)
+     * - 스트림이 끝났거나(EOS) stop() 이후에도 nullptr → finished()로 구분
+     */
+    const CapturedFrame* waitFrame(int timeoutMs = 100);
+
+    /*
+     * 대기 중인 waitFrame()을 깨우고 더 이상 기다리지 않게 함 (다시 시작할 수 없음)
+     */
+    void stop();
+    bool finished() const { return eos_.load(std::memory_order_acquire); }
+
+    /*
+     * 마지막 프레임(없으면 open) 이후 지난 시간 - 감지 스레드에서 조회
+     */
+    int64_t stalledNs() const;
+
+    /*
+     * 고해상도 최신 프레임을 BGR로 변환해서 dst에 기록 (감지 스레드가 아닌 곳에서 호출)
+     * - 새 프레임이 없으면 직전에 꺼낸 프레임을 다시 사용
+     * - ptsNs: 해당 고해상도 버퍼의 PTS
+     * - 고해상도 스트림이 꺼져 있거나 아직 프레임이 없으면 false
+     */
+    bool grabHighRes(cv::Mat& dst, int64_t& ptsNs);
+
+    /*
+     * 마지막으로 읽은 감지 스트림 프레임의 PTS (고해상도 프레임과의 시간 차 확인용)
+     */
+    int64_t lastPtsNs() const { return lastPtsNs_.load(std::memory_order_relaxed); }
+
+    /*
+     * 감지 스트림 누적 카운터 / 프레임 주기 (caps의 framerate, 없으면 설정값)
+     */
+    CaptureCounters counters() const;
+    int64_t framePeriodNs() const { return framePeriodNs_.load(std::memory_order_relaxed); }
+
+    /*
+     * 파이프라인 버스에 쌓인 오류 메시지를 출력 (읽기 실패 시 원인 확인용)
+     */
+    void reportErrors();
+
+    static std::string buildPipeline(const CaptureConfig& cfg);
+
+private:
+    static GstFlowReturn onNewSample(GstAppSink* sink, gpointer self);
+    static void onEos(GstAppSink* sink, gpointer self);
+    void accountPts(int64_t ptsNs);
+    static void releaseFrame(CapturedFrame& frame);
+
+    CaptureConfig cfg_;
+    GstElement* pipeline_ = nullptr;
+    GstElement* detectSink_ = nullptr;
+    GstElement* hiresSink_ = nullptr;
+
+    // 고해상도 마지막 샘플 (grabHighRes 사이에 유지) + 변환용 임시 버퍼
+    std::mutex hiresMutex_;
+    GstSample* hiresSample_ = nullptr;
+    cv::Mat hiresPacked_;
+
+    // 콜백 → 감지 스레드 (스트리밍 스레드가 바뀌면 초기화 함수를 다시 호출)
+    LatestFrameSlot<CapturedFrame> slot_;
+    std::thread::id streamingThread_;
+    std::atomic<bool> eos_{false};
+    std::atomic<bool> stopped_{false};
+    int64_t lastFrameNs_ = 0;      // 감지 스레드 전용 (마지막 프레임 수신 시각)
+    int64_t stallMarkNs_ = 0;      // 마지막으로 읽기 실패를 센 시각
+
+    std::atomic<int64_t> lastPtsNs_{-1};
+    std::atomic<int64_t> framePeriodNs_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> droppedFrames_{0};
+    std::atomic<uint64_t> gapEvents_{0};
+    std::atomic<uint64_t> readFailures_{0};
+};
+
+#endif
@@ -9,6 +9,8 @@
 #include <linux/kthread.h>
 #include <linux/sched.h> 
 
+#include "factory_cmd_abi.h"  // 바이너리 명령 ABI (../mqtt_bridge)
+
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("VEDACRAFT_NAM");
 MODULE_DESCRIPTION("Conveyor Control Driver");
@@ -154,16 +156,9 @@ static int servo_thread_func(void *data) {
     return 0;
 }
 
-static ssize_t conveyor_write(struct file *file, const char __user *buf, size_t len, loff_t *offset) {
-    if (len > BUF_LEN - 1)
-        return -EINVAL;
-
-    if (copy_from_user(command_buffer, buf, len))
-        return -EFAULT;
-
-    command_buffer[len] = '\0';
-
-    if (strncmp(command_buffer, "on", 2) == 0) {
+// 모드 변경 (텍스트 명령 on/off/error_mode와 FACTORY_IOC_MODE가 같이 사용)
+static int conveyor_set_mode(int mode) {
+    if (mode == FACTORY_MODE_ON) {
         auto_step_mode = true;
         step_counter = 0;
         current_panel = 0;
@@ -172,11 +167,11 @@ static ssize_t conveyor_write(struct file *file, const char __user *buf, size_t
         current_speed = 100;
         printk(KERN_INFO "컨베이어 시작 (첫 번째 판: 340 스텝)\n");
     }
-    else if (strncmp(command_buffer, "off", 3) == 0) {
+    else if (mode == FACTORY_MODE_OFF) {
         conveyor_running = false;
         auto_step_mode = false;
     }
-    else if (strncmp(command_buffer, "error_mode", 10) == 0) {
+    else if (mode == FACTORY_MODE_ERROR) {
         del_timer_sync(&speed_timer);
 
         auto_step_mode = true;
@@ -193,10 +188,65 @@ static ssize_t conveyor_write(struct file *file, const char __user *buf, size_t
         printk(KERN_INFO "에러 모드 시작 - 30초 후 속도 감소\n");
         mod_timer(&speed_timer, jiffies + msecs_to_jiffies(1000));
     }
+    else {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static ssize_t conveyor_write(struct file *file, const char __user *buf, size_t len, loff_t *offset) {
+    if (len > BUF_LEN - 1)
+        return -EINVAL;
+
+    if (copy_from_user(command_buffer, buf, len))
+        return -EFAULT;
+
+    command_buffer[len] = '\0';
+
+    if (strncmp(command_buffer, "on", 2) == 0)
+        conveyor_set_mode(FACTORY_MODE_ON);
+    else if (strncmp(command_buffer, "off", 3) == 0)
+        conveyor_set_mode(FACTORY_MODE_OFF);
+    else if (strncmp(command_buffer, "error_mode", 10) == 0)
+        conveyor_set_mode(FACTORY_MODE_ERROR);
 
     return len;
 }
 
+// 바이너리 명령 (factory_cmd_abi.h) - 모드 / 속도
+static long conveyor_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
+    struct factory_mode_cmd mode_cmd;
+    struct factory_speed_cmd speed_cmd;
+
+    switch (cmd) {
+    case FACTORY_IOC_VERSION:
+        return put_user((__u32)FACTORY_CMD_ABI_VERSION, (__u32 __user *)arg);
+
+    case FACTORY_IOC_MODE:
+        if (copy_from_user(&mode_cmd, (void __user *)arg, sizeof(mode_cmd)))
+            return -EFAULT;
+        if (mode_cmd.version != FACTORY_CMD_ABI_VERSION)
+            return -EPROTO;
+        return conveyor_set_mode(mode_cmd.mode);
+
+    case FACTORY_IOC_SPEED:
+        if (copy_from_user(&speed_cmd, (void __user *)arg, sizeof(speed_cmd)))
+            return -EFAULT;
+        if (speed_cmd.version != FACTORY_CMD_ABI_VERSION)
+            return -EPROTO;
+        // 스텝 간격 = 300000 / 속도 이므로 0은 받지 않음
+        if (speed_cmd.speed < 1 || speed_cmd.speed > 100)
+            return -EINVAL;
+        current_speed = speed_cmd.speed;
+        printk(KERN_INFO "컨베이어 속도 변경: %d\n", current_speed);
+        return 0;
+
+    default:
+        return -ENOTTY;
+    }
+}
+
 static ssize_t conveyor_read(struct file *file, char __user *buf, size_t len, loff_t *offset) {
     char status[512];
     int status_len;
@@ -237,6 +287,7 @@ static struct file_operations fops = {
     .owner = THIS_MODULE,
     .write = conveyor_write,
     .read = conveyor_read,
+    .unlocked_ioctl = conveyor_ioctl,
 };
 
 static int __init conveyor_init(void) {
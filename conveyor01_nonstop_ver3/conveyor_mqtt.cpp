@@ -4,6 +4,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QTimer>
+#include "qt_reconnect.hpp"
 
 int main(int argc, char *argv[]) {
     QCoreApplication app(argc, argv);
@@ -14,6 +15,7 @@ int main(int argc, char *argv[]) {
     mqtt_client.setPort(1883); 
     
     qDebug() << "MQTT 브로커 연결 시도 중... (mqtt.kwon.pics:1883)";
+    QtMqttReconnect reconnect(mqtt_client);   // 끊기면 빠른 첫 재시도 후 지수 증가 + 지터
     mqtt_client.connectToHost();
 
     // 연결 성공
@@ -25,6 +27,7 @@ int main(int argc, char *argv[]) {
         auto subscription = mqtt_client.subscribe(QMqttTopicFilter("conveyor_03/cmd"));
         if (subscription) {
             qDebug() << "conveyor_03/cmd 토픽 구독 요청 전송";
+            reconnect.trackSubscription(subscription);
             
             // 구독 성공 확인
             QObject::connect(subscription, &QMqttSubscription::stateChanged, [](QMqttSubscription::SubscriptionState state) {
@@ -103,7 +106,7 @@ int main(int argc, char *argv[]) {
         }
     });
 
-    // 연결 끊어짐
+    // 연결 끊어짐 (재연결은 QtMqttReconnect가 예약)
     QObject::connect(&mqtt_client, &QMqttClient::disconnected, [&](){
         qDebug() << "MQTT 브로커 연결 끊어짐";
     });
@@ -6,17 +6,28 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <iomanip>
 #include <chrono>
-#include <deque>
+#include <sstream>
+#include <cstring>
 #include <signal.h>
+#include <sys/stat.h>
+#include "rt_tuning.hpp"
+#include "camera_capture.hpp"
+#include "detect_engine.hpp"
+#include "telemetry_shm.hpp"
+#include "line_metrics.hpp"
+#include "frame_loss.hpp"
+#include "frame_record.hpp"
 
 // --- 전역 변수 선언 ---
+// ROI 상태는 프리뷰 스레드(마우스 콜백)와 감지 루프가 함께 접근하므로 g_roiMutex로 보호
+// (ROI가 완성되면 감지 루프가 g_points를 엔진에 넘김)
 std::vector<cv::Point> g_points;
-cv::Mat g_currentFrame;
 bool g_drawing = false;
-cv::Mat g_roiMask;
-bool g_roiSelected = false;
+std::atomic<bool> g_roiSelected(false);
+std::mutex g_roiMutex;
 
 // 성능 최적화를 위한 변수
 const int CAPTURE_WIDTH = 320;   
@@ -24,26 +35,105 @@ const int CAPTURE_HEIGHT = 240;
 const int CAPTURE_FPS = 30;      // 안정성을 위해 30FPS로 낮춤
 const int BLUR_SIZE = 5;         // 블러 크기도 약간 줄임
 
-// SAD 감지 관련
-cv::Mat g_prevFrame;
-cv::Mat g_baselineFrame;
-std::atomic<double> g_sadThreshold(50000.0);
-const int DEBOUNCE_FRAMES = 15;
-int g_framesSinceDetection = 0;
-bool g_isBottlePresent = false;
-
-// 통계 및 성능 측정
-double g_currentSAD = 0.0;
-std::deque<double> g_sadHistory;  // queue 대신 deque 사용
-const int HISTORY_SIZE = 30;
-double g_fps = 0.0;
+// SAD 감지 엔진 (그레이/블러/SAD/디바운스) - main에서 생성
+DetectionEngine* g_engine = nullptr;
+
+// 성능 측정
+std::atomic<double> g_fps(0.0);
 auto g_lastTime = std::chrono::high_resolution_clock::now();
 int g_frameCounter = 0;
 
 // 멀티스레딩
 std::atomic<bool> g_shouldExit(false);
-std::mutex g_thresholdMutex;
-cv::VideoCapture* g_cap = nullptr;  // 전역 포인터로 관리
+CameraCapture g_camera;  // 감지용 저해상도 + (선택) 고해상도 스트림 (콜백으로 최신 프레임 게시)
+const int64_t CAPTURE_STALL_LIMIT_NS = 10000000000LL;  // 프레임 없이 이만큼 지나면 종료
+RtConfig g_rtConfig;  // CPU 고정 / SCHED_FIFO / mlockall 옵션
+int g_detectThreads = 1;  // 감지 처리를 나눠 맡을 스레드 수 (감지 스레드 포함)
+DetectorConfig g_detectorConfig;  // 최소 유지 시간 / 해제 확정 시간 등 (명령행에서 조정)
+
+// 운영자 화면(프리뷰) 관련
+// - 감지 루프는 최신 상태만 넘기고, 리사이즈/오버레이/imshow는 프리뷰 스레드가 정해진 주기로 처리
+const int DISPLAY_WIDTH = 640;
+const int DISPLAY_HEIGHT = 480;
+int g_previewFps = 10;       // 프리뷰 갱신 주기 (사람 눈에는 10FPS면 충분)
+bool g_headless = false;     // 창 없이 실행 (--headless)
+
+struct PreviewState {
+    cv::Mat frame;           // 블러 처리된 최신 프레임 (프리뷰가 요청할 때만 복사)
+    uint64_t frameSeq = 0;
+    double sad = 0.0;
+    double threshold = 0.0;
+    double fps = 0.0;
+    bool bottlePresent = false;
+    bool detecting = false;  // 초기 프레임 설정 후 감지 중인지
+};
+std::mutex g_previewMutex;
+PreviewState g_previewState;
+std::atomic<bool> g_previewWantsFrame(true);  // 프리뷰가 지난 프레임을 가져갔으면 true
+
+// 공유 메모리 텔레메트리 (감지 스레드에서만 갱신, 다른 프로세스는 detect_telemetry 등으로 읽음)
+bool g_telemetryEnabled = true;
+std::string g_telemetryName = telemetry::kDefaultShmName;
+const int TELEMETRY_PERIOD_MS = 100;  // 이벤트가 없을 때 갱신 주기
+telemetry::TelemetryWriter g_telemetryWriter;
+telemetry::TelemetryData g_telemetryData = {};
+telemetry::LatencySampler g_stageLatency[telemetry::STAGE_COUNT];
+
+// 고해상도 증거 이미지
+// - 감지 루프는 Enter 이벤트 때 요청만 남기고, 변환/저장은 스냅샷 스레드가 처리
+// - 고해상도 프레임은 카메라 쪽에 최신 1장만 유지되다가 요청이 올 때만 BGR로 변환
+int g_hiresWidth = 0;        // 0이면 고해상도 스트림 사용 안 함 (--hires WxH)
+int g_hiresHeight = 0;
+std::string g_snapshotDir = "snapshots";
+
+struct SnapshotRequest {
+    bool pending = false;
+    uint64_t frameIndex = 0;
+    int64_t wallMs = 0;
+};
+std::mutex g_snapshotMutex;
+std::condition_variable g_snapshotCv;
+SnapshotRequest g_snapshotRequest;
+
+// 프레임 손실 집계 (카메라 PTS 간격 / 슬롯 덮어쓰기 / 지연 / 읽기 실패)
+// - 누적 값은 각 단계에서 세고, 감지 스레드가 매 프레임 모아서 최근 1분 비율로 변환
+// - 손실 비율이 높으면 병을 놓쳤을 수 있으므로 주기적으로 경고
+FrameLossMonitor g_frameLoss;
+uint64_t g_lateFrames = 0;             // 감지 스레드 전용
+const double LOSS_WARN_RATIO = 0.01;   // 최근 1분 손실 1% 이상이면 경고
+const int LOSS_WARN_PERIOD_SEC = 10;
+
+// 원본 프레임 녹화 / 재생 (.frec - frame_record.hpp)
+// - 녹화: 감지가 끝난 프레임을 녹화 청크에 복사 (파일 쓰기는 녹화 기록 스레드)
+//   병 감지/통과 이벤트와 운영자 표시('m')는 마커로 함께 기록
+// - 재생: 카메라 대신 녹화 파일을 mmap해서 기록된 시각 간격대로(또는 최대 속도로) 감지 루프에 넣음
+std::string g_recordPath;
+record::FrameRecordWriter g_recorder;   // 감지 스레드 전용
+std::atomic<bool> g_markRequested(false);
+
+std::string g_replayPath;
+record::FrameRecordReader g_replay;
+double g_replaySpeed = 1.0;      // 재생 배속 (0이면 기다리지 않고 최대 속도)
+int g_replayMarker = -1;         // >= 0이면 해당 마커 REPLAY_PREROLL_NS 전부터 재생
+const int64_t REPLAY_PREROLL_NS = 2000000000LL;  // 기준 프레임을 잡을 여유
+size_t g_replayPos = 0;
+int64_t g_replayBaseNs = 0;      // 재생 시작 시각 (steady_clock)
+int64_t g_replayFirstNs = 0;     // 재생 시작 프레임의 녹화 시각
+
+// 감지 루프 입력 프레임
+// - captureNs: 엔진 시간축 (재생이면 녹화 시각 간격을 그대로 유지한 채 재생 시작 시각으로 옮긴 값)
+// - arrivalNs: 프레임이 감지 스레드에 넘어온 시각 (지연 시간 측정 기준)
+struct InputFrame {
+    cv::Mat image;
+    int64_t captureNs = 0;
+    int64_t arrivalNs = 0;
+    int64_t ptsNs = -1;
+};
+enum class FrameWait { Ready, Timeout, End };
+
+// 라인 처리량 지표 (병 수 / 분당 처리량 / 간격 / 체류 시간) - main에서 생성
+LineMetricsConfig g_lineMetricsConfig;
+LineMetrics* g_lineMetrics = nullptr;
 
 // 시그널 핸들러
 void signalHandler(int signum) {
@@ -53,20 +143,31 @@ void signalHandler(int signum) {
 
 // --- 함수 선언 ---
 void onMouse(int event, int x, int y, int flags, void* userdata);
-void pushBottle();
+void pushBottle(const DetectionEvent& event);
 void inputHandler();
-void captureBaseline();
-double calculateFastSAD(const cv::Mat& current, const cv::Mat& previous, const cv::Mat& mask);
+void previewHandler();
 void updateFPS();
+void publishPreview(const FrameResult& result);
+void recordTelemetryEvent(const DetectionEvent& event);
+void publishTelemetry(const FrameResult& result);
+void printLineMetrics();
+FrameLossCounters collectFrameLoss();
+void checkFrameLoss(int64_t nowNs);
+void printFrameLoss();
+void requestSnapshot(const DetectionEvent& event, int64_t wallMs);
+void snapshotHandler();
+FrameWait nextFrame(InputFrame& in);
+bool openReplay();
 
-// --- 마우스 콜백 함수 ---
+// --- 마우스 콜백 함수 (프리뷰 스레드에서 호출됨) ---
 void onMouse(int event, int x, int y, int flags, void* userdata) {
     if (g_roiSelected) return;
 
     // 디스플레이 좌표를 캡처 좌표로 변환
-    x = x * CAPTURE_WIDTH / 640;
-    y = y * CAPTURE_HEIGHT / 480;
+    x = x * CAPTURE_WIDTH / DISPLAY_WIDTH;
+    y = y * CAPTURE_HEIGHT / DISPLAY_HEIGHT;
 
+    std::lock_guard<std::mutex> lock(g_roiMutex);
     if (event == cv::EVENT_LBUTTONDOWN) {
         g_points.push_back(cv::Point(x, y));
         g_drawing = true;
@@ -76,11 +177,6 @@ void onMouse(int event, int x, int y, int flags, void* userdata) {
             g_drawing = false;
             g_roiSelected = true;
 
-            g_roiMask = cv::Mat::zeros(cv::Size(CAPTURE_WIDTH, CAPTURE_HEIGHT), CV_8UC1);
-            const cv::Point* pts[1] = { g_points.data() };
-            int npts[] = { (int)g_points.size() };
-            cv::fillPoly(g_roiMask, pts, npts, 1, cv::Scalar(255));
-
             std::cout << "\n=== ROI 선택 완료 ===" << std::endl;
             std::cout << "기준 프레임 캡처: 'b'" << std::endl;
             std::cout << "임계값 조절: 숫자 입력 또는 [/] (10%씩 감소/증가)" << std::endl;
@@ -92,13 +188,73 @@ void onMouse(int event, int x, int y, int flags, void* userdata) {
 }
 
 // --- 병 감지 액션 ---
-void pushBottle() {
+void pushBottle(const DetectionEvent& event) {
     auto now = std::chrono::high_resolution_clock::now();
     auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
     
     std::cout << "\n[" << timestamp << "] *** 병 감지! ***" << std::endl;
-    std::cout << "SAD: " << std::fixed << std::setprecision(2) << g_currentSAD 
-              << " (임계값: " << g_sadThreshold << ")" << std::endl;
+    std::cout << "SAD: " << std::fixed << std::setprecision(2) << event.sad 
+              << " (임계값: " << event.threshold << ")";
+    if (event.durationNs >= 0) {
+        std::cout << " | 이전 병과 간격: " << event.durationNs / 1000000 << "ms";
+    }
+    std::cout << std::endl;
+
+    if (g_camera.hasHighRes()) {
+        requestSnapshot(event, timestamp);
+    }
+}
+
+// --- 고해상도 스냅샷 요청 (감지 스레드) ---
+// 아직 처리되지 않은 요청이 있으면 최신 이벤트로 덮어씀 (감지 루프는 기다리지 않음)
+void requestSnapshot(const DetectionEvent& event, int64_t wallMs) {
+    {
+        std::lock_guard<std::mutex> lock(g_snapshotMutex);
+        g_snapshotRequest.pending = true;
+        g_snapshotRequest.frameIndex = event.frameIndex;
+        g_snapshotRequest.wallMs = wallMs;
+    }
+    g_snapshotCv.notify_one();
+}
+
+// --- 스냅샷 스레드 ---
+// 카메라에 보관된 최신 고해상도 프레임을 꺼내 BGR로 변환 후 JPEG로 저장
+void snapshotHandler() {
+    cv::Mat image;
+    while (true) {
+        SnapshotRequest request;
+        {
+            std::unique_lock<std::mutex> lock(g_snapshotMutex);
+            g_snapshotCv.wait(lock, [] { return g_snapshotRequest.pending || g_shouldExit; });
+            if (g_shouldExit) break;
+            request = g_snapshotRequest;
+            g_snapshotRequest.pending = false;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        int64_t hiresPts = -1;
+        if (!g_camera.grabHighRes(image, hiresPts)) {
+            std::cerr << "[스냅샷] 고해상도 프레임을 가져오지 못했습니다." << std::endl;
+            continue;
+        }
+        auto converted = std::chrono::steady_clock::now();
+
+        std::string path = g_snapshotDir + "/bottle_" + std::to_string(request.wallMs) +
+                           "_f" + std::to_string(request.frameIndex) + ".jpg";
+        if (!cv::imwrite(path, image)) {
+            std::cerr << "[스냅샷] 저장 실패: " << path << std::endl;
+            continue;
+        }
+
+        std::cout << "[스냅샷] " << path << " (" << image.cols << "x" << image.rows
+                  << ", 변환 " << std::chrono::duration_cast<std::chrono::milliseconds>(converted - start).count() << "ms";
+        const int64_t lowPts = g_camera.lastPtsNs();
+        if (hiresPts >= 0 && lowPts >= 0) {
+            std::cout << ", 감지 프레임 대비 " << std::showpos << (hiresPts - lowPts) / 1000000
+                      << std::noshowpos << "ms";
+        }
+        std::cout << ")" << std::endl;
+    }
 }
 
 // --- 터미널 입력 처리 ---
@@ -113,41 +269,44 @@ void inputHandler() {
             // 숫자 입력 시 임계값 직접 설정
             double newThreshold = std::stod(input);
             if (newThreshold > 0) {
-                std::lock_guard<std::mutex> lock(g_thresholdMutex);
-                g_sadThreshold = newThreshold;
+                g_engine->setThreshold(newThreshold);
                 std::cout << "임계값 설정: " << newThreshold << std::endl;
             }
         } catch (std::invalid_argument&) {
             // 명령어 처리
             if (input == "]") {  // 증가
-                g_sadThreshold = g_sadThreshold * 1.1;
-                std::cout << "임계값 증가: " << g_sadThreshold << std::endl;
+                g_engine->setThreshold(g_engine->threshold() * 1.1);
+                std::cout << "임계값 증가: " << g_engine->threshold() << std::endl;
             } else if (input == "[") {  // 감소
-                g_sadThreshold = g_sadThreshold * 0.9;
-                std::cout << "임계값 감소: " << g_sadThreshold << std::endl;
+                g_engine->setThreshold(g_engine->threshold() * 0.9);
+                std::cout << "임계값 감소: " << g_engine->threshold() << std::endl;
             } else if (input == "s") {
                 // 통계 정보
-                double avg = 0.0;
-                if (!g_sadHistory.empty()) {
-                    for (auto val : g_sadHistory) {
-                        avg += val;
-                    }
-                    avg /= g_sadHistory.size();
-                }
-                
                 std::cout << "\n=== 성능 및 통계 ===" << std::endl;
-                std::cout << "FPS: " << std::fixed << std::setprecision(1) << g_fps << std::endl;
-                std::cout << "현재 SAD: " << g_currentSAD << std::endl;
-                std::cout << "평균 SAD (최근 " << g_sadHistory.size() << "프레임): " << avg << std::endl;
-                std::cout << "임계값: " << g_sadThreshold << std::endl;
-                std::cout << "병 감지 상태: " << (g_isBottlePresent ? "YES" : "NO") << std::endl;
+                std::cout << "FPS: " << std::fixed << std::setprecision(1) << g_fps.load() << std::endl;
+                std::cout << "현재 SAD: " << g_engine->currentSad() << std::endl;
+                std::cout << "평균 SAD (최근 " << g_engine->historyCount() << "프레임): " << g_engine->averageSad() << std::endl;
+                std::cout << "임계값: " << g_engine->threshold() << std::endl;
+                std::cout << "병 감지 상태: " << (g_engine->bottlePresent() ? "YES" : "NO") << std::endl;
+                if (g_detectorConfig.illuminationCompensation) {
+                    std::cout << "조명 보정: gain " << std::setprecision(3) << g_engine->illuminationGain()
+                              << ", offset " << std::setprecision(1) << g_engine->illuminationOffset() << std::endl;
+                }
+                printFrameLoss();
+                printLineMetrics();
                 std::cout << "===================\n" << std::endl;
+            } else if (input == "b" && g_roiSelected) {
+                g_engine->requestBaseline();
+                std::cout << "기준 프레임 캡처 요청 (다음 프레임을 기준으로 설정)" << std::endl;
             } else if (input == "a" && g_roiSelected) {
                 // 자동 임계값 설정
-                if (g_currentSAD > 0) {
-                    g_sadThreshold = g_currentSAD * 1.5;
-                    std::cout << "자동 임계값 설정: " << g_sadThreshold << " (현재 SAD의 150%)" << std::endl;
+                double sad = g_engine->currentSad();
+                if (sad > 0) {
+                    g_engine->setThreshold(sad * 1.5);
+                    std::cout << "자동 임계값 설정: " << g_engine->threshold() << " (현재 SAD의 150%)" << std::endl;
                 }
+            } else if (input == "m" && g_recorder.isOpen()) {
+                g_markRequested = true;
             } else if (input == "q") {
                 g_shouldExit = true;
                 break;
@@ -156,35 +315,6 @@ void inputHandler() {
     }
 }
 
-// --- 기준 프레임 캡처 ---
-void captureBaseline() {
-    if (!g_currentFrame.empty() && !g_roiMask.empty()) {
-        g_baselineFrame = g_currentFrame.clone();
-        std::cout << "기준 프레임 캡처 완료 (현재 상태를 기준으로 설정)" << std::endl;
-    }
-}
-
-// --- 최적화된 SAD 계산 ---
-double calculateFastSAD(const cv::Mat& current, const cv::Mat& previous, const cv::Mat& mask) {
-    if (current.empty() || previous.empty() || mask.empty()) {
-        return 0.0;
-    }
-    
-    if (current.size() != previous.size() || current.size() != mask.size()) {
-        return 0.0;
-    }
-    
-    cv::Mat diff;
-    cv::absdiff(current, previous, diff);
-    
-    // 마스크 적용
-    cv::Mat maskedDiff;
-    cv::bitwise_and(diff, mask, maskedDiff);
-    
-    // 빠른 합산
-    return cv::sum(maskedDiff)[0];
-}
-
 // --- FPS 업데이트 ---
 void updateFPS() {
     g_frameCounter++;
@@ -198,8 +328,533 @@ void updateFPS() {
     }
 }
 
+// --- 프리뷰 상태 전달 (감지 루프 → 프리뷰 스레드) ---
+// 엔진의 블러 버퍼는 매 프레임 재사용되므로, 프리뷰가 이전 프레임을 가져간 경우에만 복사
+// (30FPS 감지 / 10FPS 프리뷰면 세 프레임 중 한 번만 복사)
+void publishPreview(const FrameResult& result) {
+    if (g_headless) return;
+
+    std::lock_guard<std::mutex> lock(g_previewMutex);
+    if (g_previewWantsFrame.exchange(false)) {
+        g_previewState.frame = g_engine->blurredFrame().clone();
+        g_previewState.frameSeq++;
+    }
+    g_previewState.sad = result.sad;
+    g_previewState.threshold = g_engine->threshold();
+    g_previewState.fps = g_fps;
+    g_previewState.bottlePresent = result.bottlePresent;
+    g_previewState.detecting = result.detecting;
+}
+
+// --- 텔레메트리 ---
+void recordTelemetryEvent(const DetectionEvent& event) {
+    auto& d = g_telemetryData;
+    auto& rec = d.events[d.eventCount % telemetry::kMaxEvents];
+    rec.type = event.type == DetectionEventType::Enter ? telemetry::EVENT_ENTER : telemetry::EVENT_EXIT;
+    rec.roiId = event.roiId;
+    rec.frameIndex = event.frameIndex;
+    rec.timestampNs = event.timestampNs;
+    rec.durationNs = event.durationNs;
+    rec.sad = event.sad;
+    rec.threshold = event.threshold;
+    d.eventCount++;
+}
+
+// 백분위 계산과 공유 메모리 복사는 여기서만 (주기 또는 이벤트 발생 시)
+void publishTelemetry(const FrameResult& result) {
+    auto& d = g_telemetryData;
+    d.updatedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    d.frameCount = g_engine->frameCount();
+    d.fps = g_fps;
+    d.currentSad = result.sad;
+    d.averageSad = g_engine->averageSad();
+    d.threshold = g_engine->threshold();
+    d.illumGain = result.illumGain;
+    d.illumOffset = result.illumOffset;
+    d.bottlePresent = result.bottlePresent;
+    d.detecting = result.detecting;
+    for (uint32_t s = 0; s < telemetry::STAGE_COUNT; s++) {
+        d.stages[s] = g_stageLatency[s].summarize();
+    }
+    d.rejectedFrames = g_engine->rejectedFrames();
+    d.frameLoss = g_frameLoss.total();
+    d.frameLossRates = g_frameLoss.rates();
+
+    const int64_t nowNs = LineMetrics::steadyNowNs();
+    const int64_t wallSec = LineMetrics::wallNowSec();
+    d.roiCount = std::min(g_lineMetrics->roiCount(), telemetry::kMaxRois);
+    for (uint32_t r = 0; r < d.roiCount; r++) {
+        d.roiMetrics[r] = g_lineMetrics->snapshot(r, nowNs, wallSec);
+    }
+    g_telemetryWriter.publish(d);
+}
+
+// --- 프레임 손실 집계 (감지 스레드) ---
+FrameLossCounters collectFrameLoss() {
+    CaptureCounters cap = g_camera.counters();
+    FrameLossCounters c;
+    c.captured = g_replay.isOpen() ? g_replayPos : cap.frames;
+    c.sourceDropped = cap.droppedFrames;
+    c.slotSkipped = cap.slotSkipped;
+    c.late = g_lateFrames;
+    c.readFailures = cap.readFailures;
+    return c;
+}
+
+// 최근 1분 손실 비율이 기준을 넘으면 경고 (LOSS_WARN_PERIOD_SEC마다 한 번)
+void checkFrameLoss(int64_t nowNs) {
+    static int64_t lastCheckNs = 0;
+    if (nowNs - lastCheckNs < LOSS_WARN_PERIOD_SEC * 1000000000LL) return;
+    lastCheckNs = nowNs;
+
+    FrameLossRates r = g_frameLoss.rates();
+    if (r.lossRatio >= LOSS_WARN_RATIO) {
+        std::cout << std::fixed << std::setprecision(1)
+                  << "[경고] 최근 " << r.windowSec << "초 프레임 손실 " << r.lossRatio * 100.0
+                  << "% (카메라 " << r.sourceDropRatio * 100.0 << "%, 감지 지연으로 건너뜀 "
+                  << r.slotSkipRatio * 100.0 << "%) - 병을 놓쳤을 수 있습니다." << std::endl;
+    }
+}
+
+// --- 프레임 손실 출력 ('s' 명령) ---
+void printFrameLoss() {
+    FrameLossCounters c = g_frameLoss.total();
+    FrameLossRates r = g_frameLoss.rates();
+
+    std::cout << "--- 프레임 손실 ---" << std::endl;
+    std::cout << "누적: 캡처 " << c.captured << " | 카메라 손실 " << c.sourceDropped
+              << " | 슬롯 덮어씀 " << c.slotSkipped << " | 지연 " << c.late
+              << " | 읽기 실패 " << c.readFailures << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "최근 " << std::setprecision(0) << r.windowSec << "초: " << std::setprecision(2)
+              << "손실 " << r.lossRatio * 100.0 << "% (카메라 " << r.sourceDropRatio * 100.0
+              << "%, 슬롯 " << r.slotSkipRatio * 100.0 << "%) | 지연 " << r.lateRatio * 100.0
+              << "% | 읽기 실패 " << std::setprecision(1) << r.readFailuresPerMin << "/분" << std::endl;
+}
+
+// --- 라인 처리량 출력 ('s' 명령) ---
+void printLineMetrics() {
+    const int64_t nowNs = LineMetrics::steadyNowNs();
+    const int64_t wallSec = LineMetrics::wallNowSec();
+
+    for (int r = 0; r < g_lineMetrics->roiCount(); r++) {
+        LineMetricsSnapshot m = g_lineMetrics->snapshot(r, nowNs, wallSec);
+        time_t shiftStart = static_cast<time_t>(m.shiftStartSec);
+        struct tm local;
+        localtime_r(&shiftStart, &local);
+
+        std::cout << "--- 라인 처리량 (ROI " << r << ") ---" << std::endl;
+        std::cout << "병 수: 누적 " << m.totalCount << " | 이번 교대(" << std::put_time(&local, "%H:%M")
+                  << "~) " << m.shiftCount << std::endl;
+        std::cout << std::setprecision(1) << "분당 병 수: 최근 1분 " << m.perMinute1m
+                  << " | 최근 15분 " << m.perMinute15m << " | 교대 평균 " << m.perMinuteShift << std::endl;
+        std::cout << "불량(체류 시간 이상): " << m.shiftRejects << " (" << m.rejectRatioShift * 100.0 << "%)" << std::endl;
+        std::cout << std::setprecision(0) << "도착 간격: 평균 " << m.gapMeanMs << "ms, 표준편차 " << m.gapStdMs
+                  << "ms, 최소 " << m.gapMinMs << "ms, 최대 " << m.gapMaxMs << "ms" << std::endl;
+        std::cout << "  분포:";
+        for (int i = 0; i < kGapBins; i++) {
+            std::cout << " " << (i < kGapBins - 1 ? "<" + std::to_string(kGapBinUpperMs[i]) : "그 이상")
+                      << ":" << m.gapHist[i];
+        }
+        std::cout << std::endl;
+        std::cout << "체류 시간: 평균 " << m.dwellMeanMs << "ms, 표준편차 " << m.dwellStdMs
+                  << "ms, 최소 " << m.dwellMinMs << "ms, 최대 " << m.dwellMaxMs << "ms" << std::endl;
+        std::cout << "  분포:";
+        for (int i = 0; i < kDwellBins; i++) {
+            std::cout << " " << (i < kDwellBins - 1 ? "<" + std::to_string(kDwellBinUpperMs[i]) : "그 이상")
+                      << ":" << m.dwellHist[i];
+        }
+        std::cout << std::endl;
+    }
+}
+
+// --- 오버레이 레이어 그리기 ---
+// 오버레이는 값이 바뀔 때만 다시 그리고, 매 프리뷰 프레임에는 cv::max로 합성만 함
+struct OverlayKey {
+    long long sad = -1;
+    long long threshold = -1;
+    int fpsTenths = -1;
+    bool present = false;
+    bool detecting = false;
+    bool roiSelected = false;
+    size_t pointCount = 0;
+
+    bool operator==(const OverlayKey& o) const {
+        return sad == o.sad && threshold == o.threshold && fpsTenths == o.fpsTenths &&
+               present == o.present && detecting == o.detecting &&
+               roiSelected == o.roiSelected && pointCount == o.pointCount;
+    }
+    bool operator!=(const OverlayKey& o) const { return !(*this == o); }
+};
+
+void drawOverlay(cv::Mat& overlay, const PreviewState& state, const std::vector<cv::Point>& points,
+                 bool roiSelected) {
+    overlay.setTo(cv::Scalar(0));
+
+    // 캡처 좌표 → 디스플레이 좌표
+    std::vector<cv::Point> displayPoints;
+    displayPoints.reserve(points.size());
+    for (const auto& pt : points) {
+        displayPoints.push_back(cv::Point(pt.x * DISPLAY_WIDTH / CAPTURE_WIDTH,
+                                          pt.y * DISPLAY_HEIGHT / CAPTURE_HEIGHT));
+    }
+
+    if (!roiSelected) {
+        // ROI 선택 모드
+        for (size_t i = 0; i + 1 < displayPoints.size(); ++i) {
+            cv::line(overlay, displayPoints[i], displayPoints[i+1], cv::Scalar(255), 2);
+        }
+        cv::putText(overlay, "Click points, right-click to close ROI",
+                   cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255), 2);
+        return;
+    }
+
+    // 감지 모드 - ROI 영역 표시
+    if (displayPoints.size() > 1) {
+        const cv::Point* pts[1] = { displayPoints.data() };
+        int npts[] = { (int)displayPoints.size() };
+        cv::polylines(overlay, pts, npts, 1, true, cv::Scalar(255), 2);
+    }
+
+    if (!state.detecting) return;
+
+    // 정보 표시
+    std::stringstream ss;
+    ss << "FPS: " << std::fixed << std::setprecision(1) << state.fps
+       << " | SAD: " << std::setprecision(0) << state.sad
+       << " / " << state.threshold;
+    cv::putText(overlay, ss.str(), cv::Point(10, 30),
+               cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255), 2);
+
+    // '[' ']' 키 안내
+    cv::putText(overlay, "[ ] : adjust threshold", cv::Point(10, 460),
+               cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(200), 1);
+
+    // SAD 레벨 바
+    int barWidth = state.threshold > 0 ? static_cast<int>((state.sad / state.threshold) * 200) : 0;
+    barWidth = std::min(barWidth, 200);
+    cv::rectangle(overlay, cv::Point(10, 45),
+                cv::Point(10 + barWidth, 55), cv::Scalar(200), cv::FILLED);
+    cv::rectangle(overlay, cv::Point(10, 45),
+                cv::Point(210, 55), cv::Scalar(255), 1);
+
+    if (state.bottlePresent) {
+        cv::putText(overlay, "DETECTED!", cv::Point(10, 85),
+                   cv::FONT_HERSHEY_SIMPLEX, 1.2, cv::Scalar(255), 3);
+        cv::rectangle(overlay, cv::Point(5, 5),
+                    cv::Point(DISPLAY_WIDTH - 5, DISPLAY_HEIGHT - 5), cv::Scalar(255), 5);
+    }
+}
+
+// --- 프리뷰 스레드 ---
+// HighGUI 호출(창 생성, 마우스 콜백, imshow, waitKey)은 모두 이 스레드에서만 수행
+void previewHandler() {
+    cv::namedWindow("Camera Feed", cv::WINDOW_AUTOSIZE);
+    cv::setMouseCallback("Camera Feed", onMouse, NULL);
+
+    const auto period = std::chrono::microseconds(1000000 / std::max(g_previewFps, 1));
+    auto nextTick = std::chrono::steady_clock::now();
+
+    cv::Mat overlay = cv::Mat::zeros(cv::Size(DISPLAY_WIDTH, DISPLAY_HEIGHT), CV_8UC1);
+    cv::Mat displayFrame;
+    PreviewState state;
+    OverlayKey lastKey;
+    uint64_t lastFrameSeq = 0;
+    std::vector<cv::Point> points;
+
+    while (!g_shouldExit) {
+        // 최신 상태 가져오기 (프레임은 얕은 복사) 후 다음 프레임 요청
+        {
+            std::lock_guard<std::mutex> lock(g_previewMutex);
+            state = g_previewState;
+        }
+        g_previewWantsFrame = true;
+        bool roiSelected = g_roiSelected;
+        {
+            std::lock_guard<std::mutex> lock(g_roiMutex);
+            if (points.size() != g_points.size()) points = g_points;
+        }
+
+        OverlayKey key;
+        key.sad = static_cast<long long>(state.sad);
+        key.threshold = static_cast<long long>(state.threshold);
+        key.fpsTenths = static_cast<int>(state.fps * 10);
+        key.present = state.bottlePresent;
+        key.detecting = state.detecting;
+        key.roiSelected = roiSelected;
+        key.pointCount = points.size();
+
+        bool overlayChanged = (key != lastKey);
+        if (overlayChanged) {
+            drawOverlay(overlay, state, points, roiSelected);
+            lastKey = key;
+        }
+
+        // 새 프레임이나 오버레이 변경이 있을 때만 화면 갱신
+        if (!state.frame.empty() && (state.frameSeq != lastFrameSeq || overlayChanged)) {
+            cv::resize(state.frame, displayFrame, cv::Size(DISPLAY_WIDTH, DISPLAY_HEIGHT), 0, 0, cv::INTER_LINEAR);
+            cv::max(displayFrame, overlay, displayFrame);
+            cv::imshow("Camera Feed", displayFrame);
+            lastFrameSeq = state.frameSeq;
+        }
+
+        // 다음 주기까지 GUI 이벤트 처리하며 대기
+        nextTick += period;
+        auto now = std::chrono::steady_clock::now();
+        if (nextTick < now) nextTick = now;
+        int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count());
+        char c = cv::waitKey(std::max(waitMs, 1)) & 0xFF;
+
+        if (c == 'q' || c == 27) {
+            g_shouldExit = true;
+        } else if (c == 'b' && g_roiSelected) {
+            g_engine->requestBaseline();
+            std::cout << "기준 프레임 캡처 요청 (다음 프레임을 기준으로 설정)" << std::endl;
+        } else if (c == '[') {
+            g_engine->setThreshold(g_engine->threshold() * 0.9);
+            std::cout << "임계값 감소: " << g_engine->threshold() << std::endl;
+        } else if (c == ']') {
+            g_engine->setThreshold(g_engine->threshold() * 1.1);
+            std::cout << "임계값 증가: " << g_engine->threshold() << std::endl;
+        } else if (c == 'm' && g_recorder.isOpen()) {
+            g_markRequested = true;
+        }
+    }
+
+    cv::destroyAllWindows();
+}
+
+// --- 감지 루프 입력 (카메라 / 녹화 재생) ---
+FrameWait nextFrame(InputFrame& in) {
+    if (!g_replay.isOpen()) {
+        // 새 프레임이 게시되면 바로 깨어남 (직전 프레임 버퍼는 여기서 반납)
+        const CapturedFrame* frame = g_camera.waitFrame(100);
+        if (!frame) return g_camera.finished() ? FrameWait::End : FrameWait::Timeout;
+        in.image = frame->image;
+        in.captureNs = in.arrivalNs = frame->captureNs;
+        in.ptsNs = frame->ptsNs;
+        return FrameWait::Ready;
+    }
+
+    if (g_replayPos >= g_replay.frameCount()) return FrameWait::End;
+    const int64_t offsetNs = g_replay.timestampNs(g_replayPos) - g_replayFirstNs;
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // 기록된 간격대로 재생 (종료 요청을 놓치지 않도록 최대 100ms씩 대기)
+    if (g_replaySpeed > 0) {
+        const int64_t dueNs = g_replayBaseNs + static_cast<int64_t>(offsetNs / g_replaySpeed);
+        if (dueNs > now) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<int64_t>(dueNs - now, 100000000LL)));
+            now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (dueNs > now) return FrameWait::Timeout;
+        }
+    }
+
+    in.image = g_replay.frame(g_replayPos);
+    in.captureNs = g_replayBaseNs + offsetNs;
+    in.arrivalNs = now;
+    in.ptsNs = g_replay.ptsNs(g_replayPos);
+    g_replayPos++;
+    return FrameWait::Ready;
+}
+
+// 녹화 파일 열기 + 시작 위치 (마커 지정 시 그 앞 REPLAY_PREROLL_NS부터)
+bool openReplay() {
+    if (!g_replay.open(g_replayPath)) return false;
+    if (g_replay.width() != CAPTURE_WIDTH || g_replay.height() != CAPTURE_HEIGHT) {
+        std::cerr << "오류: 녹화 해상도 " << g_replay.width() << "x" << g_replay.height()
+                  << "는 감지 해상도 " << CAPTURE_WIDTH << "x" << CAPTURE_HEIGHT << "와 달라 재생할 수 없습니다." << std::endl;
+        return false;
+    }
+    if (g_replay.frameCount() == 0) {
+        std::cerr << "오류: 녹화된 프레임이 없습니다: " << g_replayPath << std::endl;
+        return false;
+    }
+
+    const auto& markers = g_replay.markers();
+    static const char* const kMarkerNames[] = { "감지", "통과", "표시", "정답 시작", "정답 끝" };
+    std::cout << "재생: " << g_replayPath << " (프레임 " << g_replay.frameCount() << "개, "
+              << std::fixed << std::setprecision(1)
+              << (g_replay.timestampNs(g_replay.frameCount() - 1) - g_replay.timestampNs(0)) / 1e9 << "초, 마커 "
+              << markers.size() << "개, 배속 ";
+    if (g_replaySpeed > 0) std::cout << "x" << std::setprecision(2) << g_replaySpeed << ")" << std::endl;
+    else std::cout << "최대)" << std::endl;
+    std::cout << std::setprecision(1);
+    for (size_t k = 0; k < markers.size() && k < 20; k++) {
+        const auto& m = markers[k];
+        std::cout << "  마커 " << k << ": " << (m.type <= record::MARK_TRUTH_EXIT ? kMarkerNames[m.type] : "?")
+                  << " @ 프레임 " << m.frameIndex << " ("
+                  << (m.timestampNs - g_replay.timestampNs(0)) / 1e9 << "초)" << std::endl;
+    }
+    if (markers.size() > 20) std::cout << "  ..." << std::endl;
+
+    g_replayPos = 0;
+    if (g_replayMarker >= 0) {
+        if (static_cast<size_t>(g_replayMarker) >= markers.size()) {
+            std::cerr << "오류: 마커 " << g_replayMarker << "가 없습니다 (마커 " << markers.size() << "개)" << std::endl;
+            return false;
+        }
+        g_replayPos = g_replay.frameAt(markers[g_replayMarker].timestampNs - REPLAY_PREROLL_NS);
+        g_replay.prefetch(g_replayPos, static_cast<size_t>(std::max(g_replay.fps(), 1.0) * 4));
+        std::cout << "마커 " << g_replayMarker << " 앞 " << REPLAY_PREROLL_NS / 1000000000LL
+                  << "초(프레임 " << g_replayPos << ")부터 재생" << std::endl;
+    }
+    g_replayFirstNs = g_replay.timestampNs(g_replayPos);
+
+    // --roi가 없으면 녹화할 때 쓰던 ROI 사용
+    std::vector<cv::Point> roi = g_replay.roi();
+    if (!g_roiSelected && roi.size() > 2) {
+        std::lock_guard<std::mutex> lock(g_roiMutex);
+        g_points = roi;
+        g_roiSelected = true;
+        std::cout << "녹화 ROI 사용 (점 " << roi.size() << "개)" << std::endl;
+    }
+    return true;
+}
+
+// --- 명령행 인자 처리 ---
+void printUsage(const char* prog) {
+    std::cout << "사용법: " << prog << " [옵션]\n"
+              << "  --preview-fps N   운영자 화면 갱신 주기 (기본 10, 0이면 창 없음)\n"
+              << "  --headless        창 없이 실행 (--roi 필요)\n"
+              << "  --roi \"x,y;x,y;x,y\"  ROI 다각형 지정 (캡처 좌표)\n"
+              << "  --capture-cpu N   캡처 콜백(GStreamer 스트리밍 스레드)을 코어 N에 고정\n"
+              << "  --detect-cpu N    감지 스레드를 코어 N에 고정\n"
+              << "  --capture-prio P  캡처 콜백 스레드 SCHED_FIFO 우선순위 (1~99)\n"
+              << "  --detect-prio P   감지 스레드 SCHED_FIFO 우선순위 (1~99)\n"
+              << "  --mlock           감지 버퍼 포함 전체 메모리 잠금 (mlockall)\n"
+              << "  --detect-threads N  프레임을 가로 띠로 나눠 N개 스레드로 처리 (기본 1)\n"
+              << "  --min-presence-ms N  감지 후 최소 유지 시간 (기본 500ms)\n"
+              << "  --release-hold-ms N  SAD가 내려간 뒤 해제 확정까지 시간 (기본 100ms)\n"
+              << "  --min-gap-ms N    병 사이 최소 간격 - 앞 병이 빠진 뒤 이 시간 안의 감지는 무시 (기본 0, 검사 안 함)\n"
+              << "  --release-threshold V  하강 임계값 절대값 (기본: 상승 임계값 x 0.6)\n"
+              << "  --no-illum        조명 변화 보정 끄기\n"
+              << "  --hires WxH       고해상도 스트림을 함께 열어 병 감지 시 증거 이미지 저장 (예: 1280x720)\n"
+              << "  --snapshot-dir DIR  증거 이미지 저장 위치 (기본 snapshots)\n"
+              << "  --shift-start H   첫 교대 시작 시각 (기본 6시)\n"
+              << "  --shift-hours N   교대 길이 (기본 8시간)\n"
+              << "  --reject-dwell MIN,MAX  정상 체류 시간 범위 ms - 벗어나면 불량 집계 (0은 검사 안 함)\n"
+              << "  --telemetry NAME  텔레메트리 공유 메모리 이름 (기본 " << telemetry::kDefaultShmName << ")\n"
+              << "  --no-telemetry    텔레메트리 공유 메모리 사용 안 함\n"
+              << "  --record FILE     감지한 프레임을 원본 그대로 녹화 (.frec, 'm'으로 마커 표시)\n"
+              << "  --replay FILE     카메라 대신 녹화 파일 재생 (ROI는 녹화 때 값 사용, --roi로 변경)\n"
+              << "  --replay-speed X  재생 배속 (기본 1, 0이면 최대 속도)\n"
+              << "  --replay-marker N  N번 마커 " << REPLAY_PREROLL_NS / 1000000000LL << "초 전부터 재생\n"
+              << std::endl;
+}
+
+bool parseRoiPoints(const std::string& spec, std::vector<cv::Point>& points) {
+    std::stringstream ss(spec);
+    std::string pair;
+    while (std::getline(ss, pair, ';')) {
+        int x, y;
+        if (sscanf(pair.c_str(), "%d,%d", &x, &y) != 2) return false;
+        points.push_back(cv::Point(x, y));
+    }
+    return points.size() > 2;
+}
+
+bool parseArgs(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--preview-fps" && i + 1 < argc) {
+            g_previewFps = std::atoi(argv[++i]);
+            if (g_previewFps <= 0) g_headless = true;
+        } else if (arg == "--headless") {
+            g_headless = true;
+        } else if (arg == "--capture-cpu" && i + 1 < argc) {
+            g_rtConfig.capture.cpu = std::atoi(argv[++i]);
+        } else if (arg == "--detect-cpu" && i + 1 < argc) {
+            g_rtConfig.detect.cpu = std::atoi(argv[++i]);
+        } else if (arg == "--capture-prio" && i + 1 < argc) {
+            g_rtConfig.capture.fifoPriority = std::atoi(argv[++i]);
+        } else if (arg == "--detect-prio" && i + 1 < argc) {
+            g_rtConfig.detect.fifoPriority = std::atoi(argv[++i]);
+        } else if (arg == "--mlock") {
+            g_rtConfig.lockMemory = true;
+        } else if (arg == "--detect-threads" && i + 1 < argc) {
+            g_detectThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--min-presence-ms" && i + 1 < argc) {
+            g_detectorConfig.minPresenceMs = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--release-hold-ms" && i + 1 < argc) {
+            g_detectorConfig.releaseHoldMs = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--min-gap-ms" && i + 1 < argc) {
+            g_detectorConfig.minGapMs = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--release-threshold" && i + 1 < argc) {
+            g_detectorConfig.releaseThreshold = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--no-illum") {
+            g_detectorConfig.illuminationCompensation = false;
+        } else if (arg == "--hires" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &g_hiresWidth, &g_hiresHeight) != 2 ||
+                g_hiresWidth <= 0 || g_hiresHeight <= 0) {
+                std::cerr << "오류: --hires 형식은 WxH 입니다: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--snapshot-dir" && i + 1 < argc) {
+            g_snapshotDir = argv[++i];
+        } else if (arg == "--shift-start" && i + 1 < argc) {
+            g_lineMetricsConfig.shiftStartHour = std::atoi(argv[++i]);
+        } else if (arg == "--shift-hours" && i + 1 < argc) {
+            g_lineMetricsConfig.shiftHours = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--reject-dwell" && i + 1 < argc) {
+            long long minMs = 0, maxMs = 0;
+            if (sscanf(argv[++i], "%lld,%lld", &minMs, &maxMs) != 2) {
+                std::cerr << "오류: --reject-dwell 형식은 MIN,MAX 입니다: " << argv[i] << std::endl;
+                return false;
+            }
+            g_lineMetricsConfig.rejectMinDwellMs = minMs;
+            g_lineMetricsConfig.rejectMaxDwellMs = maxMs;
+        } else if (arg == "--telemetry" && i + 1 < argc) {
+            g_telemetryName = argv[++i];
+        } else if (arg == "--no-telemetry") {
+            g_telemetryEnabled = false;
+        } else if (arg == "--record" && i + 1 < argc) {
+            g_recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            g_replayPath = argv[++i];
+        } else if (arg == "--replay-speed" && i + 1 < argc) {
+            g_replaySpeed = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--replay-marker" && i + 1 < argc) {
+            g_replayMarker = std::atoi(argv[++i]);
+        } else if (arg == "--roi" && i + 1 < argc) {
+            std::vector<cv::Point> points;
+            if (!parseRoiPoints(argv[++i], points)) {
+                std::cerr << "오류: ROI 형식이 잘못되었습니다: " << argv[i] << std::endl;
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(g_roiMutex);
+            g_points = points;
+            g_roiSelected = true;
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // 재생이면 녹화 파일의 ROI를 쓸 수 있으므로 파일을 연 뒤 다시 확인
+    if (g_headless && !g_roiSelected && g_replayPath.empty()) {
+        std::cerr << "오류: --headless 모드에서는 --roi로 ROI를 지정해야 합니다." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 // --- 메인 함수 ---
-int main() {
+int main(int argc, char* argv[]) {
+    if (!parseArgs(argc, argv)) {
+        return -1;
+    }
+    if (!g_replayPath.empty()) {
+        if (!openReplay()) return -1;
+        if (g_headless && !g_roiSelected) {
+            std::cerr << "오류: 녹화 파일에 ROI가 없습니다. --roi로 지정하세요." << std::endl;
+            return -1;
+        }
+    }
+
     // 시그널 핸들러 설정
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
@@ -207,27 +862,63 @@ int main() {
     std::cout << "=== 고속 플라스틱병 감지 시스템 v3.1 ===" << std::endl;
     std::cout << "해상도: " << CAPTURE_WIDTH << "x" << CAPTURE_HEIGHT 
               << " @ " << CAPTURE_FPS << "FPS" << std::endl;
+
+    DetectorConfig& detectorConfig = g_detectorConfig;
+    detectorConfig.width = CAPTURE_WIDTH;
+    detectorConfig.height = CAPTURE_HEIGHT;
+    detectorConfig.blurSize = BLUR_SIZE;
+    detectorConfig.threads = g_detectThreads;
+    // 작업자는 감지 스레드와 같은 우선순위로 (CPU는 고정하지 않음 - 감지 스레드가 기다리는 대상)
+    detectorConfig.workerInit = [](int band) {
+        RtThreadConfig workerCfg;
+        workerCfg.fifoPriority = g_rtConfig.detect.fifoPriority;
+        RtTuning::applyToCurrentThread(("detect-" + std::to_string(band)).c_str(), workerCfg);
+    };
+    g_engine = new DetectionEngine(detectorConfig);
+    g_lineMetrics = new LineMetrics(g_lineMetricsConfig);
+    std::cout << "감지 커널: " << g_engine->kernelName()
+              << " (스레드 " << g_engine->threads() << ")" << std::endl;
+    if (g_headless) {
+        std::cout << "프리뷰: 없음 (headless)" << std::endl;
+    } else {
+        std::cout << "프리뷰: " << g_previewFps << "FPS" << std::endl;
+    }
     
-    // 더 단순한 파이프라인 사용
-    std::string pipeline = 
-        "libcamerasrc ! "
-        "video/x-raw,width=" + std::to_string(CAPTURE_WIDTH) + 
-        ",height=" + std::to_string(CAPTURE_HEIGHT) + 
-        ",framerate=" + std::to_string(CAPTURE_FPS) + "/1 ! "
-        "videoconvert ! "
-        "videoscale ! "
-        "appsink drop=true max-buffers=1";  // 버퍼 설정 추가
-    
-    g_cap = new cv::VideoCapture(pipeline, cv::CAP_GSTREAMER);
-    
-    if (!g_cap->isOpened()) {
+    // 감지 스트림 (+ 고해상도 스트림) - appsink는 최신 1장만 유지
+    CaptureConfig captureConfig;
+    captureConfig.width = CAPTURE_WIDTH;
+    captureConfig.height = CAPTURE_HEIGHT;
+    captureConfig.fps = CAPTURE_FPS;
+    captureConfig.hiresWidth = g_hiresWidth;
+    captureConfig.hiresHeight = g_hiresHeight;
+    // 예전 캡처 스레드 설정은 new-sample 콜백을 부르는 스트리밍 스레드에 적용
+    captureConfig.streamingThreadInit = [] {
+        RtTuning::applyToCurrentThread("capture", g_rtConfig.capture);
+    };
+
+    if (g_replay.isOpen()) {
+        std::cout << "카메라 대신 녹화 파일 재생" << std::endl;
+    } else if (!g_camera.open(captureConfig)) {
         std::cerr << "오류: 카메라를 열 수 없습니다." << std::endl;
-        delete g_cap;
+        delete g_engine;
+        delete g_lineMetrics;
         return -1;
     }
-    
-    // 버퍼 크기 설정
-    g_cap->set(cv::CAP_PROP_BUFFERSIZE, 1);
+
+    // 원본 프레임 녹화 (청크 버퍼는 mlockall 전에 확보)
+    if (!g_recordPath.empty()) {
+        const int recordType = g_replay.isOpen() ? g_replay.type() : CV_8UC3;
+        const double recordFps = g_replay.isOpen() ? g_replay.fps() : CAPTURE_FPS;
+        if (g_recorder.open(g_recordPath, CAPTURE_WIDTH, CAPTURE_HEIGHT, recordType, recordFps)) {
+            std::cout << "녹화: " << g_recordPath << " ('m': 마커 표시)" << std::endl;
+        }
+    }
+
+    if (g_camera.hasHighRes()) {
+        mkdir(g_snapshotDir.c_str(), 0755);
+        std::cout << "고해상도 스트림: " << g_hiresWidth << "x" << g_hiresHeight
+                  << " (증거 이미지 → " << g_snapshotDir << "/)" << std::endl;
+    }
     
     std::cout << "카메라 준비 완료!\n" << std::endl;
     std::cout << "=== 사용 방법 ===" << std::endl;
@@ -238,185 +929,171 @@ int main() {
     std::cout << "5. 숫자 입력: 임계값 직접 설정" << std::endl;
     std::cout << "6. 'a': 자동 임계값 (현재 SAD x 1.5)" << std::endl;
     std::cout << "7. 's': 통계 보기" << std::endl;
-    std::cout << "8. 'q': 종료" << std::endl;
+    std::cout << "8. 'm': 녹화 마커 표시 (--record)" << std::endl;
+    std::cout << "9. 'q': 종료" << std::endl;
     std::cout << "==================\n" << std::endl;
     
-    cv::namedWindow("Camera Feed", cv::WINDOW_AUTOSIZE);
-    cv::setMouseCallback("Camera Feed", onMouse, NULL);
-    
-    // 입력 스레드 시작
+    // 메모리 잠금 - 이후 감지 루프에서 페이지 폴트가 발생하지 않도록
+    // (엔진 버퍼는 생성자에서 할당됨, 프레임 버퍼는 GStreamer 버퍼 풀에서 재사용)
+    // (재생 중에는 녹화 파일 매핑 전체가 잠기므로 사용 안 함)
+    if (g_rtConfig.lockMemory && g_replay.isOpen()) {
+        std::cout << "[RT] 재생 중에는 --mlock을 적용하지 않습니다." << std::endl;
+    } else if (g_rtConfig.lockMemory && RtTuning::lockMemory()) {
+        const cv::Mat& blurred = g_engine->blurredFrame();
+        RtTuning::prefault(blurred.data, blurred.total() * blurred.elemSize());
+    }
+
+    // 텔레메트리 공유 메모리 (실패해도 감지는 계속)
+    if (g_telemetryEnabled) {
+        g_telemetryData.width = CAPTURE_WIDTH;
+        g_telemetryData.height = CAPTURE_HEIGHT;
+        g_telemetryData.threads = g_engine->threads();
+        g_telemetryWriter.open(g_telemetryName);
+    }
+
+    // 입력/프리뷰 스레드는 실시간 설정을 물려받지 않도록 먼저 시작
     std::thread inputThread(inputHandler);
-    
-    // 프로세싱용 변수
-    cv::Mat frame, grayFrame, blurredFrame, displayFrame;
-    int errorCount = 0;
-    const int MAX_ERRORS = 10;
+
+    // 프리뷰 스레드 시작 (감지 루프와 분리)
+    std::thread previewThread;
+    if (!g_headless) {
+        previewThread = std::thread(previewHandler);
+    }
+
+    // 스냅샷 스레드 (고해상도 변환/저장은 감지 스레드 밖에서)
+    std::thread snapshotThread;
+    if (g_camera.hasHighRes()) {
+        snapshotThread = std::thread(snapshotHandler);
+    }
+
+    // 감지 스레드(메인) 실시간 설정 및 자가 점검
+    RtTuning::applyToCurrentThread("detect", g_rtConfig.detect);
+    RtTuning::reportProcess();
+
+    auto lastTelemetry = std::chrono::steady_clock::now();
+    g_replayBaseNs = std::chrono::duration_cast<std::chrono::nanoseconds>(lastTelemetry.time_since_epoch()).count();
+    // 재생이면 한 프레임 주기 = 녹화 주기 / 배속 (최대 속도면 지연 판정 안 함)
+    const int64_t replayPeriodNs = g_replay.isOpen() && g_replaySpeed > 0 && g_replay.fps() > 0
+        ? static_cast<int64_t>(1e9 / g_replay.fps() / g_replaySpeed) : 0;
+    InputFrame input;
     
     while (!g_shouldExit) {
-        if (!g_cap->read(frame)) {
-            errorCount++;
-            if (errorCount > MAX_ERRORS) {
+        FrameWait wait = nextFrame(input);
+        if (wait == FrameWait::End) {
+            std::cerr << (g_replay.isOpen() ? "녹화 재생이 끝났습니다. 종료합니다." : "카메라 스트림이 끝났습니다. 종료합니다.") << std::endl;
+            break;
+        }
+        if (wait == FrameWait::Timeout) {
+            if (g_replay.isOpen()) continue;
+            g_camera.reportErrors();
+            if (g_camera.stalledNs() > CAPTURE_STALL_LIMIT_NS) {
                 std::cerr << "프레임 읽기 실패가 계속됩니다. 종료합니다." << std::endl;
                 break;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
             continue;
         }
-        errorCount = 0;  // 성공 시 에러 카운트 리셋
-        
-        if (frame.empty()) continue;
-        
-        // 그레이스케일 변환
-        if (frame.channels() > 1) {
-            cv::cvtColor(frame, grayFrame, cv::COLOR_BGR2GRAY);
-        } else {
-            grayFrame = frame;
+        auto detectStart = std::chrono::steady_clock::now();
+        const int64_t captureNs = input.captureNs;
+        const int64_t arrivalNs = input.arrivalNs;
+
+        // ROI가 막 선택되었으면 엔진에 전달 (다음 프레임이 기준 프레임이 됨)
+        if (g_roiSelected && !g_engine->hasRoi()) {
+            std::lock_guard<std::mutex> lock(g_roiMutex);
+            g_engine->setRoi(g_points);
+            if (g_recorder.isOpen()) g_recorder.setRoi(g_points);
+            std::cout << "초기화 완료 - 감지 시작" << std::endl;
         }
-        
-        // 가우시안 블러 적용
-        cv::GaussianBlur(grayFrame, blurredFrame, cv::Size(BLUR_SIZE, BLUR_SIZE), 0);
-        
-        // 현재 프레임 저장
-        g_currentFrame = blurredFrame.clone();
-        
-        // 디스플레이용 프레임 준비 (확대)
-        cv::resize(blurredFrame, displayFrame, cv::Size(640, 480), 0, 0, cv::INTER_LINEAR);
-        
-        if (!g_roiSelected) {
-            // ROI 선택 모드
-            if (g_drawing && g_points.size() > 0) {
-                // 디스플레이 좌표로 변환하여 그리기
-                std::vector<cv::Point> displayPoints;
-                for (const auto& pt : g_points) {
-                    displayPoints.push_back(cv::Point(pt.x * 640 / CAPTURE_WIDTH, 
-                                                    pt.y * 480 / CAPTURE_HEIGHT));
-                }
-                
-                for (size_t i = 0; i < displayPoints.size() - 1; ++i) {
-                    cv::line(displayFrame, displayPoints[i], displayPoints[i+1], cv::Scalar(255), 2);
-                }
+
+        // 그레이 변환 → 블러 → SAD → 디바운스
+        FrameResult result = g_engine->feed(input.image, captureNs);
+        auto detectEnd = std::chrono::steady_clock::now();
+
+        // 단계별 지연 시간 표본
+        const int64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(detectStart.time_since_epoch()).count();
+        const int64_t endNs = std::chrono::duration_cast<std::chrono::nanoseconds>(detectEnd.time_since_epoch()).count();
+        g_stageLatency[telemetry::STAGE_QUEUE].add((startNs - arrivalNs) / 1000.0f);
+        g_stageLatency[telemetry::STAGE_PROCESS].add((endNs - startNs) / 1000.0f);
+        g_stageLatency[telemetry::STAGE_TOTAL].add((endNs - arrivalNs) / 1000.0f);
+
+        // 한 프레임 주기 안에 처리하지 못한 프레임 → 지연으로 집계
+        const int64_t framePeriodNs = g_replay.isOpen() ? replayPeriodNs : g_camera.framePeriodNs();
+        if (framePeriodNs > 0 && endNs - arrivalNs > framePeriodNs) g_lateFrames++;
+        g_frameLoss.sample(collectFrameLoss(), endNs);
+        checkFrameLoss(endNs);
+
+        // 녹화는 감지가 끝난 뒤 (감지 지연에 포함되지 않도록)
+        if (g_recorder.isOpen()) {
+            g_recorder.append(input.image, captureNs, input.ptsNs);
+            if (g_markRequested.exchange(false)) {
+                g_recorder.mark(record::MARK_OPERATOR, captureNs);
+                std::cout << "녹화 마커 표시 (프레임 " << g_recorder.frames() << ")" << std::endl;
             }
-            cv::putText(displayFrame, "Click points, right-click to close ROI", 
-                       cv::Point(10, 30), cv::FONT_HERSHEY_SIMPLEX, 0.7, cv::Scalar(255), 2);
-            
-        } else {
-            // 감지 모드
-            // ROI 영역 표시
-            if (g_points.size() > 1) {
-                std::vector<cv::Point> displayPoints;
-                for (const auto& pt : g_points) {
-                    displayPoints.push_back(cv::Point(pt.x * 640 / CAPTURE_WIDTH, 
-                                                    pt.y * 480 / CAPTURE_HEIGHT));
-                }
-                const cv::Point* pts[1] = { displayPoints.data() };
-                int npts[] = { (int)displayPoints.size() };
-                cv::polylines(displayFrame, pts, npts, 1, true, cv::Scalar(255), 2);
+        }
+
+        for (const auto& event : g_engine->events()) {
+            if (g_recorder.isOpen()) {
+                const bool enter = event.type == DetectionEventType::Enter;
+                g_recorder.mark(enter ? record::MARK_ENTER : record::MARK_EXIT, event.timestampNs, event.roiId,
+                                enter ? event.sad : event.durationNs / 1e6);
             }
-            
-            // 초기 프레임 설정
-            if (g_prevFrame.empty()) {
-                g_prevFrame = blurredFrame.clone();
-                g_baselineFrame = blurredFrame.clone();
-                std::cout << "초기화 완료 - 감지 시작" << std::endl;
+            recordTelemetryEvent(event);
+            g_lineMetrics->onEvent(event, LineMetrics::wallNowSec());
+            if (event.type == DetectionEventType::Enter) {
+                pushBottle(event);
             } else {
-                // SAD 계산
-                if (!g_baselineFrame.empty()) {
-                    g_currentSAD = calculateFastSAD(blurredFrame, g_baselineFrame, g_roiMask);
-                } else {
-                    g_currentSAD = calculateFastSAD(blurredFrame, g_prevFrame, g_roiMask);
-                }
-                
-                // 히스토리 업데이트
-                g_sadHistory.push_back(g_currentSAD);
-                if (g_sadHistory.size() > HISTORY_SIZE) {
-                    g_sadHistory.pop_front();
-                }
-                
-                // 병 감지 로직
-                double threshold = g_sadThreshold.load();
-                if (!g_isBottlePresent && g_currentSAD > threshold) {
-                    g_isBottlePresent = true;
-                    g_framesSinceDetection = 0;
-                    pushBottle();
-                } else if (g_isBottlePresent) {
-                    g_framesSinceDetection++;
-                    if (g_framesSinceDetection > DEBOUNCE_FRAMES && g_currentSAD < threshold * 0.6) {
-                        g_isBottlePresent = false;
-                        std::cout << "병 통과 완료" << std::endl;
-                    }
-                }
-                
-                // 정보 표시
-                std::stringstream ss;
-                ss << "FPS: " << std::fixed << std::setprecision(1) << g_fps 
-                   << " | SAD: " << std::setprecision(0) << g_currentSAD 
-                   << " / " << threshold;
-                cv::putText(displayFrame, ss.str(), cv::Point(10, 30), 
-                           cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255), 2);
-                
-                // '[' ']' 키 안내
-                cv::putText(displayFrame, "[ ] : adjust threshold", cv::Point(10, 460), 
-                           cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(200), 1);
-                
-                // SAD 레벨 바
-                int barWidth = static_cast<int>((g_currentSAD / threshold) * 200);
-                barWidth = std::min(barWidth, 200);
-                cv::rectangle(displayFrame, cv::Point(10, 45), 
-                            cv::Point(10 + barWidth, 55), cv::Scalar(200), cv::FILLED);
-                cv::rectangle(displayFrame, cv::Point(10, 45), 
-                            cv::Point(210, 55), cv::Scalar(255), 1);
-                
-                if (g_isBottlePresent) {
-                    cv::putText(displayFrame, "DETECTED!", cv::Point(10, 85), 
-                               cv::FONT_HERSHEY_SIMPLEX, 1.2, cv::Scalar(255), 3);
-                    cv::rectangle(displayFrame, cv::Point(5, 5), 
-                                cv::Point(635, 475), cv::Scalar(255), 5);
-                }
-                
-                g_prevFrame = blurredFrame.clone();
+                std::cout << "병 통과 완료 (머문 시간: " << event.durationNs / 1000000 << "ms)" << std::endl;
             }
         }
         
         // FPS 업데이트
         updateFPS();
-        
-        // 그레이스케일을 3채널로 변환하여 컬러 표시
-        cv::Mat displayColor;
-        cv::cvtColor(displayFrame, displayColor, cv::COLOR_GRAY2BGR);
-        cv::imshow("Camera Feed", displayColor);
-        
-        char key = cv::waitKey(1) & 0xFF;
-        if (key == 'q' || key == 27) {
-            g_shouldExit = true;
-            break;
-        } else if (key == 'b' && g_roiSelected) {
-            captureBaseline();
-        } else if (key == '[') {
-            g_sadThreshold = g_sadThreshold * 0.9;
-            std::cout << "임계값 감소: " << g_sadThreshold << std::endl;
-        } else if (key == ']') {
-            g_sadThreshold = g_sadThreshold * 1.1;
-            std::cout << "임계값 증가: " << g_sadThreshold << std::endl;
+
+        // 프리뷰 스레드로 최신 상태 전달
+        publishPreview(result);
+
+        // 텔레메트리는 이벤트가 있거나 주기가 지났을 때만 공유 메모리에 반영
+        if (g_telemetryWriter.isOpen() &&
+            (!g_engine->events().empty() || detectEnd - lastTelemetry >= std::chrono::milliseconds(TELEMETRY_PERIOD_MS))) {
+            publishTelemetry(result);
+            lastTelemetry = detectEnd;
         }
     }
     
     // 정리
     g_shouldExit = true;
+    g_camera.stop();
+
+    if (previewThread.joinable()) {
+        previewThread.join();
+    }
+
+    g_snapshotCv.notify_all();
+    if (snapshotThread.joinable()) {
+        snapshotThread.join();
+    }
     
     // 카메라 해제
-    if (g_cap) {
-        g_cap->release();
-        delete g_cap;
+    g_camera.close();
+    g_replay.close();
+
+    // 녹화 마무리 (남은 청크 + 프레임 인덱스 / 마커 기록)
+    if (g_recorder.isOpen()) {
+        const uint64_t frames = g_recorder.frames();
+        const uint64_t dropped = g_recorder.droppedFrames();
+        const bool ok = g_recorder.close();
+        std::cout << "녹화 " << (ok ? "완료" : "실패") << ": " << g_recordPath << " (프레임 " << frames
+                  << "개, 디스크 지연으로 빠짐 " << dropped << "개)" << std::endl;
     }
     
-    // 스레드 종료 대기
+    // 스레드 종료 대기 (입력 스레드가 엔진을 참조하므로 그 다음에 해제)
     if (inputThread.joinable()) {
         std::cout << "\n입력 스레드 종료 중..." << std::endl;
         inputThread.join();
     }
-    
-    cv::destroyAllWindows();
+    delete g_engine;
+    delete g_lineMetrics;
+    g_telemetryWriter.close();
     
     std::cout << "\n프로그램이 안전하게 종료되었습니다." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,501 @@
+#include "detect_engine.hpp"
+#include "synthetic_scene.hpp"
+#include "detection_eval.hpp"
+#include "frame_record.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <opencv2/imgproc.hpp>
+
+/*
+ * 병 감지 엔진 헤드리스 벤치마크
+ * - 합성 장면을 만들어 엔진에 넣고 프레임당 처리 시간과 감지 정확도를 출력
+ * - 장면 생성 시간은 측정에서 제외
+ * - --scaling: 320x240 / 640x480 / 1280x720에서 스레드 수 1~N 처리 시간 비교
+ * - --bandwidth: OpenCV 단계별 처리 / 분리 커널 / fused 커널의 처리 시간과 메모리 트래픽 비교
+ * - --record: 합성 장면을 원본 녹화 파일(.frec)로 저장 (정답 구간은 마커로)
+ * - --replay: 원본 녹화를 mmap해서 그대로 엔진에 넣고 처리 시간 / 정확도 측정 (디코딩 비용 없음)
+ */
+
+struct BenchOptions {
+    SceneConfig scene;
+    int frames = 900;
+    int warmup = 30;
+    double threshold = 0.0;   // 0이면 장면에서 계산
+    bool check = false;       // 정답과 다르면 종료 코드 1
+    int threads = 1;          // 감지 엔진 스레드 수
+    bool illumination = true; // 조명 보정 사용
+    int scalingMax = 0;       // > 0이면 스케일링 모드 (최대 스레드 수)
+    bool bandwidth = false;   // 전처리 방식별 메모리 트래픽 비교 모드
+    std::string recordPath;   // 합성 장면 녹화 파일
+    std::string replayPath;   // 재생할 녹화 파일 (지정하면 합성 장면 대신 사용)
+};
+
+static void printUsage(const char* prog) {
+    std::cout << "사용법: " << prog << " [옵션]\n"
+              << "  --width N --height N   해상도 (기본 320x240)\n"
+              << "  --fps F                장면 프레임레이트 (기본 30)\n"
+              << "  --frames N             측정 프레임 수 (기본 900)\n"
+              << "  --speed PX             벨트 속도 픽셀/초 (기본 폭의 40%)\n"
+              << "  --interval S           병 투입 간격 초 (기본 1.5)\n"
+              << "  --noise SIGMA          픽셀 노이즈 (기본 3)\n"
+              << "  --drift A              조명 변화 비율 (기본 0.01)\n"
+              << "  --light-step F         조명 on/off 계단식 밝기 변화 비율 (예: 0.3)\n"
+              << "  --light-period S       조명 전환 주기 초 (기본 7)\n"
+              << "  --no-illum             조명 보정 끄기\n"
+              << "  --gray                 그레이 프레임 입력\n"
+              << "  --threshold T          SAD 임계값 (기본: 병 SAD의 35%)\n"
+              << "  --check                감지 결과가 정답과 다르면 실패 코드 반환\n"
+              << "  --threads N            감지 엔진 스레드 수 (기본 1)\n"
+              << "  --scaling [N]          해상도별 스레드 1~N 스케일링 측정 (기본 N = 코어 수)\n"
+              << "  --bandwidth            전처리 방식별 처리 시간 / 메모리 트래픽 비교 (1스레드)\n"
+              << "  --record FILE          측정에 쓴 합성 장면을 원본 녹화(.frec)로 저장 (정답 마커 포함)\n"
+              << "  --replay FILE          합성 장면 대신 원본 녹화 재생 (ROI는 녹화 값, 정답 마커가 있으면 정확도도 계산)\n"
+              << std::endl;
+}
+
+static bool parseArgs(int argc, char* argv[], BenchOptions& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--width" && hasValue) opt.scene.width = std::atoi(argv[++i]);
+        else if (arg == "--height" && hasValue) opt.scene.height = std::atoi(argv[++i]);
+        else if (arg == "--fps" && hasValue) opt.scene.fps = std::atof(argv[++i]);
+        else if (arg == "--frames" && hasValue) opt.frames = std::atoi(argv[++i]);
+        else if (arg == "--speed" && hasValue) opt.scene.beltSpeed = std::atof(argv[++i]);
+        else if (arg == "--interval" && hasValue) opt.scene.spawnInterval = std::atof(argv[++i]);
+        else if (arg == "--noise" && hasValue) opt.scene.noiseSigma = std::atof(argv[++i]);
+        else if (arg == "--drift" && hasValue) opt.scene.driftAmplitude = std::atof(argv[++i]);
+        else if (arg == "--light-step" && hasValue) opt.scene.lightStep = std::atof(argv[++i]);
+        else if (arg == "--light-period" && hasValue) opt.scene.lightStepPeriod = std::atof(argv[++i]);
+        else if (arg == "--no-illum") opt.illumination = false;
+        else if (arg == "--gray") opt.scene.color = false;
+        else if (arg == "--threshold" && hasValue) opt.threshold = std::atof(argv[++i]);
+        else if (arg == "--check") opt.check = true;
+        else if (arg == "--threads" && hasValue) opt.threads = std::atoi(argv[++i]);
+        else if (arg == "--bandwidth") opt.bandwidth = true;
+        else if (arg == "--record" && hasValue) opt.recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) opt.replayPath = argv[++i];
+        else if (arg == "--scaling") {
+            opt.scalingMax = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+            if (hasValue && argv[i + 1][0] != '-') opt.scalingMax = std::atoi(argv[++i]);
+        }
+        else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return opt.scene.width > 0 && opt.scene.height > 0 && opt.frames > 0 && opt.threads > 0;
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+/*
+ * 스레드 수별 처리 시간 비교
+ * - 해상도마다 장면을 미리 렌더링해 두고 같은 프레임 열을 스레드 수만 바꿔 처리
+ * - SAD 합이 1스레드 결과와 같은지도 확인 (띠 분할이 결과에 영향을 주지 않아야 함)
+ */
+static int runScaling(const BenchOptions& opt) {
+    const cv::Size resolutions[] = { {320, 240}, {640, 480}, {1280, 720} };
+    const int clipFrames = 60;
+    const int feeds = std::max(opt.frames, clipFrames);
+    bool allMatch = true;
+
+    std::cout << "=== 감지 엔진 스레드 스케일링 (최대 " << opt.scalingMax << "스레드, 프레임 "
+              << feeds << "개) ===" << std::endl;
+    std::cout << std::left << std::setw(11) << "해상도" << std::right
+              << std::setw(8) << "스레드" << std::setw(12) << "평균(us)" << std::setw(12) << "p99(us)"
+              << std::setw(10) << "FPS" << std::setw(10) << "배속" << "  SAD" << std::endl;
+
+    for (const auto& res : resolutions) {
+        SceneConfig sceneCfg = opt.scene;
+        sceneCfg.width = res.width;
+        sceneCfg.height = res.height;
+        sceneCfg.beltSpeed = 0.0;   // 해상도에 맞는 기본 속도
+        SyntheticScene scene(sceneCfg);
+
+        std::vector<cv::Mat> clip(clipFrames);
+        std::vector<int64_t> stamps(clipFrames);
+        for (int i = 0; i < clipFrames; i++) stamps[i] = scene.render(clip[i]);
+
+        std::vector<cv::Point> roi = scene.suggestedRoi();
+        double baseMean = 0.0;
+        double baseSadSum = -1.0;
+
+        for (int threads = 1; threads <= opt.scalingMax; threads++) {
+            DetectorConfig cfg;
+            cfg.width = res.width;
+            cfg.height = res.height;
+            cfg.threads = threads;
+            DetectionEngine engine(cfg);
+            engine.setRoi(roi);
+
+            // 첫 프레임은 기준 프레임, 이후 워밍업
+            for (int i = 0; i < opt.warmup; i++) engine.feed(clip[i % clipFrames], stamps[i % clipFrames]);
+            engine.requestBaseline();
+            engine.feed(clip[0], stamps[0]);
+
+            std::vector<double> feedUs;
+            feedUs.reserve(feeds);
+            double sadSum = 0.0;
+            for (int i = 0; i < feeds; i++) {
+                int k = i % clipFrames;
+                auto t0 = std::chrono::steady_clock::now();
+                FrameResult r = engine.feed(clip[k], stamps[k]);
+                auto t1 = std::chrono::steady_clock::now();
+                feedUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+                sadSum += r.sad;
+            }
+
+            double mean = 0.0;
+            for (double v : feedUs) mean += v;
+            mean /= feedUs.size();
+            if (threads == 1) {
+                baseMean = mean;
+                baseSadSum = sadSum;
+            }
+            bool match = (sadSum == baseSadSum);
+            allMatch = allMatch && match;
+
+            std::ostringstream label;
+            label << res.width << "x" << res.height;
+            std::cout << std::left << std::setw(11) << (threads == 1 ? label.str() : "") << std::right
+                      << std::setw(8) << threads
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(12) << mean << std::setw(12) << percentile(feedUs, 0.99)
+                      << std::setprecision(0) << std::setw(10) << (1e6 / mean)
+                      << std::setprecision(2) << std::setw(9) << (baseMean / mean) << "x"
+                      << "  " << (match ? "일치" : "불일치") << std::endl;
+        }
+    }
+
+    if (!allMatch) {
+        std::cerr << "검사 실패: 스레드 수에 따라 SAD 결과가 다릅니다." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * 전처리 방식별 메모리 트래픽 비교 (프레임 전체, 1스레드)
+ * - chain: 기존 OpenCV 단계별 처리 cvtColor → GaussianBlur → absdiff → bitwise_and → sum
+ *          픽셀당 읽기/쓰기: 3+1 / 1+1 / 2+1 / 2+1 / 1 = 13바이트
+ * - split: cvtColor → 고정 크기 블러 → 마스크 SAD     3+1 / 1+1 / 3      = 9바이트
+ * - fused: 원본 3 + 블러 결과 쓰기 1 + 기준 1 + 마스크 1                  = 6바이트
+ * - 트래픽은 각 단계가 프레임 전체를 메모리에서 읽고 쓴다고 본 추정치
+ */
+static int runBandwidth(const BenchOptions& opt) {
+    const cv::Size resolutions[] = { {320, 240}, {640, 480}, {1280, 720} };
+    const int clipFrames = 30;
+    const int feeds = std::max(opt.frames, clipFrames);
+    bool allMatch = true;
+
+    std::cout << "=== 전처리 메모리 트래픽 비교 (프레임 " << feeds << "개, 5x5 블러) ===" << std::endl;
+    std::cout << std::left << std::setw(11) << "해상도" << std::setw(8) << "방식" << std::right
+              << std::setw(12) << "평균(us)" << std::setw(12) << "MB/프레임" << std::setw(10) << "GB/s"
+              << std::setw(10) << "배속" << "  SAD" << std::endl;
+
+    for (const auto& res : resolutions) {
+        SceneConfig sceneCfg = opt.scene;
+        sceneCfg.width = res.width;
+        sceneCfg.height = res.height;
+        sceneCfg.beltSpeed = 0.0;
+        SyntheticScene scene(sceneCfg);
+
+        std::vector<cv::Mat> clip(clipFrames);
+        for (int i = 0; i < clipFrames; i++) scene.render(clip[i]);
+
+        std::vector<cv::Point> roi = scene.suggestedRoi();
+        cv::Mat mask = cv::Mat::zeros(res, CV_8UC1);
+        const cv::Point* pts[1] = { roi.data() };
+        int npts[] = { (int)roi.size() };
+        cv::fillPoly(mask, pts, npts, 1, cv::Scalar(255));
+
+        cv::Mat gray, blurred, diff, masked, baseline;
+        cv::cvtColor(clip[0], gray, cv::COLOR_BGR2GRAY);
+        cv::GaussianBlur(gray, baseline, cv::Size(5, 5), 0);
+
+        const DetectKernels& kernels = selectDetectKernels(res.width, res.height, 5);
+        const double pixels = static_cast<double>(res.width) * res.height;
+
+        struct Method {
+            const char* name;
+            double bytesPerPixel;
+            std::function<uint64_t(const cv::Mat&)> run;
+        };
+        std::vector<Method> methods;
+        methods.push_back({ "chain", 13.0, [&](const cv::Mat& f) {
+            cv::cvtColor(f, gray, cv::COLOR_BGR2GRAY);
+            cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
+            cv::absdiff(blurred, baseline, diff);
+            cv::bitwise_and(diff, mask, masked);
+            return static_cast<uint64_t>(cv::sum(masked)[0]);
+        } });
+        if (kernels.fused) {
+            methods.push_back({ "split", 9.0, [&](const cv::Mat& f) {
+                cv::cvtColor(f, gray, cv::COLOR_BGR2GRAY);
+                kernels.blur(gray, blurred, 0, res.height, 5);
+                return kernels.maskedSad(blurred, baseline, mask, 0, res.height, IlluminationModel());
+            } });
+            methods.push_back({ "fused", 6.0, [&](const cv::Mat& f) {
+                return kernels.fused(f, blurred, baseline, mask, 0, res.height, 0, res.height, IlluminationModel());
+            } });
+        }
+
+        double chainMean = 0.0;
+        uint64_t chainSad = 0;
+        for (size_t m = 0; m < methods.size(); m++) {
+            for (int i = 0; i < opt.warmup; i++) methods[m].run(clip[i % clipFrames]);
+
+            uint64_t sadSum = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int i = 0; i < feeds; i++) sadSum += methods[m].run(clip[i % clipFrames]);
+            auto t1 = std::chrono::steady_clock::now();
+            double mean = std::chrono::duration<double, std::micro>(t1 - t0).count() / feeds;
+
+            if (m == 0) {
+                chainMean = mean;
+                chainSad = sadSum;
+            }
+            bool match = (sadSum == chainSad);
+            allMatch = allMatch && match;
+
+            double mbPerFrame = methods[m].bytesPerPixel * pixels / 1e6;
+            std::ostringstream label;
+            label << res.width << "x" << res.height;
+            std::cout << std::left << std::setw(11) << (m == 0 ? label.str() : "") << std::setw(8) << methods[m].name
+                      << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(12) << mean << std::setprecision(2) << std::setw(12) << mbPerFrame
+                      << std::setw(10) << (mbPerFrame * 1e6 / (mean * 1e3)) 
+                      << std::setw(9) << (chainMean / mean) << "x"
+                      << "  " << (match ? "일치" : "불일치") << std::endl;
+        }
+        if (!kernels.fused) {
+            std::cout << "  (" << res.width << "x" << res.height << ": 고정 크기 커널 없음 - fused 생략)" << std::endl;
+        }
+    }
+
+    if (!allMatch) {
+        std::cerr << "검사 실패: 전처리 방식에 따라 SAD 결과가 다릅니다." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * 원본 녹화 재생 벤치마크
+ * - 파일 전체를 mmap한 채 프레임을 복사 없이 엔진에 넣음 (페이지 읽기 비용은 feed 시간에 포함)
+ * - 시각은 기록된 캡처 시각을 그대로 사용 → 디바운스 / 감지 지연이 실제 녹화와 같음
+ * - 정답 마커(MARK_TRUTH_*)가 있으면 정확도, 감지기가 남긴 마커(MARK_ENTER)와 감지 수도 비교
+ */
+static int runReplay(const BenchOptions& opt) {
+    record::FrameRecordReader rec;
+    if (!rec.open(opt.replayPath)) return 2;
+    std::vector<cv::Point> roi = rec.roi();
+    if (rec.frameCount() == 0 || roi.size() < 3) {
+        std::cerr << "오류: " << opt.replayPath << ": " << (rec.frameCount() == 0 ? "프레임이 없습니다" : "ROI가 없습니다")
+                  << std::endl;
+        return 2;
+    }
+
+    DetectorConfig cfg;
+    cfg.width = rec.width();
+    cfg.height = rec.height();
+    cfg.threads = opt.threads;
+    cfg.illuminationCompensation = opt.illumination;
+    if (opt.threshold > 0) cfg.sadThreshold = opt.threshold;
+
+    DetectionEngine engine(cfg);
+    engine.setRoi(roi);
+
+    const size_t frames = rec.frameCount();
+    const int64_t originNs = rec.timestampNs(0);
+    const double mediaSec = (rec.timestampNs(frames - 1) - originNs) / 1e9;
+    std::cout << "=== 원본 녹화 재생 벤치마크 ===" << std::endl;
+    std::cout << "파일: " << opt.replayPath << " | " << cfg.width << "x" << cfg.height
+              << " (" << (rec.type() == CV_8UC1 ? "GRAY" : "BGR") << ") | 프레임 " << frames
+              << " | " << std::fixed << std::setprecision(1) << mediaSec << "초"
+              << (rec.complete() ? "" : " (인덱스 없음 - 시각 추정)") << std::endl;
+    std::cout << "커널: " << engine.kernelName() << " | 스레드: " << engine.threads()
+              << " | 조명 보정: " << (opt.illumination ? "켬" : "끔")
+              << " | 임계값: " << std::setprecision(0) << engine.threshold() << std::endl;
+
+    std::vector<double> feedUs;
+    feedUs.reserve(frames);
+    std::vector<int64_t> enterTimes;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < frames; i++) {
+        auto t0 = std::chrono::steady_clock::now();
+        engine.feed(rec.frame(i), rec.timestampNs(i));
+        auto t1 = std::chrono::steady_clock::now();
+        if (i >= static_cast<size_t>(opt.warmup)) {
+            feedUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+        for (const auto& ev : engine.events()) {
+            if (ev.type == DetectionEventType::Enter) enterTimes.push_back(ev.timestampNs - originNs);
+        }
+    }
+    const double totalSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!feedUs.empty()) {
+        double sum = 0.0;
+        for (double v : feedUs) sum += v;
+        double mean = sum / feedUs.size();
+        std::cout << std::setprecision(1);
+        std::cout << "\n[처리 시간] 프레임 " << feedUs.size() << "개" << std::endl;
+        std::cout << "  평균: " << mean << " us | p50: " << percentile(feedUs, 0.5)
+                  << " us | p99: " << percentile(feedUs, 0.99) << " us | 최대: "
+                  << *std::max_element(feedUs.begin(), feedUs.end()) << " us" << std::endl;
+    }
+    const double mb = static_cast<double>(rec.header().frameBytes) * frames / 1e6;
+    std::cout << "  전체: " << std::setprecision(2) << totalSec << " s (" << std::setprecision(0)
+              << frames / totalSec << " FPS, " << mb / totalSec << " MB/s, 실시간 대비 x"
+              << std::setprecision(1) << (totalSec > 0 ? mediaSec / totalSec : 0.0) << ")" << std::endl;
+
+    // 정답 마커 → 정답 구간, 녹화 당시 감지 마커 수
+    std::vector<GroundTruthInterval> truth;
+    size_t recordedEnters = 0;
+    for (const auto& m : rec.markers()) {
+        if (m.type == record::MARK_ENTER) recordedEnters++;
+        if (m.type == record::MARK_TRUTH_ENTER) {
+            truth.push_back(GroundTruthInterval{static_cast<int>(truth.size()), m.timestampNs - originNs, -1});
+        } else if (m.type == record::MARK_TRUTH_EXIT && !truth.empty() && truth.back().exitNs < 0) {
+            truth.back().exitNs = m.timestampNs - originNs;
+        }
+    }
+
+    std::cout << "\n[감지] 이번 실행: " << enterTimes.size() << "회";
+    if (recordedEnters > 0) std::cout << " | 녹화 당시: " << recordedEnters << "회";
+    std::cout << std::endl;
+    if (truth.empty()) return 0;
+
+    DetectionScore score = DetectionEval::match(truth, enterTimes);
+    std::cout << "[정확도] 정답 병: " << score.truth << " | 감지: " << score.detections
+              << " | 적중: " << score.hits << " | 놓침: " << score.misses << " | 오검출: " << score.falseAlarms << std::endl;
+    if (score.hits > 0) {
+        std::cout << "  평균 감지 지연 (ROI 진입 기준): " << score.meanLatencyMs() << " ms" << std::endl;
+    }
+    if (opt.check && (score.misses > 0 || score.falseAlarms > 0)) {
+        std::cerr << "검사 실패: 감지 결과가 정답과 다릅니다." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    if (opt.bandwidth) return runBandwidth(opt);
+    if (opt.scalingMax > 0) return runScaling(opt);
+    if (!opt.replayPath.empty()) return runReplay(opt);
+
+    SyntheticScene scene(opt.scene);
+    std::vector<cv::Point> roi = scene.suggestedRoi();
+    cv::Rect roiRect = cv::boundingRect(roi);
+    scene.trackRoi(roiRect);
+
+    DetectorConfig cfg;
+    cfg.width = opt.scene.width;
+    cfg.height = opt.scene.height;
+    cfg.threads = opt.threads;
+    cfg.illuminationCompensation = opt.illumination;
+    cfg.sadThreshold = opt.threshold > 0 ? opt.threshold : scene.nominalBottleSad(roiRect) * 0.35;
+
+    DetectionEngine engine(cfg);
+    engine.setRoi(roi);
+
+    // 합성 장면 녹화 - 측정과 같은 프레임 열을 그대로 저장 (빠짐 없이 기록되도록 대기 허용)
+    record::FrameRecordWriter recorder;
+    if (!opt.recordPath.empty()) {
+        recorder.setBlocking(true);
+        if (!recorder.open(opt.recordPath, cfg.width, cfg.height, opt.scene.color ? CV_8UC3 : CV_8UC1, opt.scene.fps)) {
+            return 2;
+        }
+        recorder.setRoi(roi);
+    }
+
+    std::cout << "=== 감지 엔진 벤치마크 ===" << std::endl;
+    std::cout << "해상도: " << cfg.width << "x" << cfg.height << " (" << (opt.scene.color ? "BGR" : "GRAY") << ")"
+              << " | 커널: " << engine.kernelName() << " | 스레드: " << engine.threads()
+              << " | 조명 보정: " << (opt.illumination ? "켬" : "끔")
+              << " | 임계값: " << std::fixed << std::setprecision(0) << cfg.sadThreshold << std::endl;
+
+    cv::Mat frame;
+    std::vector<double> feedUs;
+    feedUs.reserve(opt.frames);
+    std::vector<int64_t> enterTimes;
+
+    double renderTotalUs = 0.0;
+    const int total = opt.warmup + opt.frames;
+    for (int i = 0; i < total; i++) {
+        auto r0 = std::chrono::steady_clock::now();
+        int64_t ts = scene.render(frame);
+        auto t0 = std::chrono::steady_clock::now();
+        engine.feed(frame, ts);
+        auto t1 = std::chrono::steady_clock::now();
+
+        renderTotalUs += std::chrono::duration<double, std::micro>(t0 - r0).count();
+        if (i >= opt.warmup) {
+            feedUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+        for (const auto& ev : engine.events()) {
+            if (ev.type == DetectionEventType::Enter) enterTimes.push_back(ev.timestampNs);
+        }
+        if (recorder.isOpen()) recorder.append(frame, ts);
+    }
+
+    // 처리 시간
+    double sum = 0.0;
+    for (double v : feedUs) sum += v;
+    double mean = sum / feedUs.size();
+    double framePeriodUs = 1e6 / opt.scene.fps;
+
+    std::cout << std::setprecision(1);
+    std::cout << "\n[처리 시간] 프레임 " << feedUs.size() << "개" << std::endl;
+    std::cout << "  평균: " << mean << " us | p50: " << percentile(feedUs, 0.5)
+              << " us | p99: " << percentile(feedUs, 0.99) << " us | 최대: "
+              << *std::max_element(feedUs.begin(), feedUs.end()) << " us" << std::endl;
+    std::cout << "  처리량: " << (1e6 / mean) << " FPS (실시간 대비 x" << (framePeriodUs / mean) << ")" << std::endl;
+    std::cout << "  (장면 생성 평균: " << (renderTotalUs / total) << " us, 측정 제외)" << std::endl;
+
+    // 정확도 - 정답 구간마다 그 안(종료 후 0.5초 여유)에 감지 이벤트가 있으면 적중
+    DetectionScore score = DetectionEval::match(scene.groundTruth(), enterTimes);
+
+    std::cout << "\n[정확도] 정답 병: " << score.truth << " | 감지: " << score.detections
+              << " | 적중: " << score.hits << " | 놓침: " << score.misses << " | 오검출: " << score.falseAlarms << std::endl;
+    if (score.hits > 0) {
+        std::cout << "  평균 감지 지연 (ROI 진입 기준): " << score.meanLatencyMs() << " ms" << std::endl;
+    }
+
+    if (recorder.isOpen()) {
+        for (const auto& g : scene.groundTruth()) {
+            recorder.mark(record::MARK_TRUTH_ENTER, g.enterNs, 0, g.bottleId);
+            if (g.exitNs >= 0) recorder.mark(record::MARK_TRUTH_EXIT, g.exitNs, 0, g.bottleId);
+        }
+        for (int64_t ts : enterTimes) recorder.mark(record::MARK_ENTER, ts);
+        const uint64_t recorded = recorder.frames();
+        if (recorder.close()) {
+            std::cout << "\n[녹화] " << opt.recordPath << ": 프레임 " << recorded << "개 (워밍업 포함), 정답 구간 "
+                      << scene.groundTruth().size() << "개" << std::endl;
+        }
+    }
+
+    if (opt.check && (score.misses > 0 || score.falseAlarms > 0)) {
+        std::cerr << "검사 실패: 감지 결과가 정답과 다릅니다." << std::endl;
+        return 1;
+    }
+    return 0;
+}
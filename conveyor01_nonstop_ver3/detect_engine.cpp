@@ -0,0 +1,143 @@
+#include "detect_engine.hpp"
+#include <opencv2/imgproc.hpp>
+
+DetectionEngine::DetectionEngine(const DetectorConfig& cfg)
+    : cfg_(cfg),
+      kernels_(&selectDetectKernels(cfg.width, cfg.height, cfg.blurSize)),
+      threshold_(cfg.sadThreshold),
+      pool_(new BandWorkerPool(cfg.threads, cfg.workerInit)),
+      presence_(0, PresenceConfig{cfg.minPresenceMs * 1000000LL, cfg.releaseHoldMs * 1000000LL,
+                                  cfg.minGapMs * 1000000LL, cfg.releaseRatio, cfg.releaseThreshold}) {
+    gray_.create(cfg_.height, cfg_.width, CV_8UC1);
+    blurred_.create(cfg_.height, cfg_.width, CV_8UC1);
+    baseline_.create(cfg_.height, cfg_.width, CV_8UC1);
+    history_.assign(std::max(cfg_.historySize, 1), 0.0);
+    events_.reserve(4);
+    bandSums_.resize(pool_->bands());
+}
+
+void DetectionEngine::setRoi(const std::vector<cv::Point>& polygon) {
+    roiPolygon_ = polygon;
+    roiMask_ = cv::Mat::zeros(cv::Size(cfg_.width, cfg_.height), CV_8UC1);
+    const cv::Point* pts[1] = { roiPolygon_.data() };
+    int npts[] = { (int)roiPolygon_.size() };
+    cv::fillPoly(roiMask_, pts, npts, 1, cv::Scalar(255));
+
+    cv::Rect bounds = cv::boundingRect(roiPolygon_) & cv::Rect(0, 0, cfg_.width, cfg_.height);
+    roiY0_ = bounds.y;
+    roiY1_ = bounds.y + bounds.height;
+    illumination_.setRegion(roiMask_);
+
+    // ROI가 바뀌면 기준 프레임과 감지 상태를 새로 시작
+    baselineReady_ = false;
+    presence_.reset();
+    bottlePresent_ = false;
+}
+
+FrameResult DetectionEngine::feed(const cv::Mat& frame, int64_t timestampNs) {
+    FrameResult result;
+    events_.clear();
+
+    if (frame.cols != cfg_.width || frame.rows != cfg_.height) {
+        rejectedFrames_.store(rejectedFrames_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return result;
+    }
+    result.accepted = true;
+    const uint64_t frameIndex = frameIndex_.load(std::memory_order_relaxed) + 1;
+    frameIndex_.store(frameIndex, std::memory_order_relaxed);
+
+    const int rows = cfg_.height;
+    const int bands = pool_->bands();
+
+    // 초기 프레임 또는 요청 시 기준 프레임 설정
+    const bool hasRoi = !roiMask_.empty();
+    const bool takeBaseline = hasRoi && (!baselineReady_ || baselineRequested_.exchange(false));
+    const bool computeSad = hasRoi && !takeBaseline;
+
+    // 조명 보정 추정 (참조 영역 표본만 읽음) - 차분 커널 안에서 기준 프레임 값에 적용
+    IlluminationModel illum;
+    if (computeSad && cfg_.illuminationCompensation) {
+        illum = illumination_.estimate(frame);
+    }
+
+    if (kernels_->fused) {
+        // 그레이 변환 + 블러 + SAD를 띠마다 한 번에 (띠 경계 행은 각 띠가 원본에서 직접 변환)
+        auto fusedPass = [&](int band) {
+            int y0, y1;
+            BandWorkerPool::bandRange(band, bands, rows, y0, y1);
+            int sy0 = computeSad ? std::max(y0, roiY0_) : 0;
+            int sy1 = computeSad ? std::min(y1, roiY1_) : 0;
+            bandSums_[band].value = kernels_->fused(frame, blurred_, baseline_, roiMask_, y0, y1, sy0, sy1, illum);
+        };
+        pool_->run(fusedPass);
+    } else {
+        // 범용 커널: 그레이 변환 → (전체 완료 후) 블러 + SAD
+        const cv::Mat* gray = &frame;
+        if (frame.channels() > 1) {
+            auto toGray = [&](int band) {
+                int y0, y1;
+                BandWorkerPool::bandRange(band, bands, rows, y0, y1);
+                cv::Mat dstRows = gray_.rowRange(y0, y1);
+                cv::cvtColor(frame.rowRange(y0, y1), dstRows, cv::COLOR_BGR2GRAY);
+            };
+            pool_->run(toGray);
+            gray = &gray_;
+        }
+
+        // 블러는 띠 위아래 행도 읽으므로 그레이 변환이 모두 끝난 뒤에 시작
+        auto blurAndSad = [&](int band) {
+            int y0, y1;
+            BandWorkerPool::bandRange(band, bands, rows, y0, y1);
+            kernels_->blur(*gray, blurred_, y0, y1, cfg_.blurSize);
+
+            uint64_t partial = 0;
+            int sy0 = std::max(y0, roiY0_);
+            int sy1 = std::min(y1, roiY1_);
+            if (computeSad && sy0 < sy1) {
+                partial = kernels_->maskedSad(blurred_, baseline_, roiMask_, sy0, sy1, illum);
+            }
+            bandSums_[band].value = partial;
+        };
+        pool_->run(blurAndSad);
+    }
+
+    if (!hasRoi) return result;
+
+    if (takeBaseline) {
+        blurred_.copyTo(baseline_);
+        illumination_.captureReference(baseline_);
+        baselineReady_ = true;
+        return result;
+    }
+
+    uint64_t total = 0;
+    for (int band = 0; band < bands; band++) total += bandSums_[band].value;
+
+    double threshold = threshold_.load();
+    double sad = static_cast<double>(total);
+
+    updateHistory(sad);
+    presence_.update(sad, threshold, frameIndex, timestampNs, events_);
+    bottlePresent_ = presence_.present();
+
+    illumGain_ = illum.gain();
+    illumOffset_ = illum.offset();
+
+    result.detecting = true;
+    result.sad = sad;
+    result.illumGain = illum.gain();
+    result.illumOffset = illum.offset();
+    result.bottlePresent = presence_.present();
+    return result;
+}
+
+void DetectionEngine::updateHistory(double sad) {
+    historySum_ += sad - history_[historyPos_];
+    history_[historyPos_] = sad;
+    historyPos_ = (historyPos_ + 1) % history_.size();
+
+    int count = std::min<int>(historyCount_.load() + 1, (int)history_.size());
+    historyCount_ = count;
+    currentSad_ = sad;
+    averageSad_ = historySum_ / count;
+}
@@ -0,0 +1,163 @@
+#ifndef DETECT_ENGINE_HPP
+#define DETECT_ENGINE_HPP
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "detect_kernels.hpp"
+#include "band_pool.hpp"
+#include "presence_tracker.hpp"
+#include "illumination.hpp"
+
+/*
+ * 병 감지 엔진 설정
+ * - width/height: 입력 프레임 크기 (다르면 프레임을 거부)
+ * - blurSize: 가우시안 블러 커널 크기
+ * - sadThreshold: 병 감지 SAD 임계값 (실행 중 setThreshold로 변경 가능)
+ * - minPresenceMs / releaseHoldMs / minGapMs: 감지 후 최소 유지 시간, 해제 확정 시간, 병 사이 최소 간격
+ *   releaseRatio / releaseThreshold: 하강 임계값 비율, 또는 절대값 (0보다 크면 비율 대신 사용)
+ *   (캡처 시각 기준이라 FPS와 무관 - PresenceTracker 참고)
+ * - historySize: 평균 SAD 계산에 쓰는 최근 프레임 수
+ * - threads: 프레임을 가로 띠로 나눠 처리할 스레드 수 (감지 스레드 포함)
+ * - workerInit: 작업자 스레드 시작 시 호출 (실시간 우선순위 등, 인자는 띠 번호)
+ * - illuminationCompensation: ROI 바깥 참조 영역으로 전역 밝기 변화를 추정해 SAD에서 제외
+ */
+struct DetectorConfig {
+    int width = 320;
+    int height = 240;
+    int blurSize = 5;
+    double sadThreshold = 50000.0;
+    int minPresenceMs = 500;
+    int releaseHoldMs = 100;
+    int minGapMs = 0;
+    double releaseRatio = 0.6;
+    double releaseThreshold = 0.0;
+    int historySize = 30;
+    int threads = 1;
+    std::function<void(int)> workerInit;
+    bool illuminationCompensation = true;
+};
+
+/*
+ * 한 프레임 처리 결과
+ */
+struct FrameResult {
+    bool accepted = false;   // 크기가 맞지 않는 프레임이면 false
+    bool detecting = false;  // ROI와 기준 프레임이 준비되어 SAD를 계산했는지
+    double sad = 0.0;
+    bool bottlePresent = false;
+    double illumGain = 1.0;     // 이번 프레임에 적용한 조명 보정
+    double illumOffset = 0.0;
+};
+
+/*
+ * ROI 기반 병 감지 엔진
+ * - 그레이 변환 → 블러 → 기준 프레임 대비 마스크 SAD → 시간 기준 상태 머신 → 이벤트
+ * - 그레이 변환과 블러+SAD는 가로 띠 단위로 작업자 풀에서 병렬 처리,
+ *   SAD는 띠별 부분합을 띠 순서대로 더함 (스레드 수와 관계없이 결과 동일)
+ * - 기준 프레임은 조명 보정(gain / offset)을 거친 뒤 차분 (IlluminationEstimator 참고)
+ * - 고정 크기 커널이 있으면 띠마다 fused 커널 한 번으로 처리 (그레이 중간 프레임 없음)
+ * - feed()와 events()는 감지 스레드 한 곳에서만 호출
+ * - setThreshold(), requestBaseline(), 통계 조회 함수는 다른 스레드에서 호출해도 안전
+ */
+class DetectionEngine {
+public:
+    explicit DetectionEngine(const DetectorConfig& cfg = DetectorConfig());
+
+    /*
+     * ROI 다각형 설정 (캡처 좌표) - 다음 프레임이 기준 프레임이 됨
+     */
+    void setRoi(const std::vector<cv::Point>& polygon);
+    bool hasRoi() const { return !roiMask_.empty(); }
+    const std::vector<cv::Point>& roi() const { return roiPolygon_; }
+
+    /*
+     * 프레임 처리 (BGR 또는 그레이)
+     * - timestampNs: 캡처 시각, 이벤트에 그대로 기록됨
+     */
+    FrameResult feed(const cv::Mat& frame, int64_t timestampNs);
+
+    /*
+     * 마지막 feed()에서 발생한 이벤트
+     */
+    const std::vector<DetectionEvent>& events() const { return events_; }
+
+    /*
+     * 마지막 feed()의 블러 처리된 그레이 프레임 (다음 feed() 전까지 유효)
+     */
+    const cv::Mat& blurredFrame() const { return blurred_; }
+
+    // 다음 프레임을 기준 프레임으로 사용
+    void requestBaseline() { baselineRequested_ = true; }
+
+    void setThreshold(double threshold) { threshold_ = threshold; }
+    double threshold() const { return threshold_.load(); }
+
+    // 통계 (다른 스레드에서 조회 가능)
+    double currentSad() const { return currentSad_.load(); }
+    double averageSad() const { return averageSad_.load(); }
+    int historyCount() const { return historyCount_.load(); }
+    bool bottlePresent() const { return bottlePresent_.load(); }
+    double illuminationGain() const { return illumGain_.load(); }
+    double illuminationOffset() const { return illumOffset_.load(); }
+    uint64_t frameCount() const { return frameIndex_.load(std::memory_order_relaxed); }
+    uint64_t rejectedFrames() const { return rejectedFrames_.load(std::memory_order_relaxed); }
+
+    const DetectorConfig& config() const { return cfg_; }
+    int threads() const { return pool_->bands(); }
+    const char* kernelName() const { return kernels_->name; }
+
+private:
+    void updateHistory(double sad);
+
+    DetectorConfig cfg_;
+    const DetectKernels* kernels_;
+
+    cv::Mat gray_;
+    cv::Mat blurred_;
+    cv::Mat baseline_;
+    cv::Mat roiMask_;
+    std::vector<cv::Point> roiPolygon_;
+    int roiY0_ = 0;   // ROI가 걸친 행 범위 - 이 밖의 행은 SAD 생략
+    int roiY1_ = 0;
+    bool baselineReady_ = false;
+
+    std::atomic<double> threshold_;
+    std::atomic<bool> baselineRequested_{false};
+
+    // 띠 병렬 처리 (부분합은 띠마다 캐시 라인을 따로 사용)
+    struct alignas(64) BandSum {
+        uint64_t value = 0;
+    };
+    std::unique_ptr<BandWorkerPool> pool_;
+    std::vector<BandSum> bandSums_;
+
+    // SAD 히스토리 (링 버퍼 + 누적합)
+    std::vector<double> history_;
+    size_t historyPos_ = 0;
+    double historySum_ = 0.0;
+
+    // 조명 보정 (참조 영역 표본은 setRoi/기준 프레임 캡처 때 갱신)
+    IlluminationEstimator illumination_;
+
+    // 병 유무 상태 (ROI 0번)
+    PresenceTracker presence_;
+
+    // 쓰는 쪽은 감지 스레드 하나 (load + store), 통계 / 텔레메트리 스레드는 읽기만
+    std::atomic<uint64_t> frameIndex_{0};
+    std::atomic<uint64_t> rejectedFrames_{0};
+    std::vector<DetectionEvent> events_;
+
+    std::atomic<double> currentSad_{0.0};
+    std::atomic<double> averageSad_{0.0};
+    std::atomic<int> historyCount_{0};
+    std::atomic<bool> bottlePresent_{false};
+    std::atomic<double> illumGain_{1.0};
+    std::atomic<double> illumOffset_{0.0};
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "detect_kernels.hpp"
+#include <opencv2/imgproc.hpp>
+
+namespace detect_kernels {
+
+void GenericKernels::blur(const cv::Mat& src, cv::Mat& dst, int y0, int y1, int blurSize) {
+    dst.create(src.size(), CV_8UC1);
+    // 부분 행렬이어도 바깥 행을 경계로 사용하므로 전체 블러와 결과가 같음
+    cv::Mat dstRows = dst.rowRange(y0, y1);
+    cv::GaussianBlur(src.rowRange(y0, y1), dstRows, cv::Size(blurSize, blurSize), 0);
+}
+
+uint64_t GenericKernels::maskedSad(const cv::Mat& cur, const cv::Mat& ref, const cv::Mat& mask, int y0, int y1,
+                                   const IlluminationModel& illum) {
+    cv::Mat diff, maskedDiff;
+    if (illum.identity()) {
+        cv::absdiff(cur.rowRange(y0, y1), ref.rowRange(y0, y1), diff);
+    } else {
+        cv::Mat adjusted;
+        ref.rowRange(y0, y1).convertTo(adjusted, CV_8U, illum.gain(), illum.offset());
+        cv::absdiff(cur.rowRange(y0, y1), adjusted, diff);
+    }
+    cv::bitwise_and(diff, mask.rowRange(y0, y1), maskedDiff);
+    return static_cast<uint64_t>(cv::sum(maskedDiff)[0]);
+}
+
+}  // namespace detect_kernels
+
+namespace {
+
+using namespace detect_kernels;
+
+struct KernelEntry {
+    int width;
+    int height;
+    int blurSize;
+    DetectKernels kernels;
+};
+
+#define FIXED_KERNEL_ENTRY(w, h, k) \
+    { w, h, k, { #w "x" #h " blur" #k "x" #k, \
+                 &FixedKernels<w, h, (k) / 2>::blur, \
+                 &FixedKernels<w, h, (k) / 2>::maskedSad, \
+                 &FixedKernels<w, h, (k) / 2>::fused } }
+
+// 컴파일 시점에 특수화되는 조합
+const KernelEntry kKernelTable[] = {
+    FIXED_KERNEL_ENTRY(320, 240, 5),
+    FIXED_KERNEL_ENTRY(640, 480, 5),
+    FIXED_KERNEL_ENTRY(1280, 720, 5),
+    FIXED_KERNEL_ENTRY(320, 240, 3),
+    FIXED_KERNEL_ENTRY(640, 480, 3),
+    FIXED_KERNEL_ENTRY(1280, 720, 3),
+};
+
+#undef FIXED_KERNEL_ENTRY
+
+const DetectKernels kGenericKernels = {
+    "generic (OpenCV)", &GenericKernels::blur, &GenericKernels::maskedSad, nullptr
+};
+
+}  // namespace
+
+const DetectKernels& selectDetectKernels(int width, int height, int blurSize) {
+    for (const auto& entry : kKernelTable) {
+        if (entry.width == width && entry.height == height && entry.blurSize == blurSize) {
+            return entry.kernels;
+        }
+    }
+    return kGenericKernels;
+}
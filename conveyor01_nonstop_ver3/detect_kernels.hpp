@@ -0,0 +1,254 @@
+#ifndef DETECT_KERNELS_HPP
+#define DETECT_KERNELS_HPP
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <cstdlib>
+
+/*
+ * 병 감지용 블러 / 차분 / 누적 커널
+ *
+ * - 자주 쓰는 캡처 해상도(320x240, 640x480, 1280x720)와 블러 크기(3x3, 5x5)는 템플릿으로
+ *   컴파일 시점에 크기가 고정된 커널을 만들어 루프가 펼쳐지고 벡터화되도록 함
+ * - 그 외 조합은 기존 OpenCV 호출(GaussianBlur + absdiff + bitwise_and + sum)로 처리
+ * - 모든 커널은 행 범위 [y0, y1)를 받아 부분 처리도 가능
+ * - 고정 크기 조합에는 그레이 변환 + 블러 + 차분 + 누적을 행 단위로 한 번에 처리하는
+ *   fused 커널도 제공 (프레임을 메모리에서 한 번만 읽음)
+ */
+
+/*
+ * 전역 조명 보정 - 기준 프레임 값 r을 gain * r + offset으로 바꾼 뒤 차분
+ * - 8비트 고정소수점 (gainQ8 = 256 → 1.0), 차분 루프 안에서 바로 적용하므로 추가 패스 없음
+ */
+struct IlluminationModel {
+    int gainQ8 = 256;
+    int offsetQ8 = 0;
+
+    bool identity() const { return gainQ8 == 256 && offsetQ8 == 0; }
+    double gain() const { return gainQ8 / 256.0; }
+    double offset() const { return offsetQ8 / 256.0; }
+};
+
+/*
+ * 커널 묶음 - 시작 시 selectDetectKernels()로 한 번 골라서 사용
+ * - blur: 8비트 그레이 → 8비트 그레이 (BORDER_REFLECT_101, sigma 자동과 동일한 이항 계수)
+ *   blurSize는 범용 커널만 사용 (특수화 커널은 선택할 때 정해진 크기) - 호출하는 쪽이 자기 설정값을 넘김
+ * - maskedSad: mask != 0 인 픽셀의 |cur - illum(ref)| 합
+ * - fused: BGR 또는 그레이 원본 → 블러 결과를 dst [y0, y1)에 쓰고,
+ *   그중 [sadY0, sadY1) 행의 마스크 SAD를 반환 (sadY0 >= sadY1이면 SAD 생략)
+ *   띠 바깥 행이 필요하면 원본에서 직접 변환하므로 다른 띠의 결과를 기다리지 않음
+ *   범용 커널에는 없음 (nullptr)
+ */
+struct DetectKernels {
+    const char* name;
+    void (*blur)(const cv::Mat& src, cv::Mat& dst, int y0, int y1, int blurSize);
+    uint64_t (*maskedSad)(const cv::Mat& cur, const cv::Mat& ref, const cv::Mat& mask, int y0, int y1,
+                          const IlluminationModel& illum);
+    uint64_t (*fused)(const cv::Mat& src, cv::Mat& dst, const cv::Mat& ref, const cv::Mat& mask,
+                      int y0, int y1, int sadY0, int sadY1, const IlluminationModel& illum);
+};
+
+/*
+ * 해상도/블러 크기에 맞는 커널 선택 (해당 특수화가 없으면 범용 커널)
+ */
+const DetectKernels& selectDetectKernels(int width, int height, int blurSize);
+
+namespace detect_kernels {
+
+// BORDER_REFLECT_101 인덱스 (gfedcb|abcdefgh|gfedcba)
+inline int reflect101(int i, int n) {
+    if (n == 1) return 0;
+    while (i < 0 || i >= n) {
+        if (i < 0) i = -i;
+        if (i >= n) i = 2 * n - 2 - i;
+    }
+    return i;
+}
+
+// BGR → 그레이 한 행 (OpenCV 기본 경로와 같은 14비트 고정소수점 계수: 0.114 / 0.587 / 0.299)
+template <int W>
+inline void bgrToGrayRow(const uint8_t* __restrict bgr, uint8_t* __restrict gray) {
+    for (int x = 0; x < W; x++) {
+        const uint8_t* p = bgr + 3 * x;
+        gray[x] = static_cast<uint8_t>((p[0] * 1868 + p[1] * 9617 + p[2] * 4899 + (1 << 13)) >> 14);
+    }
+}
+
+// 한 행의 마스크 SAD (행 합은 255 * W < 2^32)
+template <int W>
+inline uint32_t maskedSadRow(const uint8_t* __restrict c, const uint8_t* __restrict r,
+                             const uint8_t* __restrict m) {
+    uint32_t rowSum = 0;
+    for (int x = 0; x < W; x++) {
+        uint8_t d = c[x] > r[x] ? c[x] - r[x] : r[x] - c[x];
+        rowSum += d & m[x];
+    }
+    return rowSum;
+}
+
+// 조명 보정을 넣은 한 행의 마스크 SAD (기준값 보정 → 0~255 포화 → 차분)
+template <int W>
+inline uint32_t maskedSadRow(const uint8_t* __restrict c, const uint8_t* __restrict r,
+                             const uint8_t* __restrict m, const IlluminationModel& illum) {
+    if (illum.identity()) return maskedSadRow<W>(c, r, m);
+
+    const int g = illum.gainQ8;
+    const int o = illum.offsetQ8 + 128;
+    uint32_t rowSum = 0;
+    for (int x = 0; x < W; x++) {
+        int e = (r[x] * g + o) >> 8;
+        e = e < 0 ? 0 : (e > 255 ? 255 : e);
+        int d = c[x] > e ? c[x] - e : e - c[x];
+        rowSum += d & m[x];
+    }
+    return rowSum;
+}
+
+// 이항 계수 C(2R, k) - GaussianBlur(ksize ≤ 5, sigma = 0)의 고정 커널과 동일
+template <int R>
+struct BinomialWeights {
+    static constexpr int size = 2 * R + 1;
+    static constexpr int shift = 2 * R;   // 계수 합 = 2^(2R)
+    int w[size];
+    constexpr BinomialWeights() : w() {
+        for (int k = 0; k < size; k++) {
+            int c = 1;
+            for (int j = 0; j < k; j++) c = c * (size - 1 - j) / (j + 1);
+            w[k] = c;
+        }
+    }
+};
+
+/*
+ * 크기가 고정된 커널
+ * - W, H: 프레임 크기, R: 블러 반경 (5x5 → R = 2)
+ * - 수평 필터 결과(uint16)를 (2R+1)행 링 버퍼에 두고 수직 필터 → 반올림 후 8비트
+ *   R ≤ 2이면 최대값 255 * 2^(4R) ≤ 65280 이라 중간값이 uint16에 들어감
+ */
+template <int W, int H, int R>
+struct FixedKernels {
+    static_assert(R >= 1 && R <= 2, "uint16 fixed-point path supports 3x3 and 5x5 only");
+    static_assert(W > 2 * R && H > 2 * R, "frame smaller than kernel");
+
+    static constexpr int N = 2 * R + 1;
+
+    // 한 행 수평 필터
+    static inline void blurRowH(const uint8_t* __restrict src, uint16_t* __restrict dst) {
+        constexpr BinomialWeights<R> k{};
+        // 왼쪽/오른쪽 경계
+        for (int x = 0; x < R; x++) {
+            int acc = 0;
+            for (int i = 0; i < N; i++) acc += k.w[i] * src[reflect101(x - R + i, W)];
+            dst[x] = static_cast<uint16_t>(acc);
+        }
+        for (int x = W - R; x < W; x++) {
+            int acc = 0;
+            for (int i = 0; i < N; i++) acc += k.w[i] * src[reflect101(x - R + i, W)];
+            dst[x] = static_cast<uint16_t>(acc);
+        }
+        // 내부 - 고정 길이 루프라 벡터화됨
+        for (int x = R; x < W - R; x++) {
+            uint16_t acc = 0;
+            for (int i = 0; i < N; i++) acc += k.w[i] * src[x - R + i];
+            dst[x] = acc;
+        }
+    }
+
+    // 수직 필터 + 반올림
+    static inline void blurRowV(uint16_t (*ring)[W], const int* slot, uint8_t* __restrict dst) {
+        constexpr BinomialWeights<R> k{};
+        constexpr int shift = 2 * BinomialWeights<R>::shift;
+        constexpr uint32_t half = 1u << (shift - 1);
+        for (int x = 0; x < W; x++) {
+            uint32_t acc = half;
+            for (int i = 0; i < N; i++) acc += k.w[i] * ring[slot[i]][x];
+            dst[x] = static_cast<uint8_t>(acc >> shift);
+        }
+    }
+
+    static void blur(const cv::Mat& src, cv::Mat& dst, int y0, int y1, int /*blurSize*/) {
+        dst.create(H, W, CV_8UC1);
+        alignas(64) uint16_t ring[N][W];
+
+        // 가상 행 v의 수평 필터 결과는 ring[(v + N*H) % N]에 보관
+        auto slotOf = [](int v) { return (v + N * H) % N; };
+        for (int v = y0 - R; v < y0 + R; v++) {
+            blurRowH(src.ptr<uint8_t>(reflect101(v, H)), ring[slotOf(v)]);
+        }
+        for (int y = y0; y < y1; y++) {
+            int v = y + R;
+            blurRowH(src.ptr<uint8_t>(reflect101(v, H)), ring[slotOf(v)]);
+            int slot[N];
+            for (int i = 0; i < N; i++) slot[i] = slotOf(y - R + i);
+            blurRowV(ring, slot, dst.ptr<uint8_t>(y));
+        }
+    }
+
+    static uint64_t maskedSad(const cv::Mat& cur, const cv::Mat& ref, const cv::Mat& mask, int y0, int y1,
+                              const IlluminationModel& illum) {
+        uint64_t total = 0;
+        for (int y = y0; y < y1; y++) {
+            total += maskedSadRow<W>(cur.ptr<uint8_t>(y), ref.ptr<uint8_t>(y), mask.ptr<uint8_t>(y), illum);
+        }
+        return total;
+    }
+
+    /*
+     * 그레이 변환 + 블러 + 차분 + 누적을 한 번에
+     * - 원본 한 행을 읽어 그레이 행(W바이트) → 수평 필터 링 버퍼((2R+1) x W x 2바이트)로 보내고
+     *   수직 필터 결과 행을 쓰자마자 기준/마스크 같은 행과 SAD 누적
+     * - 작업 집합이 640폭 기준 수 KB라 L1에 머묾 - 원본은 한 번 읽고 블러 결과는 한 번 씀
+     */
+    template <int CN>
+    static uint64_t fusedImpl(const cv::Mat& src, cv::Mat& dst, const cv::Mat& ref, const cv::Mat& mask,
+                              int y0, int y1, int sadY0, int sadY1, const IlluminationModel& illum) {
+        dst.create(H, W, CV_8UC1);
+        alignas(64) uint16_t ring[N][W];
+        alignas(64) uint8_t grayRow[W];
+
+        auto slotOf = [](int v) { return (v + N * H) % N; };
+        auto loadRow = [&](int v) {
+            const uint8_t* s = src.ptr<uint8_t>(reflect101(v, H));
+            if (CN == 3) {
+                bgrToGrayRow<W>(s, grayRow);
+                s = grayRow;
+            }
+            blurRowH(s, ring[slotOf(v)]);
+        };
+
+        for (int v = y0 - R; v < y0 + R; v++) loadRow(v);
+
+        uint64_t total = 0;
+        for (int y = y0; y < y1; y++) {
+            loadRow(y + R);
+            int slot[N];
+            for (int i = 0; i < N; i++) slot[i] = slotOf(y - R + i);
+            uint8_t* out = dst.ptr<uint8_t>(y);
+            blurRowV(ring, slot, out);
+            if (y >= sadY0 && y < sadY1) {
+                total += maskedSadRow<W>(out, ref.ptr<uint8_t>(y), mask.ptr<uint8_t>(y), illum);
+            }
+        }
+        return total;
+    }
+
+    static uint64_t fused(const cv::Mat& src, cv::Mat& dst, const cv::Mat& ref, const cv::Mat& mask,
+                          int y0, int y1, int sadY0, int sadY1, const IlluminationModel& illum) {
+        return src.channels() == 3 ? fusedImpl<3>(src, dst, ref, mask, y0, y1, sadY0, sadY1, illum)
+                                   : fusedImpl<1>(src, dst, ref, mask, y0, y1, sadY0, sadY1, illum);
+    }
+};
+
+/*
+ * 범용 커널 (해상도/블러 크기 무관, OpenCV 사용)
+ * - 상태 없음: 블러 크기는 호출마다 인자로 받으므로 여러 엔진이 동시에 써도 됨
+ */
+struct GenericKernels {
+    static void blur(const cv::Mat& src, cv::Mat& dst, int y0, int y1, int blurSize);
+    static uint64_t maskedSad(const cv::Mat& cur, const cv::Mat& ref, const cv::Mat& mask, int y0, int y1,
+                              const IlluminationModel& illum);
+};
+
+}  // namespace detect_kernels
+
+#endif
@@ -0,0 +1,637 @@
+#include "detect_engine.hpp"
+#include "synthetic_scene.hpp"
+#include "detection_eval.hpp"
+#include "frame_record.hpp"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdlib>
+
+/*
+ * 감지 파라미터 스윕 (임계값 / 디바운스 / 블러)
+ * - 정답 구간이 있는 시퀀스(합성 장면, 녹화 영상 + 라벨 CSV, 원본 녹화 .frec)에 감지기를 돌려
+ *   설정마다 정밀도 / 재현율 / 감지 지연을 계산하고 최적 동작점을 출력
+ *
+ * 처리 순서
+ *   1) 시퀀스 × 블러 크기마다 감지 엔진을 한 번 돌려 프레임별 SAD를 기록
+ *      (SAD는 임계값/디바운스와 무관하므로 이 단계가 설정 하나를 실제로 돌리는 비용과 같음)
+ *   2) 임계값 × 최소 유지 × 해제 확정 조합마다 기록된 SAD를 PresenceTracker에 다시 넣어 평가
+ *   두 단계 모두 코어 수만큼 나눠 병렬 처리
+ *   (엔진은 블러 크기를 각자 설정으로 가지므로 블러가 다른 엔진이 동시에 돌아도 서로 영향 없음
+ *    - --check-jobs로 순차 처리 결과와 같은지 확인)
+ *
+ * 임계값은 기본적으로 "병이 ROI에 있는 프레임의 SAD 중앙값" 대비 비율로 훑음
+ * (블러 크기마다 SAD 크기가 달라지므로) - 결과에는 실제 임계값도 함께 출력
+ *
+ * 최적 동작점은 이웃 임계값까지 포함한 최저 F1(robust F1)로 고름
+ * → 경계에 붙은 임계값보다 조금 흔들려도 결과가 유지되는 구간의 가운데 쪽을 선택
+ */
+
+struct SweepOptions {
+    SceneConfig scene;
+    int frames = 1800;            // 합성 장면 하나의 프레임 수
+    int scenes = 4;               // 합성 장면 수 (시드만 다름)
+    std::vector<std::string> sequences;   // 녹화 시퀀스 "영상,라벨.csv" 또는 "녹화.frec[,라벨.csv]"
+    std::string roiSpec;          // 녹화 시퀀스 ROI (캡처 좌표)
+    double sequenceFps = 0.0;     // 0이면 영상 메타데이터 사용
+
+    std::vector<int> blurs = {3, 5, 7};
+    std::vector<double> ratios;   // 기준 SAD 대비 임계값 비율
+    std::vector<double> thresholds;   // 지정하면 비율 대신 절대 임계값 사용
+    std::vector<int> presenceMs = {0, 100, 250, 500};
+    std::vector<int> holdMs = {0, 50, 100, 200};
+    double releaseRatio = 0.6;
+    bool illumination = true;
+
+    int jobs = 0;                 // 0이면 코어 수
+    bool checkJobs = false;       // 1단계를 순차로 한 번 더 돌려 병렬 결과와 비교
+    std::string csvPath;
+};
+
+/*
+ * 정답 구간이 있는 시퀀스 하나
+ */
+struct Sequence {
+    std::string name;
+    bool synthetic = true;
+    SceneConfig scene;            // 합성 장면
+    int frames = 0;
+    std::string videoPath;        // 녹화 영상 / 원본 녹화 파일
+    bool recording = false;       // .frec (mmap 재생, 기록된 캡처 시각 사용)
+    double fps = 30.0;
+    std::vector<cv::Point> roi;
+    std::vector<GroundTruthInterval> truth;
+};
+
+/*
+ * 1단계 결과 - 시퀀스 하나를 블러 크기 하나로 처리한 SAD 기록
+ */
+struct SadTrace {
+    bool ok = false;
+    std::vector<double> sad;
+    std::vector<int64_t> timestampNs;
+    std::vector<uint64_t> frameIndex;
+    std::vector<GroundTruthInterval> truth;
+    std::vector<double> bottleSad;   // 정답 구간 안 프레임의 SAD (기준 SAD 계산용)
+    const char* kernel = "";         // 사용한 감지 커널 (특수화 / 범용)
+    double mediaSec = 0.0;           // 시퀀스 길이
+    double engineSec = 0.0;          // feed()에 걸린 시간
+};
+
+/*
+ * 2단계 결과 - 설정 하나의 전체 시퀀스 합산 점수
+ */
+struct SweepResult {
+    int blur = 0;
+    double ratio = 0.0;
+    double threshold = 0.0;
+    int presenceMs = 0;
+    int holdMs = 0;
+    DetectionScore score;
+    double robustF1 = 0.0;   // 같은 블러/디바운스에서 바로 옆 임계값까지 포함한 최저 F1
+};
+
+static void printUsage(const char* prog) {
+    std::cout << "사용법: " << prog << " [옵션]\n"
+              << "  시퀀스 (기본: 합성 장면)\n"
+              << "  --scenes N             합성 장면 수 (기본 4, 0이면 합성 장면 사용 안 함)\n"
+              << "  --frames N             합성 장면 하나의 프레임 수 (기본 1800)\n"
+              << "  --width N --height N --fps F --interval S --noise SIGMA --drift A --light-step F\n"
+              << "                         합성 장면 설정 (detect_bench와 같음)\n"
+              << "  --sequence VIDEO,LABELS  녹화 영상과 정답 CSV(enter_ms,exit_ms) - 여러 번 지정 가능\n"
+              << "  --sequence FILE.frec[,LABELS]  원본 녹화 (라벨이 없으면 녹화 안의 정답 마커 사용)\n"
+              << "  --roi \"x,y;x,y;x,y\"    녹화 시퀀스 ROI (.frec는 생략하면 녹화 때 ROI)\n"
+              << "  --seq-fps F            녹화 영상 프레임레이트 (기본: 영상 메타데이터)\n"
+              << "  스윕 범위 (목록 a,b,c 또는 범위 시작:끝:간격)\n"
+              << "  --blur LIST            블러 크기 (기본 3,5,7)\n"
+              << "  --ratios LIST          기준 SAD 대비 임계값 비율 (기본 0.1:0.9:0.05)\n"
+              << "  --thresholds LIST      절대 임계값 (지정하면 --ratios 대신 사용)\n"
+              << "  --presence LIST        최소 유지 시간 ms (기본 0,100,250,500)\n"
+              << "  --hold LIST            해제 확정 시간 ms (기본 0,50,100,200)\n"
+              << "  --release R            하강 임계값 비율 (기본 0.6)\n"
+              << "  --no-illum             조명 보정 끄기\n"
+              << "  기타\n"
+              << "  --jobs N               병렬 작업 수 (기본 코어 수)\n"
+              << "  --check-jobs           SAD 기록을 순차(jobs=1)로 한 번 더 돌려 병렬 결과와 같은지 확인\n"
+              << "  --csv FILE             전체 결과를 CSV로 저장\n"
+              << std::endl;
+}
+
+template <typename T>
+static bool parseList(const std::string& spec, std::vector<T>& out) {
+    out.clear();
+    double a, b, step;
+    if (std::count(spec.begin(), spec.end(), ':') == 2 &&
+        sscanf(spec.c_str(), "%lf:%lf:%lf", &a, &b, &step) == 3 && step > 0) {
+        for (int k = 0; a + k * step <= b + step * 1e-6; k++) {
+            out.push_back(static_cast<T>(a + k * step));
+        }
+        return !out.empty();
+    }
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        out.push_back(static_cast<T>(std::atof(item.c_str())));
+    }
+    return !out.empty();
+}
+
+static bool parseRoiPoints(const std::string& spec, std::vector<cv::Point>& points) {
+    std::stringstream ss(spec);
+    std::string pair;
+    while (std::getline(ss, pair, ';')) {
+        int x, y;
+        if (sscanf(pair.c_str(), "%d,%d", &x, &y) != 2) return false;
+        points.push_back(cv::Point(x, y));
+    }
+    return points.size() > 2;
+}
+
+static bool parseArgs(int argc, char* argv[], SweepOptions& opt) {
+    parseList("0.1:0.9:0.05", opt.ratios);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--scenes" && hasValue) opt.scenes = std::atoi(argv[++i]);
+        else if (arg == "--frames" && hasValue) opt.frames = std::atoi(argv[++i]);
+        else if (arg == "--width" && hasValue) opt.scene.width = std::atoi(argv[++i]);
+        else if (arg == "--height" && hasValue) opt.scene.height = std::atoi(argv[++i]);
+        else if (arg == "--fps" && hasValue) opt.scene.fps = std::atof(argv[++i]);
+        else if (arg == "--interval" && hasValue) opt.scene.spawnInterval = std::atof(argv[++i]);
+        else if (arg == "--noise" && hasValue) opt.scene.noiseSigma = std::atof(argv[++i]);
+        else if (arg == "--drift" && hasValue) opt.scene.driftAmplitude = std::atof(argv[++i]);
+        else if (arg == "--light-step" && hasValue) opt.scene.lightStep = std::atof(argv[++i]);
+        else if (arg == "--sequence" && hasValue) opt.sequences.push_back(argv[++i]);
+        else if (arg == "--roi" && hasValue) opt.roiSpec = argv[++i];
+        else if (arg == "--seq-fps" && hasValue) opt.sequenceFps = std::atof(argv[++i]);
+        else if (arg == "--blur" && hasValue) ok = parseList(argv[++i], opt.blurs);
+        else if (arg == "--ratios" && hasValue) ok = parseList(argv[++i], opt.ratios);
+        else if (arg == "--thresholds" && hasValue) ok = parseList(argv[++i], opt.thresholds);
+        else if (arg == "--presence" && hasValue) ok = parseList(argv[++i], opt.presenceMs);
+        else if (arg == "--hold" && hasValue) ok = parseList(argv[++i], opt.holdMs);
+        else if (arg == "--release" && hasValue) opt.releaseRatio = std::atof(argv[++i]);
+        else if (arg == "--no-illum") opt.illumination = false;
+        else if (arg == "--jobs" && hasValue) opt.jobs = std::atoi(argv[++i]);
+        else if (arg == "--check-jobs") opt.checkJobs = true;
+        else if (arg == "--csv" && hasValue) opt.csvPath = argv[++i];
+        else {
+            printUsage(argv[0]);
+            return false;
+        }
+        if (!ok) {
+            std::cerr << "오류: 목록 형식이 잘못되었습니다: " << arg << " " << argv[i] << std::endl;
+            return false;
+        }
+    }
+    if (opt.jobs <= 0) opt.jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int& b : opt.blurs) b = std::max(1, b | 1);   // 블러 크기는 홀수
+    return opt.scenes >= 0 && opt.frames > 0;
+}
+
+/*
+ * 0..count-1 작업을 jobs개 스레드가 나눠 처리 (호출 스레드도 참여)
+ */
+template <typename F>
+static void parallelFor(int count, int jobs, F fn) {
+    std::atomic<int> next{0};
+    auto worker = [&]() {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (int j = 1; j < std::min(jobs, count); j++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+static bool isRecordingPath(const std::string& path) {
+    return path.size() > 5 && path.compare(path.size() - 5, 5, ".frec") == 0;
+}
+
+/*
+ * 원본 녹화의 정답 마커 → 정답 구간 (첫 프레임 기준 시각)
+ */
+static std::vector<GroundTruthInterval> truthFromMarkers(const record::FrameRecordReader& rec) {
+    std::vector<GroundTruthInterval> truth;
+    const int64_t originNs = rec.timestampNs(0);
+    for (const auto& m : rec.markers()) {
+        if (m.type == record::MARK_TRUTH_ENTER) {
+            truth.push_back(GroundTruthInterval{static_cast<int>(truth.size()), m.timestampNs - originNs, -1});
+        } else if (m.type == record::MARK_TRUTH_EXIT && !truth.empty() && truth.back().exitNs < 0) {
+            truth.back().exitNs = m.timestampNs - originNs;
+        }
+    }
+    return truth;
+}
+
+static bool buildSequences(const SweepOptions& opt, std::vector<Sequence>& out) {
+    for (int k = 0; k < opt.scenes; k++) {
+        Sequence seq;
+        seq.name = "synthetic#" + std::to_string(k);
+        seq.scene = opt.scene;
+        seq.scene.seed = opt.scene.seed + k;
+        seq.frames = opt.frames;
+        seq.fps = opt.scene.fps;
+        out.push_back(seq);
+    }
+
+    std::vector<cv::Point> roi;
+    if (!opt.roiSpec.empty() && !parseRoiPoints(opt.roiSpec, roi)) {
+        std::cerr << "오류: ROI 형식이 잘못되었습니다: " << opt.roiSpec << std::endl;
+        return false;
+    }
+    for (const auto& spec : opt.sequences) {
+        size_t comma = spec.rfind(',');
+        Sequence seq;
+        seq.name = comma == std::string::npos ? spec : spec.substr(0, comma);
+        seq.synthetic = false;
+        seq.videoPath = seq.name;
+        seq.roi = roi;
+
+        // 원본 녹화 - 헤더의 fps / ROI, 라벨이 없으면 정답 마커
+        if (isRecordingPath(seq.videoPath)) {
+            record::FrameRecordReader rec;
+            if (!rec.open(seq.videoPath)) return false;
+            if (rec.frameCount() == 0) {
+                std::cerr << "오류: 녹화된 프레임이 없습니다: " << seq.videoPath << std::endl;
+                return false;
+            }
+            seq.recording = true;
+            seq.fps = rec.fps() > 0 ? rec.fps() : 30.0;
+            if (seq.roi.empty()) seq.roi = rec.roi();
+            if (comma != std::string::npos) {
+                if (!DetectionEval::loadLabels(spec.substr(comma + 1), seq.truth)) return false;
+            } else {
+                seq.truth = truthFromMarkers(rec);
+            }
+            if (seq.roi.size() < 3 || seq.truth.empty()) {
+                std::cerr << "오류: " << seq.videoPath << ": "
+                          << (seq.roi.size() < 3 ? "ROI가 없습니다 (--roi 지정)" : "정답 마커가 없습니다 (라벨 CSV 지정)")
+                          << std::endl;
+                return false;
+            }
+            out.push_back(seq);
+            continue;
+        }
+
+        if (comma == std::string::npos) {
+            std::cerr << "오류: --sequence 형식은 VIDEO,LABELS 입니다: " << spec << std::endl;
+            return false;
+        }
+        if (roi.empty()) {
+            std::cerr << "오류: 녹화 영상 시퀀스에는 --roi가 필요합니다." << std::endl;
+            return false;
+        }
+        if (!DetectionEval::loadLabels(spec.substr(comma + 1), seq.truth)) return false;
+
+        cv::VideoCapture cap(seq.videoPath);
+        if (!cap.isOpened()) {
+            std::cerr << "오류: 영상을 열 수 없습니다: " << seq.videoPath << std::endl;
+            return false;
+        }
+        seq.fps = opt.sequenceFps > 0 ? opt.sequenceFps : cap.get(cv::CAP_PROP_FPS);
+        if (seq.fps <= 0) seq.fps = 30.0;
+        out.push_back(seq);
+    }
+
+    if (out.empty()) {
+        std::cerr << "오류: 평가할 시퀀스가 없습니다." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * 1단계: 시퀀스 하나를 블러 크기 하나로 처리해 프레임별 SAD 기록
+ */
+static SadTrace recordSad(const Sequence& seq, int blur, const SweepOptions& opt) {
+    SadTrace trace;
+
+    DetectorConfig cfg;
+    cfg.blurSize = blur;
+    cfg.threads = 1;                 // 병렬화는 설정 단위로
+    cfg.illuminationCompensation = opt.illumination;
+
+    auto feedFrame = [&](DetectionEngine& engine, const cv::Mat& frame, int64_t ts) {
+        trace.kernel = engine.kernelName();
+        auto t0 = std::chrono::steady_clock::now();
+        FrameResult r = engine.feed(frame, ts);
+        trace.engineSec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (r.detecting) {
+            trace.sad.push_back(r.sad);
+            trace.timestampNs.push_back(ts);
+            trace.frameIndex.push_back(engine.frameCount());
+        }
+    };
+
+    if (seq.synthetic) {
+        SyntheticScene scene(seq.scene);
+        std::vector<cv::Point> roi = scene.suggestedRoi();
+        scene.trackRoi(cv::boundingRect(roi));
+        cfg.width = seq.scene.width;
+        cfg.height = seq.scene.height;
+
+        DetectionEngine engine(cfg);
+        engine.setRoi(roi);
+        cv::Mat frame;
+        for (int i = 0; i < seq.frames; i++) {
+            int64_t ts = scene.render(frame);
+            feedFrame(engine, frame, ts);
+        }
+        trace.truth = scene.groundTruth();
+        trace.mediaSec = seq.frames / seq.fps;
+    } else if (seq.recording) {
+        // mmap한 원본 프레임을 그대로 넣음 (디코딩 없음), 시각은 기록된 캡처 시각
+        record::FrameRecordReader rec;
+        if (!rec.open(seq.videoPath) || rec.frameCount() == 0) return trace;
+        cfg.width = rec.width();
+        cfg.height = rec.height();
+
+        DetectionEngine engine(cfg);
+        engine.setRoi(seq.roi);
+        const int64_t originNs = rec.timestampNs(0);
+        for (size_t i = 0; i < rec.frameCount(); i++) {
+            feedFrame(engine, rec.frame(i), rec.timestampNs(i) - originNs);
+        }
+        trace.truth = seq.truth;
+        trace.mediaSec = (rec.timestampNs(rec.frameCount() - 1) - originNs) / 1e9 + 1.0 / seq.fps;
+    } else {
+        cv::VideoCapture cap(seq.videoPath);
+        cv::Mat frame;
+        if (!cap.isOpened() || !cap.read(frame) || frame.empty()) return trace;
+        cfg.width = frame.cols;
+        cfg.height = frame.rows;
+
+        DetectionEngine engine(cfg);
+        engine.setRoi(seq.roi);
+        int64_t index = 0;
+        do {
+            int64_t ts = static_cast<int64_t>(index * 1e9 / seq.fps);
+            feedFrame(engine, frame, ts);
+            index++;
+        } while (cap.read(frame) && !frame.empty());
+        trace.truth = seq.truth;
+        trace.mediaSec = index / seq.fps;
+    }
+
+    // 병이 ROI에 있던 프레임의 SAD
+    size_t g = 0;
+    for (size_t k = 0; k < trace.sad.size(); k++) {
+        int64_t ts = trace.timestampNs[k];
+        while (g < trace.truth.size() && trace.truth[g].exitNs >= 0 && trace.truth[g].exitNs <= ts) g++;
+        if (g < trace.truth.size() && ts >= trace.truth[g].enterNs) trace.bottleSad.push_back(trace.sad[k]);
+    }
+    trace.ok = true;
+    return trace;
+}
+
+/*
+ * 병렬 기록과 순차 기록이 같은지 비교 (SAD / 시각 / 프레임 번호가 모두 같아야 함)
+ * - 반환값: 다른 트레이스 수
+ */
+static int compareTraces(const std::vector<SadTrace>& parallel, const std::vector<SadTrace>& serial,
+                         const std::vector<Sequence>& sequences, const std::vector<int>& blurs) {
+    const int nBlur = static_cast<int>(blurs.size());
+    int mismatches = 0;
+    for (size_t i = 0; i < parallel.size(); i++) {
+        const SadTrace& a = parallel[i];
+        const SadTrace& b = serial[i];
+        bool same = a.ok == b.ok && a.sad == b.sad && a.timestampNs == b.timestampNs && a.frameIndex == b.frameIndex;
+        if (!same) mismatches++;
+        std::cout << "  " << sequences[i / nBlur].name << " 블러 " << blurs[i % nBlur] << " (" << a.kernel << "): "
+                  << (same ? "같음" : "다름") << ", SAD " << a.sad.size() << "개" << std::endl;
+    }
+    return mismatches;
+}
+
+/*
+ * 2단계: 기록된 SAD를 상태 머신에 다시 넣어 Enter 이벤트 시각만 모음
+ */
+static void replay(const SadTrace& trace, double threshold, const PresenceConfig& pc,
+                   std::vector<DetectionEvent>& events, std::vector<int64_t>& enterNs) {
+    PresenceTracker tracker(0, pc);
+    events.clear();
+    enterNs.clear();
+    for (size_t k = 0; k < trace.sad.size(); k++) {
+        tracker.update(trace.sad[k], threshold, trace.frameIndex[k], trace.timestampNs[k], events);
+        for (const auto& ev : events) {
+            if (ev.type == DetectionEventType::Enter) enterNs.push_back(ev.timestampNs);
+        }
+        events.clear();
+    }
+}
+
+static double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + mid, v.end());
+    return v[mid];
+}
+
+// robust F1 → F1 → 평균 지연 → 디바운스가 넉넉한 쪽 순서로 좋은 설정
+static bool better(const SweepResult& a, const SweepResult& b) {
+    if (a.robustF1 != b.robustF1) return a.robustF1 > b.robustF1;
+    double fa = a.score.f1(), fb = b.score.f1();
+    if (fa != fb) return fa > fb;
+    double la = a.score.meanLatencyMs(), lb = b.score.meanLatencyMs();
+    if (la != lb) return la < lb;
+    return a.presenceMs + a.holdMs > b.presenceMs + b.holdMs;
+}
+
+static void printRow(const SweepResult& r) {
+    std::cout << std::fixed
+              << "  " << std::setw(5) << std::setprecision(2) << r.ratio
+              << std::setw(10) << std::setprecision(0) << r.threshold
+              << std::setw(7) << std::setprecision(3) << r.score.precision()
+              << std::setw(7) << r.score.recall()
+              << std::setw(7) << r.score.f1()
+              << std::setw(8) << std::setprecision(1) << r.score.meanLatencyMs()
+              << std::setw(8) << r.score.latencyPercentileMs(0.9)
+              << std::setw(6) << r.score.misses
+              << std::setw(6) << r.score.falseAlarms << std::endl;
+}
+
+static bool writeCsv(const std::string& path, const std::vector<SweepResult>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "CSV 파일을 열 수 없습니다: " << path << std::endl;
+        return false;
+    }
+    out << "blur,ratio,threshold,min_presence_ms,release_hold_ms,truth,detections,hits,misses,false_alarms,"
+           "precision,recall,f1,robust_f1,latency_mean_ms,latency_p90_ms\n";
+    for (const auto& r : results) {
+        out << r.blur << ',' << r.ratio << ',' << r.threshold << ',' << r.presenceMs << ',' << r.holdMs << ','
+            << r.score.truth << ',' << r.score.detections << ',' << r.score.hits << ','
+            << r.score.misses << ',' << r.score.falseAlarms << ','
+            << r.score.precision() << ',' << r.score.recall() << ',' << r.score.f1() << ',' << r.robustF1 << ','
+            << r.score.meanLatencyMs() << ',' << r.score.latencyPercentileMs(0.9) << '\n';
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SweepOptions opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    std::vector<Sequence> sequences;
+    if (!buildSequences(opt, sequences)) return 2;
+
+    const int nSeq = static_cast<int>(sequences.size());
+    const int nBlur = static_cast<int>(opt.blurs.size());
+    const bool absolute = !opt.thresholds.empty();
+    const std::vector<double>& levels = absolute ? opt.thresholds : opt.ratios;
+    const int nConfig = nBlur * static_cast<int>(levels.size() * opt.presenceMs.size() * opt.holdMs.size());
+
+    std::cout << "=== 감지 파라미터 스윕 ===" << std::endl;
+    std::cout << "시퀀스: " << nSeq << "개 | 블러 " << nBlur << " x 임계값 " << levels.size()
+              << " x 최소 유지 " << opt.presenceMs.size() << " x 해제 확정 " << opt.holdMs.size()
+              << " = 설정 " << nConfig << "개 | 병렬 작업: " << opt.jobs << std::endl;
+
+    // 1단계: 시퀀스 × 블러마다 SAD 기록
+    auto sweepStart = std::chrono::steady_clock::now();
+    std::vector<SadTrace> traces(nSeq * nBlur);
+    parallelFor(static_cast<int>(traces.size()), opt.jobs, [&](int i) {
+        traces[i] = recordSad(sequences[i / nBlur], opt.blurs[i % nBlur], opt);
+    });
+    auto recordEnd = std::chrono::steady_clock::now();
+
+    if (opt.checkJobs) {
+        std::cout << "\n[병렬 결과 확인] 병렬 작업 " << opt.jobs << "개 vs 순차" << std::endl;
+        std::vector<SadTrace> serial(traces.size());
+        parallelFor(static_cast<int>(serial.size()), 1, [&](int i) {
+            serial[i] = recordSad(sequences[i / nBlur], opt.blurs[i % nBlur], opt);
+        });
+        int mismatches = compareTraces(traces, serial, sequences, opt.blurs);
+        if (mismatches > 0) {
+            std::cerr << "오류: 병렬 처리 결과가 순차 처리와 다릅니다 (" << mismatches << "개)" << std::endl;
+            return 1;
+        }
+    }
+
+    double mediaSec = 0.0;
+    double slowest = 1e300;   // 가장 느린 처리의 실시간 대비 배율
+    for (int s = 0; s < nSeq; s++) {
+        const SadTrace& first = traces[s * nBlur];
+        if (!first.ok) {
+            std::cerr << "오류: 시퀀스를 처리하지 못했습니다: " << sequences[s].name << std::endl;
+            return 1;
+        }
+        mediaSec += first.mediaSec;
+        for (int b = 0; b < nBlur; b++) {
+            const SadTrace& t = traces[s * nBlur + b];
+            if (t.engineSec > 0) slowest = std::min(slowest, t.mediaSec / t.engineSec);
+        }
+        std::cout << "  " << sequences[s].name << ": " << std::fixed << std::setprecision(1)
+                  << first.mediaSec << "초, 정답 병 " << first.truth.size() << "개" << std::endl;
+    }
+
+    // 블러 크기별 기준 SAD (병이 ROI에 있던 프레임의 중앙값, 전체 시퀀스 합산)
+    std::vector<double> refSad(nBlur, 0.0);
+    for (int b = 0; b < nBlur; b++) {
+        std::vector<double> all;
+        for (int s = 0; s < nSeq; s++) {
+            const auto& v = traces[s * nBlur + b].bottleSad;
+            all.insert(all.end(), v.begin(), v.end());
+        }
+        refSad[b] = median(all);
+        if (!absolute && refSad[b] <= 0) {
+            std::cerr << "오류: 블러 " << opt.blurs[b] << "에서 정답 구간 SAD가 없습니다 (--thresholds 사용)" << std::endl;
+            return 1;
+        }
+    }
+
+    // 2단계: 설정마다 상태 머신 재생 후 평가
+    auto replayStart = std::chrono::steady_clock::now();
+    std::vector<SweepResult> results(nConfig);
+    const int nLevel = static_cast<int>(levels.size());
+    const int nPresence = static_cast<int>(opt.presenceMs.size());
+    const int nHold = static_cast<int>(opt.holdMs.size());
+    parallelFor(nConfig, opt.jobs, [&](int i) {
+        int h = i % nHold;
+        int p = (i / nHold) % nPresence;
+        int l = (i / (nHold * nPresence)) % nLevel;
+        int b = i / (nHold * nPresence * nLevel);
+
+        SweepResult& r = results[i];
+        r.blur = opt.blurs[b];
+        r.presenceMs = opt.presenceMs[p];
+        r.holdMs = opt.holdMs[h];
+        r.threshold = absolute ? levels[l] : levels[l] * refSad[b];
+        r.ratio = refSad[b] > 0 ? r.threshold / refSad[b] : 0.0;
+
+        PresenceConfig pc{r.presenceMs * 1000000LL, r.holdMs * 1000000LL, 0, opt.releaseRatio};
+        std::vector<DetectionEvent> events;
+        std::vector<int64_t> enterNs;
+        for (int s = 0; s < nSeq; s++) {
+            const SadTrace& t = traces[s * nBlur + b];
+            replay(t, r.threshold, pc, events, enterNs);
+            r.score.merge(DetectionEval::match(t.truth, enterNs));
+        }
+    });
+    auto sweepEnd = std::chrono::steady_clock::now();
+
+    // 임계값 이웃(같은 블러/디바운스)과 비교한 robust F1
+    const int levelStride = nPresence * nHold;
+    for (int i = 0; i < nConfig; i++) {
+        int l = (i / levelStride) % nLevel;
+        double f = results[i].score.f1();
+        if (l > 0) f = std::min(f, results[i - levelStride].score.f1());
+        if (l + 1 < nLevel) f = std::min(f, results[i + levelStride].score.f1());
+        results[i].robustF1 = f;
+    }
+
+    double recordSec = std::chrono::duration<double>(recordEnd - sweepStart).count();
+    double replaySec = std::chrono::duration<double>(sweepEnd - replayStart).count();
+    std::cout << std::fixed << std::setprecision(1)
+              << "\n[처리 시간] SAD 기록 " << recordSec << "초 + 설정 평가 " << std::setprecision(2) << replaySec
+              << "초 (시퀀스 합계 " << std::setprecision(1) << mediaSec << "초)" << std::endl;
+    std::cout << "  설정 하나의 감지 엔진 처리: 실시간 대비 최소 x" << slowest
+              << " | 설정당 평가: " << std::setprecision(3) << (replaySec * opt.jobs / nConfig * 1000.0) << " ms" << std::endl;
+    if (slowest < 1.0) {
+        std::cout << "  경고: 실시간보다 느린 처리가 있습니다." << std::endl;
+    }
+
+    // 블러 크기마다 가장 좋은 디바운스 조합의 임계값 곡선
+    const char* header = "  비율    임계값   정밀도 재현율    F1  지연avg  지연p90  놓침 오검출";
+    for (int b = 0; b < nBlur; b++) {
+        auto begin = results.begin() + b * nLevel * nPresence * nHold;
+        auto end = begin + nLevel * nPresence * nHold;
+        auto best = std::min_element(begin, end, better);
+
+        std::cout << "\n[블러 " << opt.blurs[b] << "] 기준 SAD " << std::setprecision(0) << refSad[b]
+                  << " | 최소 유지 " << best->presenceMs << "ms, 해제 확정 " << best->holdMs << "ms" << std::endl;
+        std::cout << header << std::endl;
+        for (auto it = begin; it != end; ++it) {
+            if (it->presenceMs == best->presenceMs && it->holdMs == best->holdMs) printRow(*it);
+        }
+    }
+
+    // 전체 최적 동작점
+    auto best = std::min_element(results.begin(), results.end(), better);
+    std::cout << "\n[최적 동작점]" << std::endl;
+    std::cout << "  블러 " << best->blur << " | 임계값 " << std::setprecision(0) << best->threshold
+              << " (기준 SAD의 " << std::setprecision(2) << best->ratio << "배)"
+              << " | 최소 유지 " << best->presenceMs << "ms | 해제 확정 " << best->holdMs << "ms" << std::endl;
+    std::cout << std::setprecision(3) << "  정밀도 " << best->score.precision() << " | 재현율 " << best->score.recall()
+              << " | F1 " << best->score.f1() << std::setprecision(1)
+              << " | 지연 평균 " << best->score.meanLatencyMs() << "ms, p90 " << best->score.latencyPercentileMs(0.9) << "ms"
+              << " | 놓침 " << best->score.misses << " | 오검출 " << best->score.falseAlarms << std::endl;
+    std::cout << "  적용: detect_ROI --min-presence-ms " << best->presenceMs << " --release-hold-ms " << best->holdMs
+              << " (실행 중 임계값 " << std::setprecision(0) << best->threshold << " 입력, BLUR_SIZE " << best->blur << ")"
+              << std::endl;
+
+    if (!opt.csvPath.empty() && writeCsv(opt.csvPath, results)) {
+        std::cout << "\n전체 결과 저장: " << opt.csvPath << " (" << results.size() << "행)" << std::endl;
+    }
+    return 0;
+}
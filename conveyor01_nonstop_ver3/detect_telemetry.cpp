@@ -0,0 +1,130 @@
+#include "telemetry_shm.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <signal.h>
+
+/*
+ * 감지기 텔레메트리 확인 도구
+ * - 공유 메모리를 읽기 전용으로 매핑해 주기적으로 출력 (감지기 프레임 루프에 영향 없음)
+ */
+
+static volatile sig_atomic_t g_running = 1;
+
+static void signalHandler(int) {
+    g_running = 0;
+}
+
+static void printUsage(const char* prog) {
+    std::cout << "사용법: " << prog << " [옵션]\n"
+              << "  --name NAME     공유 메모리 이름 (기본 " << telemetry::kDefaultShmName << ")\n"
+              << "  --interval MS   출력 주기 (기본 500ms)\n"
+              << "  --once          한 번만 출력하고 종료\n"
+              << std::endl;
+}
+
+static void printSnapshot(const telemetry::TelemetryData& d, uint64_t& lastEventCount) {
+    static const char* stageNames[telemetry::STAGE_COUNT] = { "대기", "처리", "전체" };
+
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    double ageMs = (std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - d.updatedNs) / 1e6;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "[" << d.width << "x" << d.height << " " << d.threads << "스레드] "
+              << "프레임 " << d.frameCount << " | FPS " << d.fps
+              << " | SAD " << std::setprecision(0) << d.currentSad << " / " << d.threshold
+              << " (평균 " << d.averageSad << ")"
+              << std::setprecision(2) << " | 조명 x" << d.illumGain << std::showpos << d.illumOffset << std::noshowpos
+              << " | 병 " << (d.bottlePresent ? "YES" : "NO")
+              << (d.detecting ? "" : " (감지 대기)")
+              << " | 갱신 " << std::setprecision(0) << ageMs << "ms 전" << std::endl;
+
+    std::cout << std::setprecision(0);
+    for (uint32_t s = 0; s < telemetry::STAGE_COUNT; s++) {
+        const auto& st = d.stages[s];
+        std::cout << "  " << stageNames[s] << ": p50 " << st.p50Us << "us  p90 " << st.p90Us
+                  << "us  p99 " << st.p99Us << "us  max " << st.maxUs << "us" << std::endl;
+    }
+    const auto& loss = d.frameLoss;
+    const auto& rate = d.frameLossRates;
+    std::cout << "  프레임 손실: 카메라 " << loss.sourceDropped << " | 슬롯 " << loss.slotSkipped
+              << " | 지연 " << loss.late << " | 읽기 실패 " << loss.readFailures
+              << " | 거부 " << d.rejectedFrames << " | 이벤트 " << d.eventCount << std::endl;
+    std::cout << std::setprecision(2)
+              << "  최근 " << std::setprecision(0) << rate.windowSec << "초: " << std::setprecision(2)
+              << "손실 " << rate.lossRatio * 100.0 << "% (카메라 " << rate.sourceDropRatio * 100.0
+              << "%, 슬롯 " << rate.slotSkipRatio * 100.0 << "%) | 지연 " << rate.lateRatio * 100.0
+              << "% | 읽기 실패 " << std::setprecision(1) << rate.readFailuresPerMin << "/분" << std::endl;
+
+    for (uint32_t r = 0; r < std::min<uint32_t>(d.roiCount, telemetry::kMaxRois); r++) {
+        const auto& m = d.roiMetrics[r];
+        std::cout << std::setprecision(1)
+                  << "  ROI " << m.roiId << ": 누적 " << m.totalCount << "병 | 교대 " << m.shiftCount
+                  << "병 | 분당 1분 " << m.perMinute1m << " / 15분 " << m.perMinute15m
+                  << " / 교대 " << m.perMinuteShift
+                  << " | 간격 평균 " << std::setprecision(0) << m.gapMeanMs << "ms"
+                  << " | 체류 평균 " << m.dwellMeanMs << "ms"
+                  << " | 불량 " << m.shiftRejects << " (" << std::setprecision(1)
+                  << m.rejectRatioShift * 100.0 << "%)" << std::endl;
+    }
+    std::cout << std::setprecision(0);
+
+    // 새 이벤트만 출력 (링 버퍼에 남아 있는 범위 안에서)
+    uint64_t first = std::max<uint64_t>(lastEventCount, d.eventCount > telemetry::kMaxEvents
+                                                        ? d.eventCount - telemetry::kMaxEvents : 0);
+    for (uint64_t i = first; i < d.eventCount; i++) {
+        const auto& ev = d.events[i % telemetry::kMaxEvents];
+        std::cout << "  > ROI " << ev.roiId << " " << (ev.type == telemetry::EVENT_ENTER ? "병 감지" : "병 통과")
+                  << " 프레임 " << ev.frameIndex << " SAD " << ev.sad << " / " << ev.threshold;
+        if (ev.durationNs >= 0) {
+            std::cout << (ev.type == telemetry::EVENT_ENTER ? " 간격 " : " 머문 시간 ")
+                      << ev.durationNs / 1000000 << "ms";
+        }
+        std::cout << std::endl;
+    }
+    lastEventCount = d.eventCount;
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = telemetry::kDefaultShmName;
+    int intervalMs = 500;
+    bool once = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) name = argv[++i];
+        else if (arg == "--interval" && i + 1 < argc) intervalMs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--once") once = true;
+        else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    telemetry::TelemetryReader reader;
+    if (!reader.open(name)) {
+        std::cerr << "오류: " << reader.error() << std::endl;
+        return 1;
+    }
+    std::cout << "감지기 PID " << reader.writerPid() << " 텔레메트리 연결" << std::endl;
+
+    telemetry::TelemetryData data;
+    uint64_t lastEventCount = 0;
+    while (g_running) {
+        if (reader.read(data)) {
+            printSnapshot(data, lastEventCount);
+        } else {
+            std::cerr << "스냅샷 읽기 실패 (갱신 중)" << std::endl;
+        }
+        if (once) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+    return 0;
+}
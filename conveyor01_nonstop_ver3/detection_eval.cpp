@@ -0,0 +1,91 @@
+#include "detection_eval.hpp"
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+double DetectionScore::f1() const {
+    double p = precision();
+    double r = recall();
+    return p + r > 0.0 ? 2.0 * p * r / (p + r) : 0.0;
+}
+
+double DetectionScore::meanLatencyMs() const {
+    if (latenciesMs.empty()) return 0.0;
+    double sum = 0.0;
+    for (double v : latenciesMs) sum += v;
+    return sum / latenciesMs.size();
+}
+
+double DetectionScore::latencyPercentileMs(double p) const {
+    if (latenciesMs.empty()) return 0.0;
+    std::vector<double> v = latenciesMs;
+    size_t idx = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+void DetectionScore::merge(const DetectionScore& other) {
+    truth += other.truth;
+    detections += other.detections;
+    hits += other.hits;
+    misses += other.misses;
+    falseAlarms += other.falseAlarms;
+    latenciesMs.insert(latenciesMs.end(), other.latenciesMs.begin(), other.latenciesMs.end());
+}
+
+DetectionScore DetectionEval::match(const std::vector<GroundTruthInterval>& truth,
+                                    const std::vector<int64_t>& enterNs,
+                                    int64_t slackNs) {
+    DetectionScore score;
+    score.truth = static_cast<int>(truth.size());
+    score.detections = static_cast<int>(enterNs.size());
+
+    std::vector<bool> used(enterNs.size(), false);
+    for (const auto& gt : truth) {
+        int64_t end = gt.exitNs < 0 ? INT64_MAX : gt.exitNs + slackNs;
+        for (size_t k = 0; k < enterNs.size(); k++) {
+            if (!used[k] && enterNs[k] >= gt.enterNs && enterNs[k] <= end) {
+                used[k] = true;
+                score.hits++;
+                score.latenciesMs.push_back((enterNs[k] - gt.enterNs) / 1e6);
+                break;
+            }
+        }
+    }
+    score.falseAlarms = static_cast<int>(std::count(used.begin(), used.end(), false));
+    score.misses = score.truth - score.hits;
+    return score;
+}
+
+bool DetectionEval::loadLabels(const std::string& path, std::vector<GroundTruthInterval>& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "정답 파일을 열 수 없습니다: " << path << std::endl;
+        return false;
+    }
+
+    out.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream ss(line);
+        double enterMs = 0.0, exitMs = 0.0;
+        if (!(ss >> enterMs >> exitMs)) continue;  // 머리글 등
+
+        GroundTruthInterval gt;
+        gt.bottleId = static_cast<int>(out.size());
+        gt.enterNs = static_cast<int64_t>(enterMs * 1e6);
+        gt.exitNs = exitMs < 0 ? -1 : static_cast<int64_t>(exitMs * 1e6);
+        out.push_back(gt);
+    }
+
+    std::sort(out.begin(), out.end(), [](const GroundTruthInterval& a, const GroundTruthInterval& b) {
+        return a.enterNs < b.enterNs;
+    });
+    return true;
+}
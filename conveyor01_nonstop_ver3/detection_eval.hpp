@@ -0,0 +1,57 @@
+#ifndef DETECTION_EVAL_HPP
+#define DETECTION_EVAL_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "synthetic_scene.hpp"
+
+/*
+ * 정답 구간 대비 감지 정확도
+ * - hits: 정답 구간과 짝지어진 Enter 이벤트 수
+ * - falseAlarms: 어느 정답과도 짝지어지지 않은 Enter 이벤트 수
+ * - latenciesMs: 적중마다 정답 ROI 진입 시각 → 감지 이벤트 시각
+ * - 여러 시퀀스 결과는 merge()로 합산
+ */
+struct DetectionScore {
+    int truth = 0;
+    int detections = 0;
+    int hits = 0;
+    int misses = 0;
+    int falseAlarms = 0;
+    std::vector<double> latenciesMs;
+
+    double precision() const { return detections > 0 ? static_cast<double>(hits) / detections : 0.0; }
+    double recall() const { return truth > 0 ? static_cast<double>(hits) / truth : 0.0; }
+    double f1() const;
+    double meanLatencyMs() const;
+    double latencyPercentileMs(double p) const;
+
+    void merge(const DetectionScore& other);
+};
+
+/*
+ * 감지 결과 평가 유틸리티 (벤치마크 / 파라미터 스윕 공용)
+ */
+class DetectionEval {
+public:
+    // 정답 구간 종료 후에도 이 시간 안의 감지는 적중으로 인정
+    static constexpr int64_t kDefaultSlackNs = 500000000LL;
+
+    /*
+     * 정답 구간마다 그 안(종료 후 slack 여유)에서 아직 짝이 없는 가장 이른 Enter를 적중으로 처리
+     * - enterNs: 시간 순서의 Enter 이벤트 시각
+     */
+    static DetectionScore match(const std::vector<GroundTruthInterval>& truth,
+                                const std::vector<int64_t>& enterNs,
+                                int64_t slackNs = kDefaultSlackNs);
+
+    /*
+     * 녹화 시퀀스 정답 파일 읽기 (CSV: enter_ms,exit_ms - 영상 시작 기준)
+     * - '#' 주석 / 빈 줄 / 숫자가 아닌 머리글 줄은 건너뜀
+     * - exit_ms가 음수면 영상 끝까지 ROI 안에 있던 병
+     */
+    static bool loadLabels(const std::string& path, std::vector<GroundTruthInterval>& out);
+};
+
+#endif
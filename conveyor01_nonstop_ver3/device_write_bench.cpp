@@ -0,0 +1,117 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+/*
+ * MQTT 브리지 → 디바이스 파일 명령 전송 벤치마크 (초당 명령 수)
+ * - ofstream: 예전 브리지 방식 (명령마다 ofstream 열기 → "cmd" << endl → 닫기)
+ * - fd 유지: 지금 브리지 방식 (한 번 연 fd에 "cmd\n"을 write() 한 번으로 전송)
+ * - 실제 장치에 보내면 명령이 그대로 실행되므로 --cmd는 안전한 명령(off 등)으로 지정할 것
+ *   (장치 없이 시스템 콜 비용만 보려면 --device /dev/null)
+ */
+
+struct BenchOptions {
+    std::string device = "/dev/conveyor_mqtt";
+    std::string cmd = "off";
+    int count = 10000;
+};
+
+static void printUsage(const char* prog) {
+    std::cout << "사용법: " << prog << " [옵션]\n"
+              << "  --device PATH          디바이스 파일 (기본 /dev/conveyor_mqtt)\n"
+              << "  --cmd STR              보낼 명령 (기본 off)\n"
+              << "  --count N              방식별 전송 횟수 (기본 10000)\n"
+              << std::endl;
+}
+
+static bool parseArgs(int argc, char* argv[], BenchOptions& opt) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--device" && hasValue) opt.device = argv[++i];
+        else if (arg == "--cmd" && hasValue) opt.cmd = argv[++i];
+        else if (arg == "--count" && hasValue) opt.count = std::atoi(argv[++i]);
+        else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    return opt.count > 0;
+}
+
+static double nowSec() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// 예전 방식: 명령마다 열고 닫기
+static int runOfstream(const BenchOptions& opt) {
+    for (int i = 0; i < opt.count; i++) {
+        std::ofstream dev(opt.device);
+        if (!dev.is_open()) return i;
+        dev << opt.cmd << std::endl;
+        dev.close();
+    }
+    return opt.count;
+}
+
+// 지금 방식: fd 하나로 write() 한 번
+static int runPersistentFd(const BenchOptions& opt) {
+    int fd = open(opt.device.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+
+    std::string line = opt.cmd + "\n";
+    int sent = 0;
+    for (; sent < opt.count; sent++) {
+        if (write(fd, line.data(), line.size()) != static_cast<ssize_t>(line.size())) break;
+    }
+    close(fd);
+    return sent;
+}
+
+static void report(const char* name, int sent, double sec) {
+    std::cout << std::left << std::setw(12) << name << std::right
+              << std::setw(10) << sent << " 회"
+              << std::setw(12) << std::fixed << std::setprecision(0) << (sent / sec) << " 명령/s"
+              << std::setw(10) << std::setprecision(2) << (sec * 1e6 / sent) << " us/명령"
+              << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    int probe = open(opt.device.c_str(), O_WRONLY | O_CLOEXEC);
+    if (probe < 0) {
+        std::cerr << "디바이스 파일 열기 실패: " << opt.device << " (" << strerror(errno) << ")" << std::endl;
+        return 1;
+    }
+    close(probe);
+
+    std::cout << "디바이스: " << opt.device << "  명령: \"" << opt.cmd << "\"  횟수: " << opt.count << std::endl;
+
+    double t0 = nowSec();
+    int sentStream = runOfstream(opt);
+    double streamSec = nowSec() - t0;
+
+    t0 = nowSec();
+    int sentFd = runPersistentFd(opt);
+    double fdSec = nowSec() - t0;
+
+    if (sentStream != opt.count || sentFd != opt.count) {
+        std::cerr << "전송 실패 (ofstream " << sentStream << " / fd 유지 " << sentFd << ")" << std::endl;
+        return 1;
+    }
+
+    report("ofstream", sentStream, streamSec);
+    report("fd 유지", sentFd, fdSec);
+    std::cout << "속도 향상: " << std::setprecision(1) << (streamSec / fdSec) << "x" << std::endl;
+    return 0;
+}
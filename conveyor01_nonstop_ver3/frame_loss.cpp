@@ -0,0 +1,54 @@
+#include "frame_loss.hpp"
+#include <algorithm>
+
+namespace {
+const int64_t kSnapshotIntervalNs = 1000000000LL;
+
+double ratio(uint64_t part, uint64_t whole) {
+    return whole > 0 ? static_cast<double>(part) / whole : 0.0;
+}
+}
+
+FrameLossMonitor::FrameLossMonitor(int windowSec)
+    : ring_(static_cast<size_t>(std::max(windowSec, 1)) + 1) {
+}
+
+void FrameLossMonitor::sample(const FrameLossCounters& total, int64_t nowNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latest_.ns = nowNs;
+    latest_.counters = total;
+
+    if (count_ > 0 && nowNs - ring_[head_].ns < kSnapshotIntervalNs) return;
+    head_ = count_ == 0 ? 0 : (head_ + 1) % ring_.size();
+    ring_[head_] = latest_;
+    count_ = std::min(count_ + 1, ring_.size());
+}
+
+FrameLossRates FrameLossMonitor::rates() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FrameLossRates r = {};
+    if (count_ == 0) return r;
+
+    // 링에서 가장 오래된 스냅샷 → 가장 최근 sample() 값
+    const Snapshot& oldest = ring_[(head_ + ring_.size() - count_ + 1) % ring_.size()];
+    const FrameLossCounters& a = oldest.counters;
+    const FrameLossCounters& b = latest_.counters;
+
+    const uint64_t captured = b.captured - a.captured;
+    const uint64_t sourceDropped = b.sourceDropped - a.sourceDropped;
+    const uint64_t slotSkipped = b.slotSkipped - a.slotSkipped;
+    const uint64_t processed = captured > slotSkipped ? captured - slotSkipped : 0;
+
+    r.windowSec = (latest_.ns - oldest.ns) / 1e9;
+    r.sourceDropRatio = ratio(sourceDropped, captured + sourceDropped);
+    r.slotSkipRatio = ratio(slotSkipped, captured);
+    r.lossRatio = ratio(sourceDropped + slotSkipped, captured + sourceDropped);
+    r.lateRatio = ratio(b.late - a.late, processed);
+    r.readFailuresPerMin = r.windowSec > 0 ? (b.readFailures - a.readFailures) * 60.0 / r.windowSec : 0.0;
+    return r;
+}
+
+FrameLossCounters FrameLossMonitor::total() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_.counters;
+}
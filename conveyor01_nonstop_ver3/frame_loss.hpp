@@ -0,0 +1,67 @@
+#ifndef FRAME_LOSS_HPP
+#define FRAME_LOSS_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/*
+ * 프레임 손실 누적 카운터 (고정 크기 - 텔레메트리 공유 메모리에도 그대로 복사)
+ * - captured: 카메라에서 받은 프레임
+ * - sourceDropped: PTS 간격으로 추정한 카메라/appsink 단계 손실 (drop=true max-buffers=1)
+ * - slotSkipped: 감지 루프가 밀려 프레임 슬롯에서 덮어쓴 프레임
+ * - late: 캡처 → 감지 완료가 한 프레임 주기를 넘긴 프레임
+ * - readFailures: 카메라 읽기 실패 (타임아웃 / 스트림 종료)
+ */
+struct FrameLossCounters {
+    uint64_t captured;
+    uint64_t sourceDropped;
+    uint64_t slotSkipped;
+    uint64_t late;
+    uint64_t readFailures;
+};
+
+/*
+ * 최근 구간의 손실 비율 (windowSec 동안의 카운터 증가량 기준)
+ * - sourceDropRatio: sourceDropped / (captured + sourceDropped)
+ * - slotSkipRatio: slotSkipped / captured
+ * - lossRatio: 감지에 도달하지 못한 프레임 비율 (카메라 손실 + 슬롯 덮어쓰기)
+ * - lateRatio: late / 감지한 프레임
+ */
+struct FrameLossRates {
+    double windowSec;
+    double sourceDropRatio;
+    double slotSkipRatio;
+    double lossRatio;
+    double lateRatio;
+    double readFailuresPerMin;
+};
+
+/*
+ * 누적 카운터를 주기적으로 받아 최근 구간 비율을 계산
+ * - sample(): 감지 스레드에서 호출 (1초 간격으로 스냅샷을 링에 보관)
+ * - rates() / total(): 다른 스레드(통계 출력)에서 호출해도 안전
+ */
+class FrameLossMonitor {
+public:
+    explicit FrameLossMonitor(int windowSec = 60);
+
+    void sample(const FrameLossCounters& total, int64_t nowNs);
+
+    FrameLossRates rates() const;
+    FrameLossCounters total() const;
+
+private:
+    struct Snapshot {
+        int64_t ns;
+        FrameLossCounters counters;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Snapshot> ring_;      // 1초 간격 스냅샷 (windowSec + 1개)
+    size_t head_ = 0;                 // 가장 최근 스냅샷 위치
+    size_t count_ = 0;
+    Snapshot latest_ = {};
+};
+
+#endif
@@ -0,0 +1,343 @@
+#include "frame_record.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace record {
+
+namespace {
+const int kChunkCount = 3;   // 채우는 중 1 + 기록 중 1 + 여유 1
+
+uint64_t alignUp(uint64_t v, uint64_t a) {
+    return (v + a - 1) / a * a;
+}
+}
+
+// --- 녹화 ---
+
+FrameRecordWriter::~FrameRecordWriter() {
+    close();
+}
+
+bool FrameRecordWriter::open(const std::string& path, int width, int height, int type, double fps,
+                             size_t chunkBytes) {
+    close();
+
+    if (type != CV_8UC1 && type != CV_8UC3) {
+        std::cerr << "[녹화] 지원하지 않는 픽셀 형식 (8비트 그레이 / BGR만 가능)" << std::endl;
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[녹화] " << path << " 열기 실패 - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    header_ = RecordHeader();
+    header_.magic = kRecordMagic;
+    header_.version = kRecordVersion;
+    header_.headerBytes = kHeaderBytes;
+    header_.pixelFormat = type == CV_8UC1 ? PIXEL_GRAY8 : PIXEL_BGR24;
+    header_.width = width;
+    header_.height = height;
+    header_.frameBytes = static_cast<uint64_t>(width) * height * (type == CV_8UC1 ? 1 : 3);
+    header_.frameStride = alignUp(header_.frameBytes, 64);
+    header_.fps = fps;
+    header_.startWallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // 헤더 블록 자리 확보 (complete = 0) - 닫을 때 다시 씀
+    std::vector<uint8_t> block(kHeaderBytes, 0);
+    std::memcpy(block.data(), &header_, sizeof(header_));
+    fd_ = fd;
+    if (!writeAll(block.data(), block.size())) {
+        std::cerr << "[녹화] 헤더 쓰기 실패 - " << strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    // 청크 = 프레임 여러 장 (감지 스레드가 할당 없이 채우도록 미리 확보)
+    const size_t framesPerChunk = std::max<size_t>(1, chunkBytes / header_.frameStride);
+    chunks_.assign(kChunkCount, Chunk());
+    freeChunks_.clear();
+    for (auto& c : chunks_) {
+        c.data.assign(framesPerChunk * header_.frameStride, 0);
+        freeChunks_.push_back(&c);
+    }
+    pending_.clear();
+    current_ = nullptr;
+    stopping_ = false;
+
+    index_.clear();
+    markers_.clear();
+    index_.reserve(static_cast<size_t>(std::max(fps, 1.0) * 600));   // 10분까지는 재할당 없음
+    droppedFrames_ = 0;
+    bytesWritten_ = kHeaderBytes;
+    failed_ = false;
+    path_ = path;
+
+    writer_ = std::thread(&FrameRecordWriter::writerLoop, this);
+    return true;
+}
+
+bool FrameRecordWriter::append(const cv::Mat& frame, int64_t captureNs, int64_t ptsNs) {
+    if (fd_ < 0 || failed_.load(std::memory_order_relaxed)) return false;
+    if (frame.cols != static_cast<int>(header_.width) || frame.rows != static_cast<int>(header_.height) ||
+        static_cast<uint64_t>(frame.channels()) * frame.cols * frame.rows != header_.frameBytes ||
+        frame.depth() != CV_8U) {
+        droppedFrames_++;
+        return false;
+    }
+
+    if (!current_) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (blocking_) freed_.wait(lock, [this] { return !freeChunks_.empty(); });
+        if (freeChunks_.empty()) {
+            droppedFrames_++;   // 디스크가 못 따라옴 - 감지 루프는 기다리지 않음
+            return false;
+        }
+        current_ = freeChunks_.back();
+        freeChunks_.pop_back();
+        current_->used = 0;
+    }
+
+    // 카메라 버퍼는 행 사이 여백이 있을 수 있으므로 행 단위로 복사
+    uint8_t* dst = current_->data.data() + current_->used;
+    const size_t rowBytes = frame.cols * frame.elemSize();
+    if (frame.isContinuous()) {
+        std::memcpy(dst, frame.data, header_.frameBytes);
+    } else {
+        for (int y = 0; y < frame.rows; y++) std::memcpy(dst + y * rowBytes, frame.ptr(y), rowBytes);
+    }
+    current_->used += header_.frameStride;
+    index_.push_back(FrameIndexEntry{captureNs, ptsNs});
+
+    if (current_->used + header_.frameStride > current_->data.size()) submitCurrent();
+    return true;
+}
+
+void FrameRecordWriter::submitCurrent() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(current_);
+    }
+    current_ = nullptr;
+    cv_.notify_one();
+}
+
+void FrameRecordWriter::mark(MarkerType type, int64_t timestampNs, int roiId, double value) {
+    if (fd_ < 0) return;
+    // 이벤트 시각 이전의 마지막 프레임 (첫 프레임보다 앞이면 0)
+    auto it = std::upper_bound(index_.begin(), index_.end(), timestampNs,
+                               [](int64_t ts, const FrameIndexEntry& e) { return ts < e.captureNs; });
+    uint64_t frameIndex = it == index_.begin() ? 0 : static_cast<uint64_t>(it - index_.begin() - 1);
+    markers_.push_back(Marker{frameIndex, timestampNs, type, static_cast<uint32_t>(roiId), value});
+}
+
+void FrameRecordWriter::setRoi(const std::vector<cv::Point>& roi) {
+    header_.roiCount = static_cast<uint32_t>(std::min<size_t>(roi.size(), kMaxRoiPoints));
+    for (uint32_t i = 0; i < header_.roiCount; i++) {
+        header_.roi[i][0] = roi[i].x;
+        header_.roi[i][1] = roi[i].y;
+    }
+    // 비정상 종료돼도 ROI는 남도록 바로 헤더에 반영 (pwrite는 기록 스레드의 파일 위치와 무관)
+    if (fd_ >= 0 && ::pwrite(fd_, &header_, sizeof(header_), 0) != static_cast<ssize_t>(sizeof(header_))) {
+        std::cerr << "[녹화] ROI 기록 실패 - " << strerror(errno) << std::endl;
+    }
+}
+
+void FrameRecordWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) break;   // stopping_이고 남은 청크 없음
+
+        Chunk* chunk = pending_.front();
+        pending_.pop_front();
+        lock.unlock();
+
+        if (!failed_.load(std::memory_order_relaxed) && !writeAll(chunk->data.data(), chunk->used)) {
+            std::cerr << "[녹화] " << path_ << " 쓰기 실패 - " << strerror(errno) << " (녹화 중단)" << std::endl;
+            failed_ = true;
+        }
+
+        lock.lock();
+        chunk->used = 0;
+        freeChunks_.push_back(chunk);
+        freed_.notify_one();
+    }
+}
+
+bool FrameRecordWriter::writeAll(const uint8_t* data, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t n = ::write(fd_, data, bytes);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        bytes -= static_cast<size_t>(n);
+        bytesWritten_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool FrameRecordWriter::close() {
+    if (fd_ < 0) return false;
+
+    // 채우던 청크까지 모두 기록한 뒤 기록 스레드 종료
+    if (current_ && current_->used > 0) submitCurrent();
+    current_ = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (writer_.joinable()) writer_.join();
+
+    bool ok = !failed_.load();
+    if (ok) {
+        // 프레임 뒤에 인덱스 / 마커를 붙이고 헤더 완성
+        std::stable_sort(markers_.begin(), markers_.end(),
+                         [](const Marker& a, const Marker& b) { return a.timestampNs < b.timestampNs; });
+        header_.frameCount = index_.size();
+        header_.markerCount = markers_.size();
+        header_.indexOffset = kHeaderBytes + header_.frameCount * header_.frameStride;
+        header_.markerOffset = header_.indexOffset + header_.frameCount * sizeof(FrameIndexEntry);
+        ok = writeAll(reinterpret_cast<const uint8_t*>(index_.data()), index_.size() * sizeof(FrameIndexEntry)) &&
+             writeAll(reinterpret_cast<const uint8_t*>(markers_.data()), markers_.size() * sizeof(Marker));
+        if (ok) {
+            header_.complete = 1;
+            ok = ::pwrite(fd_, &header_, sizeof(header_), 0) == static_cast<ssize_t>(sizeof(header_));
+        }
+        if (!ok) std::cerr << "[녹화] 인덱스 기록 실패 - " << strerror(errno) << std::endl;
+    }
+
+    ::close(fd_);
+    fd_ = -1;
+    chunks_.clear();
+    freeChunks_.clear();
+    pending_.clear();
+    return ok;
+}
+
+// --- 재생 ---
+
+FrameRecordReader::~FrameRecordReader() {
+    close();
+}
+
+bool FrameRecordReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[재생] " << path << " 열기 실패 - " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kHeaderBytes)) {
+        std::cerr << "[재생] " << path << ": 녹화 파일이 아닙니다 (크기)" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // 매핑은 fd를 닫아도 유지됨
+    if (addr == MAP_FAILED) {
+        std::cerr << "[재생] mmap 실패 - " << strerror(errno) << std::endl;
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(addr);
+    mappedBytes_ = size;
+    std::memcpy(&header_, base_, sizeof(header_));
+
+    const uint64_t channels = header_.pixelFormat == PIXEL_GRAY8 ? 1 : 3;
+    if (header_.magic != kRecordMagic || header_.version != kRecordVersion ||
+        header_.headerBytes != kHeaderBytes ||
+        (header_.pixelFormat != PIXEL_GRAY8 && header_.pixelFormat != PIXEL_BGR24) ||
+        header_.width == 0 || header_.height == 0 ||
+        header_.frameBytes != static_cast<uint64_t>(header_.width) * header_.height * channels ||
+        header_.frameStride < header_.frameBytes || header_.frameStride % 64 != 0) {
+        std::cerr << "[재생] " << path << ": 녹화 파일 형식/버전이 다릅니다" << std::endl;
+        close();
+        return false;
+    }
+
+    const uint64_t dataBytes = size - kHeaderBytes;
+    if (header_.complete &&
+        header_.indexOffset == kHeaderBytes + header_.frameCount * header_.frameStride &&
+        header_.markerOffset == header_.indexOffset + header_.frameCount * sizeof(FrameIndexEntry) &&
+        header_.markerOffset + header_.markerCount * sizeof(Marker) <= size) {
+        frameCount_ = header_.frameCount;
+        index_ = reinterpret_cast<const FrameIndexEntry*>(base_ + header_.indexOffset);
+        const Marker* m = reinterpret_cast<const Marker*>(base_ + header_.markerOffset);
+        markers_.assign(m, m + header_.markerCount);
+    } else {
+        // 비정상 종료된 녹화 - 온전한 프레임만 사용하고 시각은 fps로 추정
+        header_.complete = 0;
+        frameCount_ = dataBytes / header_.frameStride;
+        const double fps = header_.fps > 0 ? header_.fps : 30.0;
+        recoveredIndex_.resize(frameCount_);
+        for (size_t i = 0; i < frameCount_; i++) {
+            recoveredIndex_[i] = FrameIndexEntry{static_cast<int64_t>(i * 1e9 / fps), -1};
+        }
+        index_ = recoveredIndex_.data();
+        std::cerr << "[재생] " << path << ": 인덱스 없음 (녹화가 끝나지 않음) - 프레임 "
+                  << frameCount_ << "개, 시각은 " << fps << "FPS로 추정" << std::endl;
+    }
+
+    madvise(base_, mappedBytes_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void FrameRecordReader::close() {
+    if (base_) munmap(base_, mappedBytes_);
+    base_ = nullptr;
+    mappedBytes_ = 0;
+    header_ = RecordHeader();
+    frameCount_ = 0;
+    index_ = nullptr;
+    recoveredIndex_.clear();
+    markers_.clear();
+}
+
+cv::Mat FrameRecordReader::frame(size_t i) const {
+    if (i >= frameCount_) return cv::Mat();
+    return cv::Mat(height(), width(), type(), base_ + kHeaderBytes + i * header_.frameStride);
+}
+
+std::vector<cv::Point> FrameRecordReader::roi() const {
+    std::vector<cv::Point> points;
+    for (uint32_t i = 0; i < std::min<uint32_t>(header_.roiCount, kMaxRoiPoints); i++) {
+        points.push_back(cv::Point(header_.roi[i][0], header_.roi[i][1]));
+    }
+    return points;
+}
+
+size_t FrameRecordReader::frameAt(int64_t timestampNs) const {
+    const FrameIndexEntry* it = std::lower_bound(index_, index_ + frameCount_, timestampNs,
+                                                 [](const FrameIndexEntry& e, int64_t ts) { return e.captureNs < ts; });
+    return static_cast<size_t>(it - index_);
+}
+
+void FrameRecordReader::prefetch(size_t first, size_t count) const {
+    if (!base_ || first >= frameCount_) return;
+    count = std::min(count, frameCount_ - first);
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = kHeaderBytes + first * header_.frameStride;
+    size_t end = begin + count * header_.frameStride;
+    begin = begin / page * page;
+    madvise(base_ + begin, end - begin, MADV_WILLNEED);
+}
+
+}  // namespace record
@@ -0,0 +1,213 @@
+#ifndef FRAME_RECORD_HPP
+#define FRAME_RECORD_HPP
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * 원본 프레임 녹화 파일 (.frec) - 재생 / 벤치마크용
+ *
+ * 파일 구성 (리틀 엔디언, 이 장비 기준 고정 레이아웃)
+ *   [헤더 4096B] [프레임 0] [프레임 1] ... [프레임 인덱스] [이벤트 마커]
+ * - 프레임: 고정 크기 원본 픽셀 (행 사이 여백 없음, frameStride 간격 = 64바이트 정렬)
+ * - 프레임 인덱스: 프레임마다 캡처 시각 / PTS
+ * - 이벤트 마커: 병 감지 / 통과, 운영자 표시, 합성 장면 정답 구간 등 (프레임 번호 포함)
+ * - 인덱스와 마커는 녹화를 닫을 때 파일 끝에 붙이고 마지막에 헤더를 다시 씀
+ *   (complete = 0이면 비정상 종료 → 파일 크기로 프레임 수를 복구하고 시각은 fps로 추정)
+ *
+ * 녹화는 큰 청크 단위로 순차 기록하고, 재생은 파일 전체를 mmap해서 프레임을 복사 없이 넘김
+ * (영상 디코딩이 없으므로 메모리 대역폭 속도로 재생, 이벤트 위치로 바로 이동 가능)
+ * - 레이아웃을 바꾸면 kRecordVersion을 올릴 것
+ */
+
+namespace record {
+
+constexpr uint32_t kRecordMagic = 0x43455246;   // "FREC"
+constexpr uint32_t kRecordVersion = 1;
+constexpr uint32_t kHeaderBytes = 4096;
+constexpr int kMaxRoiPoints = 16;
+
+enum PixelFormat : uint32_t {
+    PIXEL_GRAY8 = 1,
+    PIXEL_BGR24 = 2
+};
+
+enum MarkerType : uint32_t {
+    MARK_ENTER = 0,          // 감지기: 병 감지
+    MARK_EXIT = 1,           // 감지기: 병 통과 완료
+    MARK_OPERATOR = 2,       // 운영자가 표시한 지점
+    MARK_TRUTH_ENTER = 3,    // 정답 구간 시작 (합성 장면 / 라벨)
+    MARK_TRUTH_EXIT = 4      // 정답 구간 끝
+};
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t pixelFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t complete;       // 인덱스/마커까지 기록하고 닫았으면 1
+    uint32_t roiCount;
+    uint64_t frameBytes;     // 프레임 하나의 픽셀 바이트
+    uint64_t frameStride;    // 파일 안 프레임 간격 (frameBytes를 64바이트 단위로 올림)
+    uint64_t frameCount;
+    uint64_t markerCount;
+    uint64_t indexOffset;
+    uint64_t markerOffset;
+    double fps;              // 녹화 설정 프레임레이트 (시각 추정용)
+    int64_t startWallMs;     // 녹화 시작 시각 (epoch ms)
+    int32_t roi[kMaxRoiPoints][2];   // 녹화 중 사용한 ROI (캡처 좌표)
+};
+
+struct FrameIndexEntry {
+    int64_t captureNs;       // steady_clock 기준 캡처 시각
+    int64_t ptsNs;           // 카메라 PTS (-1: 없음)
+};
+
+struct Marker {
+    uint64_t frameIndex;     // 마커 시각 이전의 마지막 프레임
+    int64_t timestampNs;
+    uint32_t type;           // MarkerType
+    uint32_t roiId;
+    double value;            // Enter: SAD, Exit: 머문 시간 ms 등
+};
+
+static_assert(sizeof(RecordHeader) <= kHeaderBytes, "record header must fit in the header block");
+static_assert(sizeof(FrameIndexEntry) == 16, "record layout changed - bump kRecordVersion");
+static_assert(sizeof(Marker) == 32, "record layout changed - bump kRecordVersion");
+
+/*
+ * 녹화 (감지 스레드에서 append / mark 호출)
+ * - append(): 프레임을 현재 청크에 복사만 하고 반환 (파일 쓰기는 기록 스레드가 처리)
+ *   빈 청크가 없으면(디스크가 못 따라오면) 감지 루프를 막지 않고 그 프레임은 녹화에서 뺌
+ * - mark(): 이벤트 시각 이전의 마지막 녹화 프레임에 마커를 붙임 (파일에는 시각 순으로 기록)
+ */
+class FrameRecordWriter {
+public:
+    FrameRecordWriter() = default;
+    ~FrameRecordWriter();
+
+    FrameRecordWriter(const FrameRecordWriter&) = delete;
+    FrameRecordWriter& operator=(const FrameRecordWriter&) = delete;
+
+    /*
+     * type: CV_8UC1 또는 CV_8UC3 (BGR)
+     * chunkBytes: 한 번에 write()할 크기 (프레임 단위로 맞춤)
+     */
+    bool open(const std::string& path, int width, int height, int type, double fps,
+              size_t chunkBytes = 8u << 20);
+    bool close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    bool append(const cv::Mat& frame, int64_t captureNs, int64_t ptsNs = -1);
+    void mark(MarkerType type, int64_t timestampNs, int roiId = 0, double value = 0.0);
+    void setRoi(const std::vector<cv::Point>& roi);
+
+    /*
+     * 빈 청크가 없을 때 프레임을 빼지 않고 기다림 (오프라인 녹화용 - 감지 루프에서는 쓰지 말 것)
+     */
+    void setBlocking(bool blocking) { blocking_ = blocking; }
+
+    uint64_t frames() const { return index_.size(); }
+    uint64_t droppedFrames() const { return droppedFrames_; }
+    uint64_t bytesWritten() const { return bytesWritten_.load(std::memory_order_relaxed); }
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk {
+        std::vector<uint8_t> data;
+        size_t used = 0;
+    };
+
+    void writerLoop();
+    bool writeAll(const uint8_t* data, size_t bytes);
+    void submitCurrent();
+
+    int fd_ = -1;
+    std::string path_;
+    RecordHeader header_ = {};
+
+    // 청크 풀: 감지 스레드가 채우고 기록 스레드가 써서 돌려줌
+    std::vector<Chunk> chunks_;
+    std::vector<Chunk*> freeChunks_;
+    std::deque<Chunk*> pending_;
+    Chunk* current_ = nullptr;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable freed_;
+    std::thread writer_;
+    bool stopping_ = false;
+    bool blocking_ = false;
+
+    std::vector<FrameIndexEntry> index_;
+    std::vector<Marker> markers_;
+    uint64_t droppedFrames_ = 0;
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<bool> failed_{false};
+};
+
+/*
+ * 재생 - 파일 전체를 mmap
+ * - frame(): 매핑된 픽셀을 그대로 가리키는 Mat 헤더 (복사 없음)
+ *   MAP_PRIVATE라서 Mat에 쓰더라도 파일은 바뀌지 않음 (해당 페이지만 복사됨)
+ * - 닫거나 다른 파일을 열면 이전 frame() 결과는 무효
+ */
+class FrameRecordReader {
+public:
+    FrameRecordReader() = default;
+    ~FrameRecordReader();
+
+    FrameRecordReader(const FrameRecordReader&) = delete;
+    FrameRecordReader& operator=(const FrameRecordReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    const RecordHeader& header() const { return header_; }
+    int width() const { return static_cast<int>(header_.width); }
+    int height() const { return static_cast<int>(header_.height); }
+    int type() const { return header_.pixelFormat == PIXEL_GRAY8 ? CV_8UC1 : CV_8UC3; }
+    double fps() const { return header_.fps; }
+    bool complete() const { return header_.complete != 0; }
+
+    size_t frameCount() const { return frameCount_; }
+    cv::Mat frame(size_t i) const;
+    int64_t timestampNs(size_t i) const { return index_[i].captureNs; }
+    int64_t ptsNs(size_t i) const { return index_[i].ptsNs; }
+
+    const std::vector<Marker>& markers() const { return markers_; }
+    std::vector<cv::Point> roi() const;
+
+    /*
+     * timestampNs 이후 첫 프레임 (모두 이전이면 frameCount())
+     */
+    size_t frameAt(int64_t timestampNs) const;
+
+    /*
+     * 재생 위치를 옮긴 뒤 앞으로 읽을 구간을 미리 읽도록 커널에 알림
+     */
+    void prefetch(size_t first, size_t count) const;
+
+private:
+    uint8_t* base_ = nullptr;
+    size_t mappedBytes_ = 0;
+    RecordHeader header_ = {};
+    size_t frameCount_ = 0;
+    const FrameIndexEntry* index_ = nullptr;    // 매핑 안의 인덱스 또는 recoveredIndex_
+    std::vector<FrameIndexEntry> recoveredIndex_;
+    std::vector<Marker> markers_;
+};
+
+}  // namespace record
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef FRAME_SLOT_HPP
+#define FRAME_SLOT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+ * 캡처 콜백 → 감지 스레드 최신 프레임 전달용 lock-free 트리플 버퍼
+ * - 항목 3개를 두고 "가운데" 인덱스만 원자적으로 교환 (락/할당/복사 없음)
+ *   쓰는 쪽: writeBuffer()를 채운 뒤 publish() → 가운데와 교환
+ *   읽는 쪽: waitLatest() → 새 항목이 있으면 가운데와 교환 후 readBuffer()
+ * - 감지 스레드가 느리면 읽지 않은 가운데 항목은 다음 publish()에서 덮어씀 (항상 최신만 전달)
+ * - publish() 후 writeBuffer()는 이전 가운데 항목(덮어쓴 프레임 또는 감지 스레드가 다 쓴 프레임)이므로
+ *   쓰는 쪽이 다시 채우기 전에 정리해야 함 (예: GstSample 반납)
+ * - 대기는 futex로 처리: 대기 중인 스레드가 있을 때만 publish()가 시스템 콜을 부름
+ */
+template <typename T>
+class LatestFrameSlot {
+public:
+    // 쓰는 쪽 전용
+    T& writeBuffer() { return items_[writeIdx_]; }
+
+    /*
+     * writeBuffer()를 최신 항목으로 게시
+     * - 반환값: 감지 스레드가 읽기 전에 덮어쓴 항목이 있었으면 true
+     */
+    bool publish() {
+        uint32_t prev = middle_.exchange(writeIdx_ | kFresh, std::memory_order_acq_rel);
+        writeIdx_ = prev & kIndexMask;
+        const bool overwritten = (prev & kFresh) != 0;
+        if (overwritten) skippedFrames_.fetch_add(1, std::memory_order_relaxed);
+
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) futexWake();
+        return overwritten;
+    }
+
+    /*
+     * 읽는 쪽: 새 항목이 올 때까지 대기 후 readBuffer()로 교환
+     * - 반환값: 새 항목이 있으면 true (timeout 또는 stop 시 false)
+     */
+    bool waitLatest(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            if (takeFresh()) return true;
+            if (stopped_.load(std::memory_order_acquire)) return false;
+
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero()) return false;
+
+            // seq를 읽은 뒤 다시 확인 → 그 사이 publish()가 있으면 futex가 바로 반환됨
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            const uint32_t seq = seq_.load(std::memory_order_seq_cst);
+            if (!(middle_.load(std::memory_order_acquire) & kFresh) && !stopped_.load(std::memory_order_acquire)) {
+                futexWait(seq, remaining);
+            }
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    // 읽는 쪽 전용
+    T& readBuffer() { return items_[readIdx_]; }
+
+    /*
+     * 읽기 전에 덮어쓴 항목 수 (어느 스레드에서나 조회 가능)
+     */
+    uint64_t skippedFrames() const { return skippedFrames_.load(std::memory_order_relaxed); }
+
+    void stop() {
+        stopped_.store(true, std::memory_order_release);
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        futexWake();
+    }
+
+    /*
+     * 항목 3개 모두에 fn 적용 (양쪽 모두 멈춘 뒤 정리용)
+     */
+    template <typename F>
+    void forEach(F fn) {
+        for (auto& item : items_) fn(item);
+    }
+
+private:
+    static constexpr uint32_t kIndexMask = 0x3;
+    static constexpr uint32_t kFresh = 0x4;   // 가운데 항목이 아직 읽히지 않음
+
+    bool takeFresh() {
+        if (!(middle_.load(std::memory_order_acquire) & kFresh)) return false;
+        uint32_t prev = middle_.exchange(readIdx_, std::memory_order_acq_rel);
+        readIdx_ = prev & kIndexMask;
+        return true;
+    }
+
+    void futexWait(uint32_t expected, std::chrono::steady_clock::duration remaining) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+    }
+
+    void futexWake() {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    T items_[3];
+    uint32_t writeIdx_ = 0;                  // 쓰는 쪽 소유
+    uint32_t readIdx_ = 2;                   // 읽는 쪽 소유
+    std::atomic<uint32_t> middle_{1};        // 가운데 인덱스 | kFresh
+
+    alignas(64) std::atomic<uint32_t> seq_{0};   // futex 주소 (publish/stop마다 증가)
+    std::atomic<int> waiters_{0};
+    std::atomic<bool> stopped_{false};
+    std::atomic<uint64_t> skippedFrames_{0};
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+};
+
+#endif
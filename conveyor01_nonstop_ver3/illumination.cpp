@@ -0,0 +1,98 @@
+#include "illumination.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+void IlluminationEstimator::setRegion(const cv::Mat& roiMask) {
+    points_.clear();
+    reference_.clear();
+    if (roiMask.empty()) return;
+
+    // ROI를 margin만큼 넓힌 영역은 제외
+    cv::Mat excluded;
+    if (cfg_.margin > 0) {
+        int k = 2 * cfg_.margin + 1;
+        cv::dilate(roiMask, excluded, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(k, k)));
+    } else {
+        excluded = roiMask;
+    }
+
+    const int step = std::max(cfg_.step, 1);
+    for (int y = step / 2; y < excluded.rows; y += step) {
+        const uint8_t* m = excluded.ptr<uint8_t>(y);
+        for (int x = step / 2; x < excluded.cols; x += step) {
+            if (m[x] == 0) points_.push_back(cv::Point(x, y));
+        }
+    }
+    current_.resize(points_.size());
+}
+
+void IlluminationEstimator::captureReference(const cv::Mat& baseline) {
+    reference_.resize(points_.size());
+    for (size_t i = 0; i < points_.size(); i++) {
+        reference_[i] = baseline.at<uint8_t>(points_[i].y, points_[i].x);
+    }
+}
+
+IlluminationModel IlluminationEstimator::estimate(const cv::Mat& frame) {
+    if (points_.size() < 16 || reference_.size() != points_.size()) return IlluminationModel();
+
+    // 표본 위치의 현재 그레이 값 (cvtColor와 같은 고정소수점 계수)
+    if (frame.channels() == 3) {
+        for (size_t i = 0; i < points_.size(); i++) {
+            const uint8_t* p = frame.ptr<uint8_t>(points_[i].y) + 3 * points_[i].x;
+            current_[i] = static_cast<uint8_t>((p[0] * 1868 + p[1] * 9617 + p[2] * 4899 + (1 << 13)) >> 14);
+        }
+    } else {
+        for (size_t i = 0; i < points_.size(); i++) {
+            current_[i] = frame.at<uint8_t>(points_[i].y, points_[i].x);
+        }
+    }
+
+    // 1차: 전체 표본, 2차: 잔차가 큰 표본(참조 영역을 지나는 물체 등) 제외
+    IlluminationModel first = fit(false, 1.0, 0.0, 0.0);
+
+    double sq = 0.0;
+    for (size_t i = 0; i < points_.size(); i++) {
+        double e = current_[i] - (first.gain() * reference_[i] + first.offset());
+        sq += e * e;
+    }
+    double sigma = std::max(std::sqrt(sq / points_.size()), 4.0);
+    return fit(true, first.gain(), first.offset(), 2.5 * sigma);
+}
+
+IlluminationModel IlluminationEstimator::fit(bool rejectOutliers, double gain, double offset, double limit) const {
+    double n = 0, sr = 0, sc = 0, srr = 0, src = 0;
+    for (size_t i = 0; i < points_.size(); i++) {
+        double r = reference_[i];
+        double c = current_[i];
+        if (rejectOutliers && std::fabs(c - (gain * r + offset)) > limit) continue;
+        n += 1;
+        sr += r;
+        sc += c;
+        srr += r * r;
+        src += r * c;
+    }
+
+    IlluminationModel model;
+    if (n < 16 || sr <= 0) return model;
+
+    double meanR = sr / n;
+    double meanC = sc / n;
+    double varR = srr / n - meanR * meanR;
+
+    double g, o;
+    if (varR >= cfg_.minRefStd * cfg_.minRefStd) {
+        g = (src / n - meanR * meanC) / varR;
+        g = std::min(std::max(g, cfg_.minGain), cfg_.maxGain);
+        o = meanC - g * meanR;
+    } else {
+        // 참조 영역이 거의 균일하면 기울기를 믿을 수 없으므로 밝기 비율만 사용
+        g = std::min(std::max(meanC / meanR, cfg_.minGain), cfg_.maxGain);
+        o = 0.0;
+    }
+
+    model.gainQ8 = static_cast<int>(std::lround(g * 256));
+    model.offsetQ8 = static_cast<int>(std::lround(o * 256));
+    return model;
+}
@@ -0,0 +1,64 @@
+#ifndef ILLUMINATION_HPP
+#define ILLUMINATION_HPP
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+#include "detect_kernels.hpp"
+
+/*
+ * 조명 보정 추정 설정
+ * - step: 표본 격자 간격 (픽셀)
+ * - margin: ROI 경계에서 띄울 거리 (블러/그림자 영향 제외)
+ * - minGain / maxGain: 추정값 허용 범위 (벗어나면 잘라냄)
+ * - minRefStd: 참조 영역 명암 편차가 이보다 작으면 gain만 추정 (offset = 0)
+ */
+struct IlluminationConfig {
+    int step = 8;
+    int margin = 4;
+    double minGain = 0.5;
+    double maxGain = 2.0;
+    double minRefStd = 4.0;
+};
+
+/*
+ * 전역 조명 변화(gain / offset) 추정
+ *
+ * - ROI 바깥의 참조 영역을 격자 간격(step)으로 띄엄띄엄 뽑아 둔 표본 위치에서
+ *   현재 프레임 값 c와 기준 프레임 값 r을 비교해 c ≈ gain * r + offset 을 최소제곱으로 맞춤
+ * - 참조 영역을 지나가는 병 등 이상값은 1차 추정 잔차로 한 번 걸러낸 뒤 다시 맞춤
+ * - 현재 값은 블러 전 원본(BGR/그레이)에서 바로 읽으므로 프레임 전체 패스가 추가되지 않음
+ *   (표본 수 = 화면 / step^2, 320x240 step 8 기준 약 1000개)
+ */
+class IlluminationEstimator {
+public:
+    explicit IlluminationEstimator(const IlluminationConfig& cfg = IlluminationConfig()) : cfg_(cfg) {}
+
+    /*
+     * 표본 위치 설정 - roiMask가 0인 곳 중 ROI에서 margin 이상 떨어진 격자점
+     */
+    void setRegion(const cv::Mat& roiMask);
+
+    /*
+     * 기준 프레임(블러된 그레이)에서 표본 값 저장
+     */
+    void captureReference(const cv::Mat& baseline);
+
+    /*
+     * 현재 프레임(BGR 또는 그레이 원본)의 조명 보정 모델 추정
+     * - 표본이 부족하면 보정 없음(identity)
+     */
+    IlluminationModel estimate(const cv::Mat& frame);
+
+    size_t sampleCount() const { return points_.size(); }
+
+private:
+    IlluminationModel fit(bool rejectOutliers, double gain, double offset, double limit) const;
+
+    IlluminationConfig cfg_;
+    std::vector<cv::Point> points_;
+    std::vector<uint8_t> reference_;
+    std::vector<uint8_t> current_;
+};
+
+#endif
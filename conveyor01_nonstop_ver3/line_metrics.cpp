@@ -0,0 +1,212 @@
+#include "line_metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+
+namespace {
+
+template <int N>
+int binOf(int64_t ms, const int64_t (&upper)[N]) {
+    for (int i = 0; i < N; i++) {
+        if (ms < upper[i]) return i;
+    }
+    return N;
+}
+
+}  // namespace
+
+// --- 슬라이딩 윈도 ---
+
+LineMetrics::WindowCounter::WindowCounter(int buckets, int bucketSec)
+    : buckets_(buckets, 0), bucketNs_(bucketSec * 1000000000LL) {}
+
+void LineMetrics::WindowCounter::advance(int64_t nowNs) {
+    int64_t idx = nowNs / bucketNs_;
+    const int64_t n = static_cast<int64_t>(buckets_.size());
+    if (head_ < 0 || idx - head_ >= n) {
+        std::fill(buckets_.begin(), buckets_.end(), 0);
+        sum_ = 0;
+        head_ = idx;
+        return;
+    }
+    // 지나간 버킷만 비움 (버킷 수 이상 돌지 않음)
+    while (head_ < idx) {
+        head_++;
+        uint32_t& b = buckets_[head_ % n];
+        sum_ -= b;
+        b = 0;
+    }
+}
+
+void LineMetrics::WindowCounter::add(int64_t nowNs) {
+    advance(nowNs);
+    buckets_[head_ % static_cast<int64_t>(buckets_.size())]++;
+    sum_++;
+}
+
+double LineMetrics::WindowCounter::perMinute(int64_t nowNs, int64_t startNs) {
+    advance(nowNs);
+    // 시작 직후에는 실제로 지난 시간으로 나눔
+    double windowSec = static_cast<double>(buckets_.size()) * bucketNs_ / 1e9;
+    double elapsedSec = std::min(windowSec, std::max(1.0, (nowNs - startNs) / 1e9));
+    return sum_ * 60.0 / elapsedSec;
+}
+
+// --- 통계 ---
+
+void LineMetrics::RunningStats::add(double v) {
+    n++;
+    if (n == 1) {
+        min = max = v;
+    } else {
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+    double delta = v - mean;
+    mean += delta / n;
+    m2 += delta * (v - mean);
+}
+
+double LineMetrics::RunningStats::stddev() const {
+    return n > 1 ? std::sqrt(m2 / (n - 1)) : 0.0;
+}
+
+// --- 지표 ---
+
+LineMetrics::LineMetrics(const LineMetricsConfig& cfg)
+    : cfg_(cfg), rois_(std::max(cfg.roiCount, 1)), startNs_(steadyNowNs()) {
+    cfg_.roiCount = static_cast<int>(rois_.size());
+    cfg_.shiftHours = std::max(cfg_.shiftHours, 1);
+    currentShift_ = shiftIndex(wallNowSec());
+    shiftStartSec_ = shiftStart(currentShift_);
+    nextShiftSec_ = shiftStart(currentShift_ + 1);
+}
+
+int64_t LineMetrics::steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t LineMetrics::wallNowSec() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 현지 시간 기준 교대 번호 (shiftStartHour부터 shiftHours 간격)
+int64_t LineMetrics::shiftIndex(int64_t wallSec) const {
+    // 그 시점의 현지 시각으로 어림한 뒤 실제 경계(shiftStart)에 맞춤
+    // (서머타임 전환일에는 현지 시각이 한 시간 건너뛰거나 되풀이되므로)
+    time_t t = static_cast<time_t>(wallSec);
+    struct tm local;
+    localtime_r(&t, &local);
+    int64_t localSec = wallSec + local.tm_gmtoff - cfg_.shiftStartHour * 3600LL;
+    int64_t len = cfg_.shiftHours * 3600LL;
+    int64_t idx = localSec >= 0 ? localSec / len : (localSec - len + 1) / len;
+
+    while (shiftStart(idx + 1) <= wallSec) idx++;
+    while (shiftStart(idx) > wallSec) idx--;
+    return idx;
+}
+
+int64_t LineMetrics::shiftStart(int64_t shiftIdx) const {
+    // 교대 경계의 UTC 시각 - 1970-01-01 현지 shiftStartHour시부터 shiftHours시간씩 더한 현지 시각을
+    // mktime으로 변환 (tm_isdst = -1: 그날의 서머타임 적용 여부를 mktime이 판단)
+    struct tm local = {};
+    local.tm_year = 70;
+    local.tm_mday = 1;
+    local.tm_hour = static_cast<int>(cfg_.shiftStartHour + shiftIdx * cfg_.shiftHours);
+    local.tm_isdst = -1;
+    return static_cast<int64_t>(mktime(&local));
+}
+
+void LineMetrics::rollShift(int64_t wallSec) {
+    // 현재 교대 구간 안이면 경계 계산(mktime) 없이 바로 반환 - 경계를 넘었을 때만 다시 계산
+    if (wallSec >= shiftStartSec_ && wallSec < nextShiftSec_) return;
+
+    int64_t idx = shiftIndex(wallSec);
+    shiftStartSec_ = shiftStart(idx);
+    nextShiftSec_ = shiftStart(idx + 1);
+    if (idx == currentShift_) return;
+
+    currentShift_ = idx;
+    for (auto& roi : rois_) {
+        roi.shiftCount = 0;
+        roi.shiftRejects = 0;
+        roi.gap = RunningStats();
+        roi.dwell = RunningStats();
+        std::fill(std::begin(roi.gapHist), std::end(roi.gapHist), 0);
+        std::fill(std::begin(roi.dwellHist), std::end(roi.dwellHist), 0);
+    }
+}
+
+void LineMetrics::onEvent(const DetectionEvent& event, int64_t wallSec) {
+    if (event.roiId < 0 || event.roiId >= cfg_.roiCount) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rollShift(wallSec);
+    RoiState& roi = rois_[event.roiId];
+    startNs_ = std::min(startNs_, event.timestampNs);   // 시작 전에 찍힌 프레임의 이벤트
+
+    if (event.type == DetectionEventType::Enter) {
+        roi.totalCount++;
+        roi.shiftCount++;
+        roi.window1m.add(event.timestampNs);
+        roi.window15m.add(event.timestampNs);
+
+        if (roi.lastEnterNs >= 0) {
+            int64_t gapMs = (event.timestampNs - roi.lastEnterNs) / 1000000;
+            roi.gap.add(static_cast<double>(gapMs));
+            roi.gapHist[binOf(gapMs, kGapBinUpperMs)]++;
+        }
+        roi.lastEnterNs = event.timestampNs;
+    } else {
+        int64_t dwellMs = event.durationNs / 1000000;
+        roi.dwell.add(static_cast<double>(dwellMs));
+        roi.dwellHist[binOf(dwellMs, kDwellBinUpperMs)]++;
+
+        bool tooShort = cfg_.rejectMinDwellMs > 0 && dwellMs < cfg_.rejectMinDwellMs;
+        bool tooLong = cfg_.rejectMaxDwellMs > 0 && dwellMs > cfg_.rejectMaxDwellMs;
+        if (tooShort || tooLong) {
+            roi.totalRejects++;
+            roi.shiftRejects++;
+        }
+    }
+}
+
+LineMetricsSnapshot LineMetrics::snapshot(int roiId, int64_t nowNs, int64_t wallSec) {
+    LineMetricsSnapshot s = {};
+    s.roiId = static_cast<uint32_t>(roiId);
+    if (roiId < 0 || roiId >= cfg_.roiCount) return s;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rollShift(wallSec);
+    RoiState& roi = rois_[roiId];
+
+    s.totalCount = roi.totalCount;
+    s.totalRejects = roi.totalRejects;
+    s.shiftCount = roi.shiftCount;
+    s.shiftRejects = roi.shiftRejects;
+    s.shiftStartSec = shiftStartSec_;
+
+    s.perMinute1m = roi.window1m.perMinute(nowNs, startNs_);
+    s.perMinute15m = roi.window15m.perMinute(nowNs, startNs_);
+    // 프로그램이 교대 중간에 시작했으면 시작 시점부터 계산
+    int64_t startedSec = wallSec - (nowNs - startNs_) / 1000000000LL;
+    double shiftMinutes = std::max(1.0, (wallSec - std::max(shiftStartSec_, startedSec)) / 60.0);
+    s.perMinuteShift = roi.shiftCount / shiftMinutes;
+    s.rejectRatioShift = roi.shiftCount > 0 ? static_cast<double>(roi.shiftRejects) / roi.shiftCount : 0.0;
+
+    s.gapMeanMs = roi.gap.mean;
+    s.gapStdMs = roi.gap.stddev();
+    s.gapMinMs = roi.gap.min;
+    s.gapMaxMs = roi.gap.max;
+    std::copy(std::begin(roi.gapHist), std::end(roi.gapHist), s.gapHist);
+
+    s.dwellMeanMs = roi.dwell.mean;
+    s.dwellStdMs = roi.dwell.stddev();
+    s.dwellMinMs = roi.dwell.min;
+    s.dwellMaxMs = roi.dwell.max;
+    std::copy(std::begin(roi.dwellHist), std::end(roi.dwellHist), s.dwellHist);
+    return s;
+}
@@ -0,0 +1,155 @@
+#ifndef LINE_METRICS_HPP
+#define LINE_METRICS_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "presence_tracker.hpp"
+
+/*
+ * 라인 처리량 지표 (ROI별)
+ *
+ * - 병 수: 누적 / 현재 교대(shift)
+ * - 분당 병 수: 최근 1분 / 최근 15분 / 현재 교대 평균
+ * - 도착 간격(Enter → 다음 Enter)과 체류 시간(Exit의 durationNs) 통계와 히스토그램 (교대 단위로 초기화)
+ * - 불량(reject): 체류 시간이 정상 범위를 벗어난 병 (쓰러짐/걸림 등, 범위 미설정 시 집계 안 함)
+ *
+ * 이벤트 하나당 O(1) (고정 크기 버킷 링 + 누적 합), 조회는 다른 스레드에서 해도 안전
+ */
+
+constexpr int kGapBins = 10;
+constexpr int kDwellBins = 8;
+
+// 히스토그램 구간 상한 (ms, 마지막 구간은 그 이상 전부)
+constexpr int64_t kGapBinUpperMs[kGapBins - 1] = { 500, 1000, 1500, 2000, 3000, 5000, 10000, 30000, 60000 };
+constexpr int64_t kDwellBinUpperMs[kDwellBins - 1] = { 100, 200, 400, 800, 1600, 3200, 6400 };
+
+/*
+ * ROI 하나의 지표 스냅샷 (고정 크기 - 텔레메트리 공유 메모리에도 그대로 복사)
+ */
+struct LineMetricsSnapshot {
+    uint32_t roiId;
+    uint32_t reserved;
+    uint64_t totalCount;
+    uint64_t totalRejects;
+    uint64_t shiftCount;
+    uint64_t shiftRejects;
+    int64_t shiftStartSec;      // 현재 교대 시작 시각 (epoch 초)
+
+    double perMinute1m;
+    double perMinute15m;
+    double perMinuteShift;
+    double rejectRatioShift;    // shiftRejects / shiftCount
+
+    // 도착 간격 (현재 교대)
+    double gapMeanMs;
+    double gapStdMs;
+    double gapMinMs;
+    double gapMaxMs;
+    uint32_t gapHist[kGapBins];
+
+    // 체류 시간 (현재 교대)
+    double dwellMeanMs;
+    double dwellStdMs;
+    double dwellMinMs;
+    double dwellMaxMs;
+    uint32_t dwellHist[kDwellBins];
+};
+
+/*
+ * 교대/불량 판정 설정
+ * - shiftStartHour / shiftHours: 첫 교대 시작 시각(현지 시간)과 교대 길이 (6시 시작 8시간 → 06/14/22시)
+ * - rejectMinDwellMs / rejectMaxDwellMs: 정상 체류 시간 범위 (0이면 해당 쪽 검사 안 함)
+ */
+struct LineMetricsConfig {
+    int roiCount = 1;
+    int shiftStartHour = 6;
+    int shiftHours = 8;
+    int64_t rejectMinDwellMs = 0;
+    int64_t rejectMaxDwellMs = 0;
+};
+
+class LineMetrics {
+public:
+    explicit LineMetrics(const LineMetricsConfig& cfg = LineMetricsConfig());
+
+    /*
+     * 감지 이벤트 반영 (감지 스레드)
+     * - event.timestampNs: steady_clock 기준, wallSec: 현재 epoch 초 (교대 구분용)
+     */
+    void onEvent(const DetectionEvent& event, int64_t wallSec);
+
+    /*
+     * ROI 지표 조회 - nowNs(steady_clock)까지 지난 구간은 비운 뒤 계산
+     */
+    LineMetricsSnapshot snapshot(int roiId, int64_t nowNs, int64_t wallSec);
+
+    int roiCount() const { return cfg_.roiCount; }
+    const LineMetricsConfig& config() const { return cfg_; }
+
+    // 현재 steady_clock / system_clock 시각
+    static int64_t steadyNowNs();
+    static int64_t wallNowSec();
+
+private:
+    /*
+     * 고정 크기 버킷 링으로 만든 슬라이딩 윈도 카운터
+     * - 버킷 N개 x bucketSec초, 시간이 지나면 오래된 버킷을 비우고 누적 합에서 뺌
+     */
+    class WindowCounter {
+    public:
+        WindowCounter(int buckets, int bucketSec);
+        void add(int64_t nowNs);
+        double perMinute(int64_t nowNs, int64_t startNs);
+
+    private:
+        void advance(int64_t nowNs);
+
+        std::vector<uint32_t> buckets_;
+        int64_t bucketNs_;
+        int64_t head_ = -1;     // 현재 버킷 번호 (시각 / bucketNs)
+        uint64_t sum_ = 0;
+    };
+
+    // 평균/표준편차/최소/최대 (Welford)
+    struct RunningStats {
+        uint64_t n = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+
+        void add(double v);
+        double stddev() const;
+    };
+
+    struct RoiState {
+        RoiState() : window1m(60, 1), window15m(90, 10) {}
+
+        WindowCounter window1m;
+        WindowCounter window15m;
+        uint64_t totalCount = 0;
+        uint64_t totalRejects = 0;
+        uint64_t shiftCount = 0;
+        uint64_t shiftRejects = 0;
+        int64_t lastEnterNs = -1;
+        RunningStats gap;
+        RunningStats dwell;
+        uint32_t gapHist[kGapBins] = {};
+        uint32_t dwellHist[kDwellBins] = {};
+    };
+
+    int64_t shiftIndex(int64_t wallSec) const;
+    int64_t shiftStart(int64_t shiftIdx) const;
+    void rollShift(int64_t wallSec);
+
+    LineMetricsConfig cfg_;
+    std::mutex mutex_;
+    std::vector<RoiState> rois_;
+    int64_t startNs_;
+    int64_t currentShift_;
+    int64_t shiftStartSec_;
+    int64_t nextShiftSec_;      // 다음 교대 시작 시각 - 이 시각 전까지는 교대 번호를 다시 계산하지 않음
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "presence_tracker.hpp"
+#include <algorithm>
+
+void PresenceTracker::update(double sad, double riseThreshold, uint64_t frameIndex, int64_t timestampNs,
+                             std::vector<DetectionEvent>& out) {
+    const double fallThreshold = cfg_.fallThreshold > 0.0 ? std::min(cfg_.fallThreshold, riseThreshold)
+                                                          : riseThreshold * cfg_.fallRatio;
+
+    switch (state_) {
+    case State::Absent:
+        if (sad > riseThreshold && (lastExitNs_ < 0 || timestampNs - lastExitNs_ >= cfg_.minGapNs)) {
+            state_ = State::Present;
+            enterNs_ = timestampNs;
+            int64_t gap = lastExitNs_ < 0 ? -1 : timestampNs - lastExitNs_;
+            out.push_back({DetectionEventType::Enter, roiId_, frameIndex, timestampNs, gap, sad, riseThreshold});
+        }
+        break;
+
+    case State::Present:
+        if (sad < fallThreshold && timestampNs - enterNs_ >= cfg_.minPresenceNs) {
+            state_ = State::Leaving;
+            fallNs_ = timestampNs;
+            fallFrame_ = frameIndex;
+            fallSad_ = sad;
+        }
+        break;
+
+    case State::Leaving:
+        if (sad >= fallThreshold) {
+            state_ = State::Present;   // 다시 올라옴 - 같은 병으로 유지
+        } else if (timestampNs - fallNs_ >= cfg_.releaseHoldNs) {
+            state_ = State::Absent;
+            lastExitNs_ = fallNs_;
+            out.push_back({DetectionEventType::Exit, roiId_, fallFrame_, fallNs_, fallNs_ - enterNs_,
+                           fallSad_, riseThreshold});
+        }
+        break;
+    }
+}
+
+void PresenceTracker::reset() {
+    state_ = State::Absent;
+    enterNs_ = 0;
+    lastExitNs_ = -1;
+}
@@ -0,0 +1,88 @@
+#ifndef PRESENCE_TRACKER_HPP
+#define PRESENCE_TRACKER_HPP
+
+#include <cstdint>
+#include <vector>
+
+enum class DetectionEventType {
+    Enter,   // 병 감지
+    Exit     // 병 통과 완료
+};
+
+/*
+ * 감지 이벤트
+ * - Enter: timestampNs = 상승 임계값을 넘은 프레임, durationNs = 직전 Exit 이후 간격 (첫 병이면 -1)
+ * - Exit: timestampNs = 하강 임계값 아래로 내려간 프레임, durationNs = 병이 머문 시간
+ *   (Exit는 releaseHold 동안 내려가 있는 것이 확인된 뒤 발생하므로 그만큼 늦게 전달됨)
+ */
+struct DetectionEvent {
+    DetectionEventType type;
+    int roiId;
+    uint64_t frameIndex;     // 이벤트 시각에 해당하는 프레임 번호
+    int64_t timestampNs;     // 해당 프레임 캡처 시각
+    int64_t durationNs;
+    double sad;
+    double threshold;        // 상승 임계값
+};
+
+/*
+ * 시간 기준 감지 상태 설정
+ * - minPresenceNs: 감지 후 해제를 허용하기까지 최소 유지 시간
+ * - releaseHoldNs: SAD가 하강 임계값 아래로 이만큼 계속 머물러야 해제 확정
+ *   (그 전에 다시 올라오면 같은 병으로 보고 이어서 유지)
+ * - minGapNs: 병 사이 최소 간격 - 앞 병이 빠진 뒤(Exit 시각) 이 시간 안에 올라온 SAD는 새 병으로 보지 않음
+ *   (0이면 검사 안 함)
+ * - fallRatio: 하강 임계값 = 상승 임계값 x fallRatio
+ * - fallThreshold: 0보다 크면 비율 대신 이 절대값을 하강 임계값으로 사용 (상승 임계값보다 크면 상승 임계값)
+ */
+struct PresenceConfig {
+    int64_t minPresenceNs = 500000000LL;   // 기존 15프레임 @ 30FPS
+    int64_t releaseHoldNs = 100000000LL;
+    int64_t minGapNs = 0;
+    double fallRatio = 0.6;
+    double fallThreshold = 0.0;
+};
+
+/*
+ * ROI 하나의 병 유무 상태 머신 (캡처 타임스탬프 기준)
+ *
+ *   Absent --(SAD > 상승, 앞 병 Exit 후 ≥ minGap)--> Present --(SAD < 하강, 유지 ≥ minPresence)--> Leaving
+ *   Leaving --(SAD ≥ 하강)--> Present
+ *   Leaving --(releaseHold 경과)--> Absent
+ *
+ * FPS가 바뀌거나 프레임이 빠져도 시간 조건은 그대로 유지됨
+ */
+class PresenceTracker {
+public:
+    enum class State { Absent, Present, Leaving };
+
+    explicit PresenceTracker(int roiId = 0, const PresenceConfig& cfg = PresenceConfig())
+        : roiId_(roiId), cfg_(cfg) {}
+
+    /*
+     * 프레임 하나 반영 - 발생한 이벤트는 out 뒤에 추가
+     */
+    void update(double sad, double riseThreshold, uint64_t frameIndex, int64_t timestampNs,
+                std::vector<DetectionEvent>& out);
+
+    // 상태 초기화 (ROI 변경 등)
+    void reset();
+
+    State state() const { return state_; }
+    bool present() const { return state_ != State::Absent; }
+    const PresenceConfig& config() const { return cfg_; }
+
+private:
+    int roiId_;
+    PresenceConfig cfg_;
+    State state_ = State::Absent;
+    int64_t enterNs_ = 0;
+    int64_t lastExitNs_ = -1;
+
+    // Leaving 진입 시점 (Exit 이벤트에 기록)
+    int64_t fallNs_ = 0;
+    uint64_t fallFrame_ = 0;
+    double fallSad_ = 0.0;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "rt_tuning.hpp"
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+bool RtTuning::applyToCurrentThread(const char* name, const RtThreadConfig& cfg) {
+    bool ok = true;
+
+    // CPU 고정
+    if (cfg.cpu >= 0) {
+        // CPU_SET은 CPU_SETSIZE 이상이면 범위 밖 쓰기 → 먼저 걸러냄 (켜져 있는 CPU 수 기준)
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cfg.cpu >= CPU_SETSIZE || (online > 0 && cfg.cpu >= online)) {
+            std::cerr << "[RT] " << name << ": CPU " << cfg.cpu << " 고정 실패 - 없는 CPU (켜진 CPU "
+                      << online << "개)" << std::endl;
+            ok = false;
+        } else {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cfg.cpu, &set);
+            int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (rc != 0) {
+                std::cerr << "[RT] " << name << ": CPU " << cfg.cpu << " 고정 실패 - "
+                          << strerror(rc) << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    // SCHED_FIFO 적용
+    if (cfg.fifoPriority > 0) {
+        int minPrio = sched_get_priority_min(SCHED_FIFO);
+        int maxPrio = sched_get_priority_max(SCHED_FIFO);
+        sched_param param{};
+        param.sched_priority = std::min(std::max(cfg.fifoPriority, minPrio), maxPrio);
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc != 0) {
+            std::cerr << "[RT] " << name << ": SCHED_FIFO(" << param.sched_priority << ") 설정 실패 - "
+                      << strerror(rc);
+            if (rc == EPERM) {
+                std::cerr << " (root 권한, CAP_SYS_NICE 또는 RLIMIT_RTPRIO 필요)";
+            }
+            std::cerr << std::endl;
+            ok = false;
+        }
+    }
+
+    reportCurrentThread(name);
+    return ok;
+}
+
+bool RtTuning::lockMemory() {
+    // 해제한 메모리를 OS에 돌려주지 않고, 큰 할당도 mmap 대신 힙에서 처리
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        int err = errno;
+        std::cerr << "[RT] mlockall 실패 - " << strerror(err);
+        if (err == EPERM || err == ENOMEM) {
+            std::cerr << " (root 권한, CAP_IPC_LOCK 또는 RLIMIT_MEMLOCK 확인)";
+        }
+        std::cerr << std::endl;
+        return false;
+    }
+    std::cout << "[RT] mlockall 적용 (MCL_CURRENT | MCL_FUTURE)" << std::endl;
+    return true;
+}
+
+void RtTuning::prefault(void* data, size_t bytes) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(data);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < bytes; i += pageSize) {
+        p[i] = p[i];
+    }
+}
+
+void RtTuning::reportCurrentThread(const char* name) {
+    int policy = 0;
+    sched_param param{};
+    pthread_getschedparam(pthread_self(), &policy, &param);
+
+    const char* policyName = "SCHED_OTHER";
+    if (policy == SCHED_FIFO) policyName = "SCHED_FIFO";
+    else if (policy == SCHED_RR) policyName = "SCHED_RR";
+
+    std::string cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, &set)) {
+                if (!cpus.empty()) cpus += ",";
+                cpus += std::to_string(i);
+            }
+        }
+    }
+
+    std::cout << "[RT] " << name << ": " << policyName << " prio=" << param.sched_priority
+              << " cpus=" << (cpus.empty() ? "?" : cpus) << std::endl;
+}
+
+void RtTuning::reportProcess() {
+    rlimit rtprio{}, memlock{};
+    getrlimit(RLIMIT_RTPRIO, &rtprio);
+    getrlimit(RLIMIT_MEMLOCK, &memlock);
+
+    // /proc/self/status에서 잠긴 메모리 크기 확인
+    std::string vmLck = "?";
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmLck:") == 0) {
+            vmLck = line.substr(6);
+            vmLck.erase(0, vmLck.find_first_not_of(" \t"));
+            break;
+        }
+    }
+
+    std::cout << "[RT] 코어 수: " << sysconf(_SC_NPROCESSORS_ONLN)
+              << " | RLIMIT_RTPRIO: " << (rtprio.rlim_cur == RLIM_INFINITY ? std::string("unlimited") : std::to_string(rtprio.rlim_cur))
+              << " | RLIMIT_MEMLOCK: " << (memlock.rlim_cur == RLIM_INFINITY ? std::string("unlimited") : std::to_string(memlock.rlim_cur))
+              << " | VmLck: " << vmLck << std::endl;
+}
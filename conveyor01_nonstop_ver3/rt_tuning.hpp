@@ -0,0 +1,65 @@
+#ifndef RT_TUNING_HPP
+#define RT_TUNING_HPP
+
+#include <string>
+
+/*
+ * 스레드별 실시간 설정
+ * - cpu: 고정할 코어 번호 (-1이면 고정하지 않음)
+ * - fifoPriority: SCHED_FIFO 우선순위 1~99 (0이면 SCHED_OTHER 유지)
+ */
+struct RtThreadConfig {
+    int cpu = -1;
+    int fifoPriority = 0;
+};
+
+/*
+ * 감지기 실시간 설정
+ * - capture: 캡처 콜백 스레드 (GStreamer 스트리밍 스레드), detect: 감지 스레드
+ * - lockMemory: mlockall로 프레임 버퍼 등 전체 메모리를 RAM에 고정
+ */
+struct RtConfig {
+    RtThreadConfig capture;
+    RtThreadConfig detect;
+    bool lockMemory = false;
+};
+
+/*
+ * CPU 고정 / SCHED_FIFO / 메모리 잠금 유틸리티
+ * 모든 함수는 실패해도 예외를 던지지 않고 false와 함께 원인을 출력함
+ * (권한이 없는 환경에서도 감지기는 기본 스케줄링으로 계속 동작해야 하므로)
+ */
+class RtTuning {
+public:
+    /*
+     * 호출한 스레드에 CPU 고정 및 SCHED_FIFO 적용
+     * - name: 자가 점검 출력용 스레드 이름
+     * - 반환값: 요청한 설정이 모두 적용되었으면 true
+     */
+    static bool applyToCurrentThread(const char* name, const RtThreadConfig& cfg);
+
+    /*
+     * 프로세스 메모리 잠금
+     * - mlockall(MCL_CURRENT | MCL_FUTURE) 후 malloc이 메모리를 OS에 돌려주지 않도록 설정
+     *   → 해제/재할당 시에도 새 페이지 폴트가 생기지 않음
+     * - 반환값: 성공 시 true
+     */
+    static bool lockMemory();
+
+    /*
+     * 미리 할당한 버퍼를 한 번씩 건드려서 페이지를 실제로 매핑
+     */
+    static void prefault(void* data, size_t bytes);
+
+    /*
+     * 호출한 스레드의 실제 스케줄링 정책/우선순위/CPU 집합을 출력
+     */
+    static void reportCurrentThread(const char* name);
+
+    /*
+     * 프로세스 수준 점검: RLIMIT_RTPRIO, RLIMIT_MEMLOCK, 잠긴 메모리(VmLck), 코어 수
+     */
+    static void reportProcess();
+};
+
+#endif
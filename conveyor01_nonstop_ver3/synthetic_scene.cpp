@@ -0,0 +1,163 @@
+#include "synthetic_scene.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int kNoiseBankSize = 4;
+const int kBeltShade = 90;
+const int kFloorShade = 40;
+const double kPi = 3.14159265358979323846;
+}
+
+SyntheticScene::SyntheticScene(const SceneConfig& cfg)
+    : cfg_(cfg), rng_(cfg.seed) {
+    bottleLength_ = std::max(cfg_.width * 22 / 100, 8);
+    bottleWidth_ = std::max(cfg_.height * 18 / 100, 4);
+    beltTop_ = cfg_.height * 20 / 100;
+    beltBottom_ = cfg_.height * 80 / 100;
+    speed_ = cfg_.beltSpeed > 0 ? cfg_.beltSpeed : cfg_.width * 0.4;
+
+    // 벨트 배경: 바닥 + 벨트 + 가로 줄무늬 + 약한 세로 그라데이션
+    background_.create(cfg_.height, cfg_.width, CV_8UC1);
+    for (int y = 0; y < cfg_.height; y++) {
+        uint8_t* row = background_.ptr<uint8_t>(y);
+        bool onBelt = y >= beltTop_ && y < beltBottom_;
+        for (int x = 0; x < cfg_.width; x++) {
+            int v = onBelt ? kBeltShade + ((y / 6) % 2) * 8 : kFloorShade;
+            v += (x * 10) / cfg_.width;
+            row[x] = static_cast<uint8_t>(v);
+        }
+    }
+    canvas_.create(cfg_.height, cfg_.width, CV_8UC1);
+
+    // 노이즈 뱅크 (프레임마다 하나를 골라 행 오프셋을 바꿔 사용)
+    size_t pixels = static_cast<size_t>(cfg_.width) * cfg_.height;
+    noiseBank_.resize(kNoiseBankSize);
+    for (auto& noise : noiseBank_) {
+        noise.resize(pixels);
+        for (auto& n : noise) {
+            double v = rng_.gaussian(cfg_.noiseSigma);
+            n = static_cast<int8_t>(std::max(-127.0, std::min(127.0, std::round(v))));
+        }
+    }
+}
+
+std::vector<cv::Point> SyntheticScene::suggestedRoi() const {
+    int cx = cfg_.width / 2;
+    int half = std::max(bottleLength_ / 4, 2);
+    return {
+        cv::Point(cx - half, beltTop_),
+        cv::Point(cx + half, beltTop_),
+        cv::Point(cx + half, beltBottom_ - 1),
+        cv::Point(cx - half, beltBottom_ - 1)
+    };
+}
+
+double SyntheticScene::nominalBottleSad(const cv::Rect& roi) const {
+    // 병 몸통이 ROI 폭 전체를 덮을 때: 덮인 면적 × 평균 밝기 차이
+    int covered = std::min(roi.width, bottleLength_) * std::min(roi.height, bottleWidth_);
+    return covered * 80.0;
+}
+
+void SyntheticScene::spawnIfDue() {
+    double now = frameIndex_ / cfg_.fps;
+    if (now < nextSpawnSec_) return;
+
+    int margin = bottleWidth_ / 2 + 2;
+    Bottle b;
+    b.id = nextBottleId_++;
+    b.x = -bottleLength_;
+    b.y = rng_.uniform(beltTop_ + margin, std::max(beltBottom_ - margin, beltTop_ + margin + 1));
+    b.shade = rng_.uniform(170, 230);
+    b.inRoi = false;
+    bottles_.push_back(b);
+
+    nextSpawnSec_ = now + cfg_.spawnInterval + rng_.uniform(-cfg_.spawnJitter, cfg_.spawnJitter);
+}
+
+void SyntheticScene::drawBottle(cv::Mat& canvas, const Bottle& b) const {
+    // 몸통(타원) + 목(사각형) + 하이라이트
+    int x0 = static_cast<int>(std::lround(b.x));
+    int bodyLen = bottleLength_ * 3 / 4;
+    int neckLen = bottleLength_ - bodyLen;
+    cv::Point center(x0 + bodyLen / 2, b.y);
+    cv::ellipse(canvas, center, cv::Size(bodyLen / 2, bottleWidth_ / 2), 0, 0, 360,
+                cv::Scalar(b.shade), cv::FILLED);
+    cv::rectangle(canvas, cv::Point(x0 + bodyLen - 2, b.y - bottleWidth_ / 6),
+                  cv::Point(x0 + bodyLen + neckLen, b.y + bottleWidth_ / 6),
+                  cv::Scalar(b.shade - 20), cv::FILLED);
+    cv::ellipse(canvas, cv::Point(center.x, b.y - bottleWidth_ / 5),
+                cv::Size(std::max(bodyLen / 3, 1), std::max(bottleWidth_ / 10, 1)), 0, 0, 360,
+                cv::Scalar(std::min(b.shade + 25, 255)), cv::FILLED);
+}
+
+void SyntheticScene::updateGroundTruth(int64_t nowNs) {
+    if (trackedRoi_.empty()) return;
+
+    for (auto& b : bottles_) {
+        cv::Rect box(static_cast<int>(std::lround(b.x)), b.y - bottleWidth_ / 2,
+                     bottleLength_, bottleWidth_);
+        bool overlap = !(box & trackedRoi_).empty();
+        if (overlap && !b.inRoi) {
+            truth_.push_back({b.id, nowNs, -1});
+        } else if (!overlap && b.inRoi) {
+            for (auto it = truth_.rbegin(); it != truth_.rend(); ++it) {
+                if (it->bottleId == b.id) {
+                    it->exitNs = nowNs;
+                    break;
+                }
+            }
+        }
+        b.inRoi = overlap;
+    }
+}
+
+int64_t SyntheticScene::render(cv::Mat& out) {
+    const double t = frameIndex_ / cfg_.fps;
+    const int64_t nowNs = static_cast<int64_t>(std::llround(t * 1e9));
+
+    spawnIfDue();
+
+    // 병 이동 및 화면 밖으로 나간 병 제거
+    const double dx = speed_ / cfg_.fps;
+    for (auto& b : bottles_) b.x += dx;
+    updateGroundTruth(nowNs);
+    bottles_.erase(std::remove_if(bottles_.begin(), bottles_.end(),
+                                  [this](const Bottle& b) { return b.x > cfg_.width && !b.inRoi; }),
+                   bottles_.end());
+
+    background_.copyTo(canvas_);
+    for (const auto& b : bottles_) drawBottle(canvas_, b);
+
+    // 조명 변화 + 노이즈 적용 (한 번의 패스)
+    double gain = 1.0 + cfg_.driftAmplitude * std::sin(2.0 * kPi * t / cfg_.driftPeriod);
+    if (cfg_.lightStep != 0.0 && static_cast<int64_t>(t / cfg_.lightStepPeriod) % 2 == 1) {
+        gain *= 1.0 + cfg_.lightStep;
+    }
+    const int gainQ8 = static_cast<int>(std::lround(gain * 256));
+    const auto& noise = noiseBank_[frameIndex_ % noiseBank_.size()];
+    const int rowShift = static_cast<int>((frameIndex_ * 7) % cfg_.height);
+
+    out.create(cfg_.height, cfg_.width, cfg_.color ? CV_8UC3 : CV_8UC1);
+    for (int y = 0; y < cfg_.height; y++) {
+        const uint8_t* src = canvas_.ptr<uint8_t>(y);
+        const int8_t* n = &noise[static_cast<size_t>((y + rowShift) % cfg_.height) * cfg_.width];
+        uint8_t* dst = out.ptr<uint8_t>(y);
+        for (int x = 0; x < cfg_.width; x++) {
+            int v = ((src[x] * gainQ8) >> 8) + n[x];
+            v = std::max(0, std::min(255, v));
+            if (cfg_.color) {
+                // 약간의 색 차이 (B, G, R)
+                dst[3 * x + 0] = static_cast<uint8_t>(std::max(0, v - 6));
+                dst[3 * x + 1] = static_cast<uint8_t>(v);
+                dst[3 * x + 2] = static_cast<uint8_t>(std::min(255, v + 6));
+            } else {
+                dst[x] = static_cast<uint8_t>(v);
+            }
+        }
+    }
+
+    frameIndex_++;
+    return nowNs;
+}
@@ -0,0 +1,111 @@
+#ifndef SYNTHETIC_SCENE_HPP
+#define SYNTHETIC_SCENE_HPP
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+/*
+ * 합성 컨베이어 장면 설정
+ * - 해상도/프레임레이트/벨트 속도를 바꿔가며 감지 엔진을 카메라 없이 돌리기 위한 것
+ * - beltSpeed: 픽셀/초 (0이면 폭의 40%/초)
+ * - spawnInterval / spawnJitter: 병 투입 간격(초)과 그 흔들림(±초)
+ * - noiseSigma: 픽셀 가우시안 노이즈 표준편차
+ * - driftAmplitude / driftPeriod: 전체 밝기 변화 비율(예: 0.05 = ±5%)과 주기(초)
+ * - lightStep / lightStepPeriod: 조명 on/off 같은 계단식 밝기 변화(예: 0.3 = 30% 밝아짐)와
+ *   전환 주기(초) - 주기마다 원래 밝기와 바뀐 밝기를 번갈아 사용
+ */
+struct SceneConfig {
+    int width = 320;
+    int height = 240;
+    double fps = 30.0;
+    double beltSpeed = 0.0;
+    double spawnInterval = 1.5;
+    double spawnJitter = 0.3;
+    double noiseSigma = 3.0;
+    double driftAmplitude = 0.01;
+    double driftPeriod = 20.0;
+    double lightStep = 0.0;
+    double lightStepPeriod = 7.0;
+    bool color = true;       // true: BGR, false: 그레이
+    uint64_t seed = 1234;
+};
+
+/*
+ * 정답 구간 - 병이 ROI 사각형과 겹쳐 있던 시간
+ */
+struct GroundTruthInterval {
+    int bottleId;
+    int64_t enterNs;
+    int64_t exitNs;          // 아직 겹쳐 있으면 -1
+};
+
+/*
+ * 벨트 위를 왼쪽 → 오른쪽으로 지나가는 병 모양 물체를 그리는 장면 생성기
+ * - render()를 부를 때마다 1/fps 초씩 진행
+ * - 노이즈는 미리 만든 노이즈 프레임 뱅크에서 골라 더하므로 생성 비용이 작음
+ */
+class SyntheticScene {
+public:
+    explicit SyntheticScene(const SceneConfig& cfg = SceneConfig());
+
+    /*
+     * 다음 프레임 생성
+     * - out: BGR 또는 그레이 (재할당 없이 재사용)
+     * - 반환값: 프레임 시각 (ns, 0부터 시작)
+     */
+    int64_t render(cv::Mat& out);
+
+    /*
+     * 벨트 중앙을 가로지르는 세로 띠 모양 ROI (병 길이의 절반 폭)
+     */
+    std::vector<cv::Point> suggestedRoi() const;
+
+    /*
+     * ROI 사각형 기준 정답 구간 추적 시작 (render() 전에 호출)
+     */
+    void trackRoi(const cv::Rect& roi) { trackedRoi_ = roi; }
+    const std::vector<GroundTruthInterval>& groundTruth() const { return truth_; }
+
+    /*
+     * 병 하나가 ROI를 완전히 덮을 때의 대략적인 SAD (임계값 기본값 계산용)
+     */
+    double nominalBottleSad(const cv::Rect& roi) const;
+
+    const SceneConfig& config() const { return cfg_; }
+    int bottleLength() const { return bottleLength_; }
+    int bottleWidth() const { return bottleWidth_; }
+
+private:
+    struct Bottle {
+        int id;
+        double x;            // 병 왼쪽 끝 x 좌표
+        int y;               // 병 중심 y 좌표
+        int shade;           // 병 밝기
+        bool inRoi;
+    };
+
+    void spawnIfDue();
+    void drawBottle(cv::Mat& canvas, const Bottle& b) const;
+    void updateGroundTruth(int64_t nowNs);
+
+    SceneConfig cfg_;
+    cv::RNG rng_;
+    cv::Mat background_;                 // 벨트 무늬 (그레이)
+    cv::Mat canvas_;                     // 병까지 그린 그레이 장면
+    std::vector<std::vector<int8_t>> noiseBank_;
+    std::vector<Bottle> bottles_;
+    std::vector<GroundTruthInterval> truth_;
+    cv::Rect trackedRoi_;
+
+    int bottleLength_;
+    int bottleWidth_;
+    int beltTop_;
+    int beltBottom_;
+    double speed_;
+    uint64_t frameIndex_ = 0;
+    double nextSpawnSec_ = 0.2;
+    int nextBottleId_ = 0;
+};
+
+#endif
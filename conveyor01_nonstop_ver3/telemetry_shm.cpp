@@ -0,0 +1,151 @@
+#include "telemetry_shm.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace telemetry {
+
+StageLatency LatencySampler::summarize() const {
+    StageLatency result{0.0f, 0.0f, 0.0f, 0.0f};
+    if (count_ == 0) return result;
+
+    float sorted[kCapacity];
+    std::copy(samples_, samples_ + count_, sorted);
+    std::sort(sorted, sorted + count_);
+
+    auto at = [&](double p) { return sorted[static_cast<int>(p * (count_ - 1))]; };
+    result.p50Us = at(0.50);
+    result.p90Us = at(0.90);
+    result.p99Us = at(0.99);
+    result.maxUs = sorted[count_ - 1];
+    return result;
+}
+
+// --- 쓰는 쪽 ---
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+bool TelemetryWriter::open(const std::string& name) {
+    close();
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "[텔레메트리] shm_open(" << name << ") 실패 - " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, sizeof(TelemetryBlock)) != 0) {
+        std::cerr << "[텔레메트리] ftruncate 실패 - " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* addr = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "[텔레메트리] mmap 실패 - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 이전 실행의 블록이 남아 있을 수 있으므로 magic부터 지우고 새로 초기화
+    block_ = static_cast<TelemetryBlock*>(addr);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    block_->magic = 0;
+    std::memset(&block_->data, 0, sizeof(TelemetryData));
+    block_->version = kTelemetryVersion;
+    block_->size = sizeof(TelemetryBlock);
+    block_->writerPid = static_cast<uint32_t>(getpid());
+    block_->seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    block_->magic = kTelemetryMagic;
+
+    name_ = name;
+    std::cout << "[텔레메트리] 공유 메모리: /dev/shm" << name << " (" << sizeof(TelemetryBlock)
+              << " bytes, v" << kTelemetryVersion << ")" << std::endl;
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!block_) return;
+    munmap(block_, sizeof(TelemetryBlock));
+    shm_unlink(name_.c_str());
+    block_ = nullptr;
+}
+
+void TelemetryWriter::publish(const TelemetryData& data) {
+    if (!block_) return;
+
+    uint64_t seq = block_->seq.load(std::memory_order_relaxed);
+    block_->seq.store(seq + 1, std::memory_order_relaxed);   // 홀수: 쓰는 중
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&block_->data, &data, sizeof(TelemetryData));
+    block_->seq.store(seq + 2, std::memory_order_release);   // 짝수: 완료
+}
+
+// --- 읽는 쪽 ---
+
+TelemetryReader::~TelemetryReader() {
+    close();
+}
+
+bool TelemetryReader::open(const std::string& name) {
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error_ = "shm_open(" + name + ") 실패 - " + strerror(errno) + " (감지기가 실행 중인지 확인)";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(TelemetryBlock))) {
+        error_ = "공유 메모리 크기가 맞지 않음 (레이아웃이 다른 감지기 버전)";
+        ::close(fd);
+        return false;
+    }
+    void* addr = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error_ = std::string("mmap 실패 - ") + strerror(errno);
+        return false;
+    }
+
+    const TelemetryBlock* block = static_cast<const TelemetryBlock*>(addr);
+    uint32_t magic = block->magic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (magic != kTelemetryMagic || block->version != kTelemetryVersion ||
+        block->size != sizeof(TelemetryBlock)) {
+        error_ = "텔레메트리 버전 불일치 (magic/version/size)";
+        munmap(addr, sizeof(TelemetryBlock));
+        return false;
+    }
+
+    block_ = block;
+    return true;
+}
+
+void TelemetryReader::close() {
+    if (!block_) return;
+    munmap(const_cast<TelemetryBlock*>(block_), sizeof(TelemetryBlock));
+    block_ = nullptr;
+}
+
+bool TelemetryReader::read(TelemetryData& out, int maxRetries) const {
+    if (!block_) return false;
+
+    for (int i = 0; i < maxRetries; i++) {
+        uint64_t before = block_->seq.load(std::memory_order_acquire);
+        if (before & 1) continue;   // 쓰는 중
+        std::memcpy(&out, &block_->data, sizeof(TelemetryData));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = block_->seq.load(std::memory_order_relaxed);
+        if (before == after) return true;
+    }
+    return false;
+}
+
+}  // namespace telemetry
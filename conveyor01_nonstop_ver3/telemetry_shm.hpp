@@ -0,0 +1,182 @@
+#ifndef TELEMETRY_SHM_HPP
+#define TELEMETRY_SHM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "line_metrics.hpp"
+#include "frame_loss.hpp"
+
+/*
+ * 감지기 → 다른 프로세스(대시보드, MQTT 브리지 등) 실시간 상태 공유
+ *
+ * - POSIX 공유 메모리(/dev/shm)에 고정 레이아웃 블록 하나를 두고 감지기가 갱신
+ * - 쓰기는 seqlock: seq를 홀수로 → 데이터 쓰기 → seq를 짝수로
+ *   읽는 쪽은 seq가 짝수이고 복사 전후 값이 같을 때만 사용 (락/시스템 콜 없음)
+ * - 레이아웃을 바꾸면 kTelemetryVersion을 올릴 것 (읽는 쪽은 버전이 다르면 거부)
+ */
+
+namespace telemetry {
+
+constexpr uint32_t kTelemetryMagic = 0x4D4C5444;   // "DTLM"
+constexpr uint32_t kTelemetryVersion = 5;
+constexpr const char* kDefaultShmName = "/factory_detect";
+constexpr int kMaxEvents = 16;
+constexpr int kMaxRois = 4;
+
+// 단계별 지연 시간 (마이크로초)
+enum Stage : uint32_t {
+    STAGE_QUEUE = 0,     // 캡처 완료 → 감지 시작 (프레임 슬롯 대기)
+    STAGE_PROCESS = 1,   // 감지 엔진 처리 (그레이/블러/SAD/디바운스)
+    STAGE_TOTAL = 2,     // 캡처 완료 → 감지 완료
+    STAGE_COUNT = 3
+};
+
+struct StageLatency {
+    float p50Us;
+    float p90Us;
+    float p99Us;
+    float maxUs;
+};
+
+enum EventType : uint32_t {
+    EVENT_ENTER = 0,     // 병 감지
+    EVENT_EXIT = 1       // 병 통과 완료
+};
+
+struct EventRecord {
+    uint32_t type;
+    uint32_t roiId;
+    uint64_t frameIndex;
+    int64_t timestampNs;   // steady_clock 기준 캡처 시각
+    int64_t durationNs;    // Enter: 직전 병과의 간격(-1: 첫 병), Exit: 머문 시간
+    double sad;
+    double threshold;
+};
+
+/*
+ * seqlock으로 보호되는 데이터 (고정 크기 필드만 사용)
+ * - events는 링 버퍼: 마지막 이벤트는 events[(eventCount - 1) % kMaxEvents]
+ * - roiMetrics: ROI별 라인 처리량 지표 (앞의 roiCount개만 유효)
+ * - frameLoss / frameLossRates: 프레임 손실 누적과 최근 1분 비율 (FrameLossMonitor 참고)
+ */
+struct TelemetryData {
+    int64_t updatedNs;         // steady_clock 기준 마지막 갱신 시각
+    uint64_t frameCount;
+    double fps;
+    double currentSad;
+    double averageSad;
+    double threshold;
+    double illumGain;          // 조명 보정 (기준 프레임 x gain + offset)
+    double illumOffset;
+    uint32_t bottlePresent;
+    uint32_t detecting;
+    uint32_t width;
+    uint32_t height;
+    uint32_t threads;
+    uint32_t reserved0;
+
+    StageLatency stages[STAGE_COUNT];
+
+    uint64_t rejectedFrames;   // 크기가 맞지 않아 거부된 프레임
+    FrameLossCounters frameLoss;
+    FrameLossRates frameLossRates;
+
+    uint64_t eventCount;       // 지금까지 발생한 이벤트 수
+    EventRecord events[kMaxEvents];
+
+    uint32_t roiCount;
+    uint32_t reserved1;
+    LineMetricsSnapshot roiMetrics[kMaxRois];
+};
+
+struct alignas(64) TelemetryBlock {
+    uint32_t magic;            // 초기화가 끝나면 마지막에 기록
+    uint32_t version;
+    uint32_t size;             // sizeof(TelemetryBlock)
+    uint32_t writerPid;
+    std::atomic<uint64_t> seq;
+    alignas(64) TelemetryData data;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics");
+static_assert(offsetof(TelemetryBlock, data) == 64, "telemetry layout changed - bump kTelemetryVersion");
+static_assert(sizeof(EventRecord) == 48, "telemetry layout changed - bump kTelemetryVersion");
+static_assert(std::is_trivially_copyable<LineMetricsSnapshot>::value, "metrics snapshot must be plain data");
+static_assert(std::is_trivially_copyable<FrameLossCounters>::value &&
+              std::is_trivially_copyable<FrameLossRates>::value, "frame loss data must be plain data");
+
+/*
+ * 지연 시간 표본 링 버퍼 (단일 스레드용)
+ * - add()는 배열에 한 번 쓰기만 하고, 백분위는 summarize() 호출 시에만 계산
+ */
+class LatencySampler {
+public:
+    static constexpr int kCapacity = 256;
+
+    void add(float us) {
+        samples_[pos_] = us;
+        pos_ = (pos_ + 1) % kCapacity;
+        if (count_ < kCapacity) count_++;
+    }
+
+    StageLatency summarize() const;
+
+private:
+    float samples_[kCapacity] = {};
+    int pos_ = 0;
+    int count_ = 0;
+};
+
+/*
+ * 쓰는 쪽 (감지기, 한 스레드에서만 publish)
+ */
+class TelemetryWriter {
+public:
+    ~TelemetryWriter();
+
+    /*
+     * 공유 메모리 생성 및 매핑 - 실패하면 원인 출력 후 false (감지기는 계속 동작)
+     */
+    bool open(const std::string& name = kDefaultShmName);
+    void close();
+    bool isOpen() const { return block_ != nullptr; }
+
+    void publish(const TelemetryData& data);
+
+private:
+    std::string name_;
+    TelemetryBlock* block_ = nullptr;
+};
+
+/*
+ * 읽는 쪽 (다른 프로세스, 읽기 전용 매핑)
+ */
+class TelemetryReader {
+public:
+    ~TelemetryReader();
+
+    /*
+     * 매핑 후 magic / version / size 확인 - 실패하면 error()에 원인
+     */
+    bool open(const std::string& name = kDefaultShmName);
+    void close();
+    const std::string& error() const { return error_; }
+
+    /*
+     * 일관된 스냅샷 복사 - 쓰는 중이면 재시도, maxRetries 넘으면 false
+     */
+    bool read(TelemetryData& out, int maxRetries = 1000) const;
+
+    uint32_t writerPid() const { return block_ ? block_->writerPid : 0; }
+
+private:
+    const TelemetryBlock* block_ = nullptr;
+    std::string error_;
+};
+
+}  // namespace telemetry
+
+#endif
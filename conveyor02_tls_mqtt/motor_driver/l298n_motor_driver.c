@@ -19,6 +19,8 @@
 #include <linux/ktime.h>
 #include <linux/spinlock.h>
 
+#include "factory_cmd_abi.h"  /* 바이너리 명령 ABI (../../mqtt_bridge) */
+
 #define DEVICE_NAME "l298n_motor"
 #define CLASS_NAME "motor"
 
@@ -62,12 +64,14 @@ static int motor_open(struct inode*, struct file*);
 static int motor_release(struct inode*, struct file*);
 static ssize_t motor_write(struct file*, const char*, size_t, loff_t*);
 static ssize_t motor_read(struct file*, char*, size_t, loff_t*);
+static long motor_ioctl(struct file*, unsigned int, unsigned long);
 
 /* 파일 연산 구조체 */
 static struct file_operations fops = {
     .open = motor_open,
     .read = motor_read,
     .write = motor_write,
+    .unlocked_ioctl = motor_ioctl,
     .release = motor_release,
 };
 
@@ -494,6 +498,54 @@ static ssize_t motor_write(struct file *filep, const char *buffer, size_t len, l
     return len;
 }
 
+/* 바이너리 명령 (factory_cmd_abi.h) - 모터 하나 제어 / 모드 OFF(전체 정지) */
+static long motor_ioctl(struct file *filep, unsigned int cmd, unsigned long arg) {
+    struct factory_motor_cmd motor_cmd;
+    struct factory_mode_cmd mode_cmd;
+    
+    switch (cmd) {
+    case FACTORY_IOC_VERSION:
+        return put_user((__u32)FACTORY_CMD_ABI_VERSION, (__u32 __user *)arg);
+        
+    case FACTORY_IOC_MOTOR:
+        if (copy_from_user(&motor_cmd, (void __user *)arg, sizeof(motor_cmd))) {
+            return -EFAULT;
+        }
+        if (motor_cmd.version != FACTORY_CMD_ABI_VERSION) {
+            return -EPROTO;
+        }
+        /* 텍스트 명령과 같은 범위 검증 */
+        if (motor_cmd.direction < -1 || motor_cmd.direction > 1 ||
+            motor_cmd.speed < 0 || motor_cmd.speed > 100) {
+            return -EINVAL;
+        }
+        if (motor_cmd.motor == FACTORY_MOTOR_A) {
+            motor_a_control(motor_cmd.direction, motor_cmd.speed);
+        } else if (motor_cmd.motor == FACTORY_MOTOR_B) {
+            motor_b_control(motor_cmd.direction, motor_cmd.speed);
+        } else {
+            return -EINVAL;
+        }
+        return 0;
+        
+    case FACTORY_IOC_MODE:
+        if (copy_from_user(&mode_cmd, (void __user *)arg, sizeof(mode_cmd))) {
+            return -EFAULT;
+        }
+        if (mode_cmd.version != FACTORY_CMD_ABI_VERSION) {
+            return -EPROTO;
+        }
+        if (mode_cmd.mode != FACTORY_MODE_OFF) {
+            return -EINVAL;
+        }
+        motor_stop_all();
+        return 0;
+        
+    default:
+        return -ENOTTY;
+    }
+}
+
 static int motor_release(struct inode *inodep, struct file *filep) {
     printk(KERN_INFO "L298N Driver: 디바이스 닫힘\n");
     return 0;
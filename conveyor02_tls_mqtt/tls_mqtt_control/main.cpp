@@ -1,27 +1,9 @@
 #include "mqtt_tls_conveyor.hpp"
 #include <iostream>
-#include <signal.h>
 #include <memory>
 
-// 전역 컨트롤러 포인터 (시그널 핸들러용)
-std::unique_ptr<MqttTlsConveyor> g_controller = nullptr;
-
-// 시그널 핸들러
-void signal_handler(int sig) {
-    std::cout << COLOR_YELLOW << "\n\n프로그램을 종료합니다..." << COLOR_RESET << std::endl;
-    if (g_controller) {
-        g_controller->stop();
-        g_controller->cleanup();
-    }
-    std::cout << COLOR_GREEN << "안전하게 종료되었습니다." << COLOR_RESET << std::endl;
-    exit(0);
-}
-
 int main(int argc, char* argv[]) {
-    // 시그널 핸들러 등록
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
-
+    // SIGINT/SIGTERM은 컨트롤러의 이벤트 루프가 signalfd로 받아 run()을 끝냄
     try {
         // 기본 설정
         MqttConfig config;
@@ -39,20 +21,23 @@ int main(int argc, char* argv[]) {
         }
 
         // 컨트롤러 생성
-        g_controller = std::make_unique<MqttTlsConveyor>(config);
+        auto controller = std::make_unique<MqttTlsConveyor>(config);
 
         // 모터 디바이스 열기
-        if (!g_controller->open_device()) {
+        if (!controller->open_device()) {
             return EXIT_FAILURE;
         }
 
         // MQTT 브로커에 연결
-        if (!g_controller->connect()) {
+        if (!controller->connect()) {
             return EXIT_FAILURE;
         }
 
-        // 메인 루프 실행
-        g_controller->run();
+        // 메인 루프 실행 (종료 시그널까지)
+        controller->run();
+
+        controller->cleanup();
+        std::cout << COLOR_GREEN << "안전하게 종료되었습니다." << COLOR_RESET << std::endl;
 
     } catch (const std::exception& e) {
         std::cerr << COLOR_RED << "예외 발생: " << e.what() << COLOR_RESET << std::endl;
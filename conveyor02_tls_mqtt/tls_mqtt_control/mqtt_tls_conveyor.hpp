@@ -1,14 +1,9 @@
 #ifndef MQTT_TLS_CONVEYOR_HPP
 #define MQTT_TLS_CONVEYOR_HPP
 
-#include <mosquitto.h>
+#include "device_policies.hpp"
 #include <string>
 #include <iostream>
-#include <chrono>
-#include <thread>
-#include <fcntl.h>
-#include <unistd.h>
-#include <cstring>
 
 // 색상 정의
 #define COLOR_RESET   "\033[0m"
@@ -19,9 +14,6 @@
 #define COLOR_CYAN    "\033[36m"
 #define COLOR_BOLD    "\033[1m"
 
-#define DEVICE_PATH "/dev/l298n_motor"
-#define MAX_COMMAND_LEN 50
-
 struct MqttConfig {
     std::string broker_host = "mqtt.kwon.pics";
     int broker_port = 8883;
@@ -41,26 +33,17 @@ struct MqttConfig {
           use_tls(tls), auto_detect_device_id(auto_id), subscribe_topic(topic) {}
 };
 
+/*
+ * L298N 컨베이어 제어기 - mqtt_bridge의 DeviceBridge<L298nPolicy> 위의 얇은 래퍼
+ * - 연결 / 명령 해석 / 디바이스 I/O / 상태 발행은 브리지 라이브러리가 처리
+ * - 이 클래스는 기존 인터페이스(MqttConfig, send_motor_command 등)만 유지
+ * - MQTT 소켓 / keepalive / SIGINT·SIGTERM은 이벤트 루프 하나에서 처리 (run()이 루프를 돌림)
+ */
 class MqttTlsConveyor {
 private:
-    struct mosquitto *mosq;
     MqttConfig config;
-    bool connected;
-    bool running;
-    int device_fd;
-    std::string device_id;
-    
-    // 모터 상태
-    int current_motor_a_speed;
-    int current_motor_b_speed;
-    int current_motor_a_dir;   // -1: 역방향, 0: 정지, 1: 정방향
-    int current_motor_b_dir;
-
-    // 콜백 함수
-    static void on_connect_callback(struct mosquitto *mosq, void *userdata, int result);
-    static void on_disconnect_callback(struct mosquitto *mosq, void *userdata, int result);
-    static void on_message_callback(struct mosquitto *mosq, void *userdata, const struct mosquitto_message *message);
-    static void on_publish_callback(struct mosquitto *mosq, void *userdata, int mid);
+    EventLoop loop;   // bridge보다 먼저 선언 (bridge 정리 시 루프에서 소켓 / 타이머 해제)
+    DeviceBridge<L298nPolicy> bridge;
 
 public:
     MqttTlsConveyor(const MqttConfig &cfg = MqttConfig());
@@ -69,32 +52,25 @@ public:
     // MQTT 연결 관리
     bool connect();
     void disconnect();
-    bool isConnected() const { return connected; }
+    bool isConnected() const { return bridge.session().isConnected(); }
     
     // 디바이스 제어
     bool open_device();
     void close_device();
+    // 브리지 명령 대기열은 생산자 하나(lock-free SPSC) - 이벤트 루프 스레드(MQTT 콜백)에서만 호출
     void send_motor_command(char motor, int direction, int speed);
     void process_motor_command(const std::string& topic, const std::string& message);
     
     // 메시지 발행
     bool publishStatus(const std::string &status, const std::string &metadata = "");
     
-    // 실행 제어
+    // 실행 제어 (run(): stop() 또는 SIGINT/SIGTERM까지 이벤트 루프 실행, stop()은 어느 스레드에서나)
     void run();
     void stop();
     void cleanup();
     
     // 현재 device_id 반환
-    std::string getDeviceId() const { return device_id; }
-
-private:
-    long long getCurrentTimestampMs();
-    std::string createJsonMessage(const std::string &status, const std::string &metadata);
-    void extractDeviceIdFromCert();
-    void setupCallbacks();
-    void setupTls();
-    std::string getFormattedTopic(const std::string& topic_template);
+    std::string getDeviceId() const { return bridge.session().deviceId(); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "gateway.hpp"
+#include <cstdlib>
+
+/*
+ * 호스트 게이트웨이 (장치 여러 개 → MQTT TLS 연결 하나)
+ * - 사용법: factory_gateway [설정 파일] (기본 /etc/factory/gateway.conf, 형식은 gateway.conf 참고)
+ * - 인증서: CERT_PATH 환경 변수 디렉토리 (기본 /certs)의 <이름>.crt / .key / ca.crt
+ *   <이름>은 GATEWAY_CERT_NAME 환경 변수 (기본 gateway), 클라이언트 ID는 인증서 CN
+ * - 장치별 명령 해석 / 디바이스 I/O는 mqtt_bridge 라이브러리 정책 그대로 (장치마다 디바이스 스레드 하나)
+ */
+int main(int argc, char* argv[]) {
+    std::string configPath = argc > 1 ? argv[1] : "/etc/factory/gateway.conf";
+    const char* certName = getenv("GATEWAY_CERT_NAME");
+
+    BridgeConfig config = certConfigFromEnv("/certs", certName != nullptr ? certName : "gateway");
+    std::vector<GatewayDeviceConfig> devices;
+    if (!loadGatewayConfig(configPath, config, devices)) return 1;
+    return runGateway(config, devices);
+}
@@ -7,6 +7,8 @@
 #include <linux/delay.h>
 #include <linux/jiffies.h>
 
+#include "factory_cmd_abi.h" // 바이너리 명령 ABI (../mqtt_bridge)
+
 
 
 MODULE_LICENSE("GPL");
@@ -100,32 +102,56 @@ static int motor_func(void *data) {
 }
 
 
-// echo 명령어 받는 부분
-static ssize_t feeder_write(struct file *file, const char __user *buf, size_t len, loff_t *offset) {
-    if (len > BUF_LEN - 1)
-        return -EINVAL;
-
-    if (copy_from_user(command_buffer, buf, len))
-        return -EFAULT;
-
-    command_buffer[len] = '\0';
-
-    if (strncmp(command_buffer, "on", 2) == 0) { //켜고
+// 모드 변경 (텍스트 명령이랑 ioctl이 같이 씀)
+static int feeder_set_mode(int mode) {
+    switch (mode) {
+    case FACTORY_MODE_ON: //켜고
         direction = -1;
         running = true;
-    } else if (strncmp(command_buffer, "reverse", 7) == 0) { //역방향 회전
+        break;
+    case FACTORY_MODE_REVERSE: //역방향 회전
         direction = 1;
         running = true;
-    } else if (strncmp(command_buffer, "off", 3) == 0) { //끄기
+        break;
+    case FACTORY_MODE_OFF: //끄기
         running = false;
         for (int i = 0; i < 4; i++)
             gpio_set_value(pins[i], 0);
-    } else if (strncmp(command_buffer, "error", 5) == 0) {  //에러 모드
+        break;
+    case FACTORY_MODE_ERROR: //에러 모드
         error_mode = true;
         running = true;
-    } else if (strncmp(command_buffer, "normal", 6) == 0) {  // 속도 복구 모드
+        break;
+    case FACTORY_MODE_NORMAL: // 속도 복구 모드
         error_mode = false;
         running = true;
+        break;
+    default:
+        return -EINVAL;
+    }
+    return 0;
+}
+
+// echo 명령어 받는 부분
+static ssize_t feeder_write(struct file *file, const char __user *buf, size_t len, loff_t *offset) {
+    if (len > BUF_LEN - 1)
+        return -EINVAL;
+
+    if (copy_from_user(command_buffer, buf, len))
+        return -EFAULT;
+
+    command_buffer[len] = '\0';
+
+    if (strncmp(command_buffer, "on", 2) == 0) {
+        feeder_set_mode(FACTORY_MODE_ON);
+    } else if (strncmp(command_buffer, "reverse", 7) == 0) {
+        feeder_set_mode(FACTORY_MODE_REVERSE);
+    } else if (strncmp(command_buffer, "off", 3) == 0) {
+        feeder_set_mode(FACTORY_MODE_OFF);
+    } else if (strncmp(command_buffer, "error", 5) == 0) {
+        feeder_set_mode(FACTORY_MODE_ERROR);
+    } else if (strncmp(command_buffer, "normal", 6) == 0) {
+        feeder_set_mode(FACTORY_MODE_NORMAL);
     }else {
         printk(KERN_INFO "Unknown command: %s\n", command_buffer);
     }
@@ -133,9 +159,30 @@ static ssize_t feeder_write(struct file *file, const char __user *buf, size_t le
     return len;
 }
 
+// 바이너리 명령 (factory_cmd_abi.h) - 피더는 모드만 있음
+static long feeder_ioctl(struct file *file, unsigned int cmd, unsigned long arg) {
+    struct factory_mode_cmd mode_cmd;
+
+    switch (cmd) {
+    case FACTORY_IOC_VERSION:
+        return put_user((__u32)FACTORY_CMD_ABI_VERSION, (__u32 __user *)arg);
+
+    case FACTORY_IOC_MODE:
+        if (copy_from_user(&mode_cmd, (void __user *)arg, sizeof(mode_cmd)))
+            return -EFAULT;
+        if (mode_cmd.version != FACTORY_CMD_ABI_VERSION)
+            return -EPROTO;
+        return feeder_set_mode(mode_cmd.mode);
+
+    default:
+        return -ENOTTY;
+    }
+}
+
 static struct file_operations fops = {
     .owner = THIS_MODULE,
     .write = feeder_write,
+    .unlocked_ioctl = feeder_ioctl,
 };
 
 // insmod 초기화
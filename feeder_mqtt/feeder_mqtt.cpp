@@ -5,6 +5,7 @@
 #include <QTimer>
 #include <QtMqtt/QMqttSubscription>
 #include <QtMqtt/QMqttTopicFilter>
+#include "qt_reconnect.hpp"
 
 int main(int argc, char *argv[]) {
     QCoreApplication app(argc, argv);
@@ -12,11 +13,12 @@ int main(int argc, char *argv[]) {
     QMqttClient client;
     client.setHostname("mqtt.kwon.pics");   // 브로커 주소 (확인 해야 됨)
     client.setPort(1883);   // 일반 MQTT 포트 (TLS면 8883)
+    QtMqttReconnect reconnect(client);   // 끊기면 빠른 첫 재시도 후 지수 증가 + 지터
     client.connectToHost();
 
     QObject::connect(&client, &QMqttClient::connected, [&]() {
         qInfo("MQTT connected");
-        client.subscribe(QMqttTopicFilter("feeder_02/cmd"));  // "feeder/cmd" 토픽
+        reconnect.trackSubscription(client.subscribe(QMqttTopicFilter("feeder_02/cmd")));  // "feeder/cmd" 토픽
     });
 
     QObject::connect(&client, &QMqttClient::messageReceived,
@@ -40,7 +42,5 @@ int main(int argc, char *argv[]) {
         }
     );
 
-    QTimer::singleShot(10000, &client, SLOT(connectToHost()));  // 10초 후 재연결함
-
     return app.exec();
 }
@@ -0,0 +1,91 @@
+#ifndef COMMAND_COALESCER_HPP
+#define COMMAND_COALESCER_HPP
+
+#include "command_table.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * 아직 드라이버로 보내지 않은 명령 (최신 설정값만 남김)
+ *
+ * - 설정값 명령(서보 각도, 모터 방향/속도): 액추에이터마다 슬롯 하나
+ *   같은 액추에이터 값이 아직 대기 중이면 새 값으로 덮어씀 → 대시보드 슬라이더 연속 입력이 한 번으로 합쳐짐
+ * - 이산 명령(on/off/init 등): 받은 순서대로 쌓이고 합치기 경계가 됨
+ *   경계 앞의 설정값은 경계 앞에서, 경계 뒤의 설정값은 경계 뒤에서 실행 (이산 명령 순서는 그대로)
+ * - 스레드 안전하지 않음 (DeviceBridge의 디바이스 스레드만 사용 - SPSC 대기열에서 꺼낸 뒤 합치므로 잠금 없음)
+ */
+template <size_t Slots, size_t Capacity = 64>
+class CommandCoalescer {
+public:
+    struct Entry {
+        DeviceCommand command;
+        int slot;              // -1: 이산 명령
+    };
+
+    CommandCoalescer() { resetSlots(); }
+
+    /*
+     * slot: 액추에이터 번호 (0 ~ Slots-1), 이산 명령은 -1
+     * 반환값: false면 대기열이 가득 차서 버림
+     */
+    bool push(const DeviceCommand& cmd, int slot) {
+        bool setpoint = slot >= 0 && static_cast<size_t>(slot) < Slots;
+        if (setpoint && latest_[slot] >= 0) {
+            entries_[latest_[slot]].command = cmd;
+            coalesced_[slot]++;
+            return true;
+        }
+
+        if (size_ == Capacity) {
+            dropped_++;
+            return false;
+        }
+
+        if (setpoint) {
+            latest_[slot] = static_cast<int16_t>(size_);
+        } else {
+            slot = -1;
+            resetSlots();
+        }
+        entries_[size_++] = {cmd, slot};
+        return true;
+    }
+
+    /*
+     * 대기 중인 명령을 순서대로 out으로 옮기고 비움
+     * 반환값: 옮긴 개수
+     */
+    size_t take(Entry (&out)[Capacity]) {
+        size_t n = size_;
+        for (size_t i = 0; i < n; i++) out[i] = entries_[i];
+        size_ = 0;
+        resetSlots();
+        return n;
+    }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    uint64_t coalesced() const {
+        uint64_t total = 0;
+        for (size_t s = 0; s < Slots; s++) total += coalesced_[s];
+        return total;
+    }
+    uint64_t coalesced(size_t slot) const { return slot < Slots ? coalesced_[slot] : 0; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    static constexpr size_t kSlotArray = Slots > 0 ? Slots : 1;
+
+    void resetSlots() {
+        for (size_t s = 0; s < kSlotArray; s++) latest_[s] = -1;
+    }
+
+    Entry entries_[Capacity] = {};
+    size_t size_ = 0;
+    int16_t latest_[kSlotArray];               // 슬롯별 마지막 경계 이후 대기 중인 항목 위치
+    uint64_t coalesced_[kSlotArray] = {};
+    uint64_t dropped_ = 0;
+};
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef COMMAND_TABLE_HPP
+#define COMMAND_TABLE_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*
+ * MQTT 페이로드 → 장치 명령 해석 (할당 없음)
+ *
+ * - DeviceCommand: 해석 결과 (정책별 명령 번호 + 정수 인자) - 드라이버 전송은 이 값으로만 함
+ * - CommandTable: 정책 명령 표로 컴파일 시간에 만든 완전 해시 (슬롯 충돌 없는 seed를 constexpr로 탐색)
+ *   조회 = 소문자 변환하면서 해시 한 번 + 슬롯 하나와 문자열 비교 한 번
+ * - 페이로드는 스택 버퍼로 한 번만 복사하면서 소문자 변환 / 해시를 같이 계산
+ */
+
+struct DeviceCommand {
+    static constexpr int kMaxArgs = 3;
+
+    uint8_t op = 0;          // 정책의 Op 값
+    uint8_t argc = 0;
+    int32_t args[kMaxArgs] = {0, 0, 0};
+};
+
+/*
+ * 명령 표 항목: MQTT 페이로드(소문자) → 해석 결과
+ */
+struct CommandEntry {
+    std::string_view payload;
+    DeviceCommand command;
+};
+
+constexpr DeviceCommand makeCommand(uint8_t op) {
+    DeviceCommand cmd;
+    cmd.op = op;
+    return cmd;
+}
+
+constexpr DeviceCommand makeCommand(uint8_t op, int32_t a0, int32_t a1) {
+    DeviceCommand cmd;
+    cmd.op = op;
+    cmd.argc = 2;
+    cmd.args[0] = a0;
+    cmd.args[1] = a1;
+    return cmd;
+}
+
+constexpr DeviceCommand makeCommand(uint8_t op, int32_t a0, int32_t a1, int32_t a2) {
+    DeviceCommand cmd;
+    cmd.op = op;
+    cmd.argc = 3;
+    cmd.args[0] = a0;
+    cmd.args[1] = a1;
+    cmd.args[2] = a2;
+    return cmd;
+}
+
+constexpr char foldCase(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/*
+ * seed를 섞은 FNV-1a (컴파일 시간 표 생성과 실행 시간 조회가 같은 함수 사용)
+ */
+constexpr uint32_t commandHashStep(uint32_t h, char c) {
+    return (h ^ static_cast<uint8_t>(c)) * 16777619u;
+}
+
+constexpr uint32_t commandHashInit(uint32_t seed) {
+    return 2166136261u ^ (seed * 0x9E3779B9u);
+}
+
+// FNV 곱셈은 하위 비트가 입력 하위 비트에만 의존하므로 슬롯을 고르기 전에 상위 비트를 섞음
+constexpr uint32_t commandHashFinish(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    return h;
+}
+
+constexpr uint32_t commandHash(std::string_view s, uint32_t seed) {
+    uint32_t h = commandHashInit(seed);
+    for (char c : s) h = commandHashStep(h, c);
+    return commandHashFinish(h);
+}
+
+/*
+ * N개 항목용 완전 해시 표 (슬롯 수 = 2N 이상인 2의 거듭제곱)
+ */
+template <size_t N>
+struct CommandTable {
+    static constexpr size_t kSlots = [] {
+        size_t slots = 8;
+        while (slots < 2 * N) slots *= 2;
+        return slots;
+    }();
+    static constexpr uint32_t kMaxSeed = 1u << 16;
+
+    uint32_t seed = 0;
+    int16_t slots[kSlots] = {};
+    bool valid = false;
+
+    constexpr int find(std::string_view folded, uint32_t hash, const CommandEntry (&entries)[N]) const {
+        int index = slots[hash & (kSlots - 1)];
+        if (index >= 0 && entries[index].payload == folded) return index;
+        return -1;
+    }
+};
+
+template <size_t N>
+constexpr CommandTable<N> buildCommandTable(const CommandEntry (&entries)[N]) {
+    using Table = CommandTable<N>;
+    Table table;
+    for (uint32_t seed = 0; seed < Table::kMaxSeed; seed++) {
+        for (size_t s = 0; s < Table::kSlots; s++) table.slots[s] = -1;
+
+        bool collision = false;
+        for (size_t i = 0; i < N && !collision; i++) {
+            size_t slot = commandHash(entries[i].payload, seed) & (Table::kSlots - 1);
+            if (table.slots[slot] >= 0) collision = true;
+            else table.slots[slot] = static_cast<int16_t>(i);
+        }
+        if (!collision) {
+            table.seed = seed;
+            table.valid = true;
+            return table;
+        }
+    }
+    return table;
+}
+
+/*
+ * 페이로드를 out에 소문자로 복사하면서 해시 계산 (앞뒤 공백/개행 제외)
+ * - 반환값: 복사한 길이 (cap 이상이면 잘못된 명령으로 처리할 것)
+ */
+inline size_t foldPayload(const char* payload, size_t len, char* out, size_t cap, uint32_t seed, uint32_t& hash) {
+    size_t begin = 0;
+    while (begin < len && (payload[begin] == ' ' || payload[begin] == '\t' ||
+                           payload[begin] == '\r' || payload[begin] == '\n')) begin++;
+    while (len > begin && (payload[len - 1] == ' ' || payload[len - 1] == '\t' ||
+                           payload[len - 1] == '\r' || payload[len - 1] == '\n')) len--;
+
+    size_t n = len - begin;
+    if (n >= cap) return n;
+
+    uint32_t h = commandHashInit(seed);
+    for (size_t i = 0; i < n; i++) {
+        char c = foldCase(payload[begin + i]);
+        out[i] = c;
+        h = commandHashStep(h, c);
+    }
+    hash = commandHashFinish(h);
+    return n;
+}
+
+/*
+ * 정수 인자 읽기 (from_chars) - 앞 공백은 건너뜀, 성공하면 s를 숫자 뒤로 옮김
+ */
+inline bool parseIntArg(std::string_view& s, int32_t& value) {
+    while (!s.empty() && s.front() == ' ') s.remove_prefix(1);
+    const char* first = s.data();
+    const char* last = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc() || ptr == first) return false;
+    s.remove_prefix(static_cast<size_t>(ptr - first));
+    return true;
+}
+
+/*
+ * 드라이버 텍스트 명령을 고정 버퍼에 쓰기 (to_chars, 할당 없음)
+ */
+class CommandWriter {
+public:
+    CommandWriter(char* buf, size_t cap) : begin_(buf), cur_(buf), end_(buf + cap) {}
+
+    CommandWriter& text(std::string_view s) {
+        if (ok_ && static_cast<size_t>(end_ - cur_) >= s.size()) {
+            for (char c : s) *cur_++ = c;
+        } else {
+            ok_ = false;
+        }
+        return *this;
+    }
+
+    CommandWriter& ch(char c) {
+        if (ok_ && cur_ < end_) *cur_++ = c;
+        else ok_ = false;
+        return *this;
+    }
+
+    CommandWriter& num(int32_t v) {
+        if (!ok_) return *this;
+        auto [ptr, ec] = std::to_chars(cur_, end_, v);
+        if (ec != std::errc()) ok_ = false;
+        else cur_ = ptr;
+        return *this;
+    }
+
+    /*
+     * 반환값: 쓴 길이 (버퍼가 모자랐으면 0)
+     */
+    size_t size() const { return ok_ ? static_cast<size_t>(cur_ - begin_) : 0; }
+
+private:
+    char* begin_;
+    char* cur_;
+    char* end_;
+    bool ok_ = true;
+};
+
+#endif
@@ -0,0 +1,571 @@
+#ifndef DEVICE_BRIDGE_HPP
+#define DEVICE_BRIDGE_HPP
+
+#include "mqtt_session.hpp"
+#include "device_port.hpp"
+#include "command_table.hpp"
+#include "driver_abi.hpp"
+#include "command_coalescer.hpp"
+#include "spsc_queue.hpp"
+#include "telemetry.hpp"
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * 상태 메시지 JSON ({"status":..,"timestamp":..,"metadata":{..}})
+ * - metadata가 비어 있으면 생략
+ */
+inline std::string buildStatusJson(const std::string& status, const std::string& metadata) {
+    auto now = std::chrono::system_clock::now();
+    long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+
+    std::string json = "{\"status\":\"" + status + "\",\"timestamp\":" + std::to_string(ms);
+    if (!metadata.empty()) {
+        json += ",\"metadata\":" + metadata;
+    }
+    json += "}";
+    return json;
+}
+
+/*
+ * 브리지 지표 스냅샷 (DeviceBridge::metrics(), 어느 스레드에서나 조회 가능)
+ * - 대기 시간: 명령이 SPSC 대기열에 들어간 뒤 디바이스 스레드가 꺼낼 때까지
+ * - 처리 시간: 명령 하나를 드라이버로 보내는 데 걸린 시간 (ioctl / write)
+ * - 재구독 시간: 마지막으로 연결이 끊긴 시점부터 명령 토픽 재구독까지
+ */
+struct BridgeMetrics {
+    uint64_t queued = 0;          // 대기열에 넣은 명령
+    uint64_t commands = 0;        // 드라이버로 보낸 명령
+    uint64_t binaryCommands = 0;  // 그중 ioctl로 보낸 명령
+    uint64_t rejected = 0;        // 해석 실패
+    uint64_t dropped = 0;         // 대기열이 가득 차서 버림
+    uint64_t coalesced = 0;       // 최신 값으로 덮어써서 보내지 않은 설정값
+    uint64_t telemetryPublished = 0;   // 텔레메트리 발행 수 (전체 + 변경분)
+    uint64_t telemetrySuppressed = 0;  // 바뀐 필드가 없어서 발행하지 않은 샘플
+    uint64_t telemetryBytes = 0;
+    size_t queueDepth = 0;        // 현재 대기열 길이
+    size_t maxQueueDepth = 0;
+    double avgQueueWaitUs = 0.0;
+    uint64_t maxQueueWaitUs = 0;
+    double avgServiceUs = 0.0;
+    uint64_t maxServiceUs = 0;
+    uint64_t reconnects = 0;      // 재연결 시도
+    int64_t lastResubscribeMs = -1;
+    uint64_t tlsHandshakes = 0;
+    uint64_t tlsResumed = 0;      // 그중 세션 재사용
+};
+
+inline std::ostream& operator<<(std::ostream& os, const BridgeMetrics& m) {
+    return os << "명령 " << m.commands << " (ioctl " << m.binaryCommands << "), 대기열 " << m.queued
+              << ", 합침 " << m.coalesced << ", 버림 " << m.dropped << ", 잘못된 명령 " << m.rejected
+              << " | 텔레메트리 " << m.telemetryPublished << " (생략 " << m.telemetrySuppressed
+              << ", " << m.telemetryBytes << "B)"
+              << " | 대기열 길이 " << m.queueDepth << " (최대 " << m.maxQueueDepth << ")"
+              << " | 대기 평균 " << m.avgQueueWaitUs << "us / 최대 " << m.maxQueueWaitUs << "us"
+              << " | 처리 평균 " << m.avgServiceUs << "us / 최대 " << m.maxServiceUs << "us"
+              << " | 재연결 " << m.reconnects << " (마지막 재구독 " << m.lastResubscribeMs << "ms, TLS 재사용 "
+              << m.tlsResumed << "/" << m.tlsHandshakes << ")";
+}
+
+namespace bridge_detail {
+
+inline int64_t monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * 시간 누적 (한 스레드에서 기록, 아무 스레드에서 조회)
+ */
+class DurationStat {
+public:
+    void record(int64_t ns) {
+        uint64_t us = ns > 0 ? static_cast<uint64_t>(ns / 1000) : 0;
+        count_.fetch_add(1, std::memory_order_relaxed);
+        totalUs_.fetch_add(us, std::memory_order_relaxed);
+        if (us > maxUs_.load(std::memory_order_relaxed)) maxUs_.store(us, std::memory_order_relaxed);
+    }
+
+    double avgUs() const {
+        uint64_t n = count_.load(std::memory_order_relaxed);
+        return n ? static_cast<double>(totalUs_.load(std::memory_order_relaxed)) / static_cast<double>(n) : 0.0;
+    }
+    uint64_t maxUs() const { return maxUs_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> totalUs_{0};
+    std::atomic<uint64_t> maxUs_{0};
+};
+
+}  // namespace bridge_detail
+
+/*
+ * MQTT 명령 토픽 → 커널 드라이버 브리지 (장치별 차이는 정책 타입으로 분리)
+ *
+ * 정책 타입이 제공할 것 (device_policies.hpp 참고)
+ * - kName / kDevicePath / kDefaultDeviceId: 로그용 이름, 기본 디바이스 파일, 기본 device_id
+ * - kReadableStatus: 드라이버 read()로 상태를 읽을 수 있으면 true
+ * - kHasShutdown / kShutdown: 종료할 때 보낼 명령
+ * - Op / kCommands: 명령 번호와 명령 표 (CommandEntry 배열 → 컴파일 시간 완전 해시)
+ * - parsePattern(cmd, out): 표에 없는 인자 있는 명령 해석 (servo0 90 등, from_chars)
+ * - kActuators / actuatorSlot(cmd): 설정값 명령의 액추에이터 번호 (최신 값만 남김), 이산 명령은 -1
+ * - toRequest(cmd, req): DeviceCommand → 바이너리 명령 (factory_cmd_abi.h, 해당 ioctl이 없는 명령은 false)
+ * - format(cmd, buf, cap): DeviceCommand → 드라이버 텍스트 명령 (반환값: 길이, 실패 시 0)
+ *   바이너리 명령을 모르는 이전 드라이버이거나 toRequest()가 false일 때 사용
+ * - State / onCommand(state, cmd) / parseStatus(state, raw) / writeStatus(state, status, metadata)
+ *   : 상태 파서 - 보낸 명령과 드라이버 상태 텍스트로 상태를 갱신하고 상태 토픽 JSON을 만듦
+ * - kTelemetry / sample(state, values): 텔레메트리 필드 (이름 + 정수 값)
+ *
+ * 연결 / 명령 해석 / 디바이스 I/O 경로는 여기 한 곳에만 있으므로 모든 장치에 같이 적용됨
+ * MQTT 세션은 open()으로 직접 만들거나(단독 브리지) attach()로 게이트웨이 세션을 같이 씀
+ *
+ * 스레드
+ * - MQTT 콜백 스레드(이벤트 루프 스레드, 생산자 하나): 해석 후 lock-free SPSC 대기열에 넣기만 함
+ *   → keepalive / 다른 메시지가 드라이버를 기다리지 않음
+ * - 디바이스 스레드(connect()에서 시작, 소비자 하나): 대기열을 비우면서 CommandCoalescer로 합친 뒤 드라이버로 전송,
+ *   묶음마다 상태 발행 한 번. 드라이버 쓰기가 느린 동안 들어온 설정값은 액추에이터별 최신 값 하나로 합쳐짐
+ *   명령이 없을 때는 텔레메트리 주기마다 드라이버 상태를 읽어 바뀐 필드만 발행 (디바이스 I/O는 이 스레드에서만)
+ */
+template <typename Policy>
+class DeviceBridge {
+public:
+    static constexpr size_t kMaxCommandLen = 64;
+    static constexpr size_t kQueueCapacity = 256;   // SPSC 대기열
+    static constexpr size_t kBatchCapacity = 64;    // 한 번에 합쳐서 보내는 최대 명령 수
+    using Coalescer = CommandCoalescer<Policy::kActuators, kBatchCapacity>;
+    static constexpr size_t kTelemetryFields = sizeof(Policy::kTelemetry) / sizeof(Policy::kTelemetry[0]);
+    static constexpr auto kTable = buildCommandTable(Policy::kCommands);
+    static_assert(kTable.valid, "명령 표 완전 해시 seed를 찾지 못함 - 항목이 겹치는지 확인");
+
+    DeviceBridge() = default;
+    ~DeviceBridge() { stopWorker(); }
+
+    DeviceBridge(const DeviceBridge&) = delete;
+    DeviceBridge& operator=(const DeviceBridge&) = delete;
+
+    /*
+     * MQTT 클라이언트 준비 (연결은 connect()에서)
+     */
+    bool open(const BridgeConfig& cfg) {
+        session_ = &ownSession_;
+        if (!session_->open(cfg, Policy::kDefaultDeviceId)) return false;
+        configure(cfg, session_->deviceId());
+        session_->setMessageHandler([this](const char*, const char* payload, size_t len) {
+            handlePayload(payload, len);
+        });
+        return true;
+    }
+
+    /*
+     * 다른 장치와 같이 쓰는 MQTT 세션에 붙이기 (게이트웨이)
+     * - device_id: cfg.deviceId → 정책 기본값 (세션의 device_id와 별개)
+     * - 구독과 메시지 전달은 세션 주인이 함 (commandTopic()을 구독하고 handlePayload() 호출)
+     * - 연결 / 해제도 세션 주인이 하고, 이 브리지는 start() / closeDevice()만 호출
+     */
+    void attach(MqttSession& session, const BridgeConfig& cfg) {
+        session_ = &session;
+        configure(cfg, cfg.deviceId.empty() ? std::string(Policy::kDefaultDeviceId) : cfg.deviceId);
+    }
+
+    /*
+     * 디바이스 파일 열기 (실패해도 명령을 받을 때 다시 시도)
+     */
+    bool openDevice() {
+        return device_.open(devicePath_, Policy::kReadableStatus);
+    }
+
+    /*
+     * 디바이스 스레드를 멈추고(대기 중인 명령은 보냄) 종료 명령을 보낸 뒤 디바이스 파일 닫기
+     */
+    void closeDevice() {
+        stopWorker();
+        if constexpr (Policy::kHasShutdown) {
+            if (device_.isOpen()) sendCommand(Policy::kShutdown);
+        }
+        device_.close();
+    }
+
+    bool connect(EventLoop& loop) {
+        startWorker();
+        return session_->connect(loop);
+    }
+
+    /*
+     * 디바이스 스레드만 시작 (attach()로 붙인 경우, 세션 연결은 따로)
+     */
+    void start() { startWorker(); }
+
+    void close() {
+        session_->disconnect();
+        closeDevice();
+        session_->close();
+    }
+
+    /*
+     * 페이로드 → DeviceCommand (할당 없음)
+     * - folded: 소문자로 바꾼 페이로드 (kMaxCommandLen 크기 버퍼, 로그용)
+     * - 명령 표(완전 해시)에 없으면 정책의 parsePattern()으로 인자 있는 명령 해석
+     */
+    static bool decode(const char* payload, size_t len, char* folded, size_t& foldedLen, DeviceCommand& out) {
+        uint32_t hash = 0;
+        foldedLen = foldPayload(payload, len, folded, kMaxCommandLen, kTable.seed, hash);
+        if (foldedLen >= kMaxCommandLen) {
+            foldedLen = 0;
+            return false;
+        }
+
+        std::string_view cmd(folded, foldedLen);
+        int index = kTable.find(cmd, hash, Policy::kCommands);
+        if (index >= 0) {
+            out = Policy::kCommands[index].command;
+            return true;
+        }
+        return Policy::parsePattern(cmd, out);
+    }
+
+    /*
+     * MQTT 페이로드 하나 처리 (이벤트 루프 스레드)
+     * - 해석 → 대기열에 넣기 (전송 / 상태 발행은 디바이스 스레드)
+     */
+    bool handlePayload(const char* payload, size_t len) {
+        std::cout << "수신 메시지: " << std::string_view(payload, len) << std::endl;
+
+        char folded[kMaxCommandLen];
+        size_t foldedLen = 0;
+        DeviceCommand cmd;
+        if (!decode(payload, len, folded, foldedLen, cmd)) {
+            std::cerr << "잘못된 명령어: " << std::string_view(folded, foldedLen)
+                      << " (" << len << "바이트)" << std::endl;
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        return submit(cmd);
+    }
+
+    /*
+     * 명령을 디바이스 스레드 대기열에 넣기 (lock-free, 생산자는 한 스레드만 - MQTT 콜백 스레드)
+     * - 설정값 명령은 디바이스 스레드가 꺼낼 때 같은 액추에이터의 대기 중인 값과 합쳐짐
+     */
+    bool submit(const DeviceCommand& cmd) {
+        if (!queue_.push({cmd, bridge_detail::monotonicNs()})) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "명령 대기열이 가득 참 - 명령 버림" << std::endl;
+            return false;
+        }
+        queued_.fetch_add(1, std::memory_order_relaxed);
+
+        size_t depth = queue_.size();
+        if (depth > maxQueueDepth_.load(std::memory_order_relaxed)) {
+            maxQueueDepth_.store(depth, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /*
+     * 명령 하나를 드라이버로 전송
+     * - 드라이버가 바이너리 ABI를 지원하면 ioctl 한 번 (문자열 만들기 / 드라이버 sscanf 없음)
+     * - 아니면 드라이버 텍스트로 만들어 write() 한 번 ("cmd\n")
+     */
+    bool sendCommand(const DeviceCommand& cmd) {
+        DriverRequest req;
+        if (device_.binaryAbi() && Policy::toRequest(cmd, req)) {
+            int err = device_.control(req.request, &req.arg);
+            if (err == 0) {
+                commands_.fetch_add(1, std::memory_order_relaxed);
+                binaryCommands_.fetch_add(1, std::memory_order_relaxed);
+                Policy::onCommand(state_, cmd);
+                return true;
+            }
+            if (err != ENOTTY && err != EPROTO) {
+                std::cerr << "드라이버가 명령을 거부함: " << strerror(err) << std::endl;
+                return false;
+            }
+            // 다시 연 드라이버가 이전 버전이면 텍스트 명령으로 보냄
+        }
+
+        char line[kMaxCommandLen + 1];
+        size_t n = Policy::format(cmd, line, kMaxCommandLen);
+        if (n == 0) return false;
+
+        line[n] = '\n';
+        if (!device_.write(line, n + 1)) return false;
+
+        commands_.fetch_add(1, std::memory_order_relaxed);
+        Policy::onCommand(state_, cmd);
+        return true;
+    }
+
+    /*
+     * 현재 상태를 상태 토픽으로 발행 (읽을 수 있는 드라이버면 먼저 상태를 읽어서 갱신)
+     */
+    bool publishStatus() {
+        if (statusTopic_.empty()) return false;
+
+        refreshState();
+        std::string status;
+        std::string metadata;
+        Policy::writeStatus(state_, status, metadata);
+        return session_->publish(statusTopic_, buildStatusJson(status, metadata));
+    }
+
+    MqttSession& session() { return *session_; }
+    const MqttSession& session() const { return *session_; }
+    const std::string& deviceId() const { return deviceId_; }
+    const std::string& commandTopic() const { return commandTopic_; }
+    DevicePort& device() { return device_; }
+    const typename Policy::State& state() const { return state_; }
+
+    uint64_t commands() const { return commands_.load(std::memory_order_relaxed); }
+    uint64_t binaryCommands() const { return binaryCommands_.load(std::memory_order_relaxed); }
+    uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /*
+     * 합쳐진(덮어써서 보내지 않은) 설정값 명령 수 - 전체 / 액추에이터별
+     */
+    uint64_t coalesced() const {
+        uint64_t total = 0;
+        for (const auto& c : coalesced_) total += c.load(std::memory_order_relaxed);
+        return total;
+    }
+    uint64_t coalesced(size_t actuator) const {
+        return actuator < Policy::kActuators ? coalesced_[actuator].load(std::memory_order_relaxed) : 0;
+    }
+
+    size_t queueDepth() const { return queue_.size(); }
+
+    BridgeMetrics metrics() const {
+        BridgeMetrics m;
+        m.telemetryPublished = telemetryPublished_.load(std::memory_order_relaxed);
+        m.telemetrySuppressed = telemetrySuppressed_.load(std::memory_order_relaxed);
+        m.telemetryBytes = telemetryBytes_.load(std::memory_order_relaxed);
+        m.queued = queued_.load(std::memory_order_relaxed);
+        m.commands = commands();
+        m.binaryCommands = binaryCommands();
+        m.rejected = rejected();
+        m.dropped = dropped();
+        m.coalesced = coalesced();
+        m.queueDepth = queueDepth();
+        m.maxQueueDepth = maxQueueDepth_.load(std::memory_order_relaxed);
+        m.avgQueueWaitUs = queueWait_.avgUs();
+        m.maxQueueWaitUs = queueWait_.maxUs();
+        m.avgServiceUs = service_.avgUs();
+        m.maxServiceUs = service_.maxUs();
+        m.reconnects = session_->reconnects();
+        m.lastResubscribeMs = session_->lastResubscribeMs();
+        m.tlsHandshakes = session_->tlsHandshakes();
+        m.tlsResumed = session_->tlsResumed();
+        return m;
+    }
+
+private:
+    void configure(const BridgeConfig& cfg, const std::string& deviceId) {
+        deviceId_ = deviceId;
+        commandTopic_ = cfg.commandTopic.empty() ? std::string() : MqttSession::formatTopic(cfg.commandTopic, deviceId_);
+        statusTopic_ = cfg.statusTopic.empty() ? std::string() : MqttSession::formatTopic(cfg.statusTopic, deviceId_);
+        devicePath_ = cfg.devicePath.empty() ? std::string(Policy::kDevicePath) : cfg.devicePath;
+        telemetryTopic_ = cfg.telemetryTopic.empty() ? std::string() : MqttSession::formatTopic(cfg.telemetryTopic, deviceId_);
+        telemetryIntervalNs_ = static_cast<int64_t>(cfg.telemetryIntervalMs) * 1000000;
+        snapshotIntervalNs_ = static_cast<int64_t>(cfg.snapshotIntervalSec) * 1000000000LL;
+    }
+
+    struct QueuedCommand {
+        DeviceCommand command;
+        int64_t queuedNs;
+    };
+
+    void startWorker() {
+        if (worker_.joinable()) return;
+        stopping_.store(false, std::memory_order_release);
+        queue_.reset();
+        worker_ = std::thread(&DeviceBridge::workerLoop, this);
+    }
+
+    /*
+     * 대기 중인 명령을 모두 보낸 뒤 디바이스 스레드 종료
+     */
+    void stopWorker() {
+        if (!worker_.joinable()) return;
+        stopping_.store(true, std::memory_order_release);
+        queue_.stop();
+        worker_.join();
+    }
+
+    /*
+     * 드라이버 read()가 있으면 상태 텍스트를 읽어서 state_ 갱신 (디바이스 스레드)
+     */
+    void refreshState() {
+        if (Policy::kReadableStatus) {
+            char raw[1024];
+            ssize_t n = device_.readStatus(raw, sizeof(raw));
+            if (n > 0) Policy::parseStatus(state_, std::string_view(raw, static_cast<size_t>(n)));
+        }
+    }
+
+    bool telemetryEnabled() const {
+        return !telemetryTopic_.empty() && telemetryIntervalNs_ > 0;
+    }
+
+    /*
+     * 텔레메트리 샘플 하나: 드라이버 상태를 읽고 마지막 발행과 비교해 바뀐 필드만 발행
+     * - snapshot 주기가 지났거나 다시 연결된 뒤 첫 샘플이면 전체 필드
+     * - QoS 0 (다음 샘플이 곧 오므로 재전송 불필요)
+     */
+    void sampleTelemetry(int64_t nowNs) {
+        bool connected = session_->isConnected();
+        if (!connected) {
+            telemetryConnected_ = false;
+            return;
+        }
+        if (!telemetryConnected_) {
+            telemetry_.reset();   // 끊긴 동안 놓친 구독자를 위해 전체부터
+            telemetryConnected_ = true;
+        }
+
+        refreshState();
+        int32_t values[kTelemetryFields];
+        Policy::sample(state_, values);
+
+        bool full = snapshotIntervalNs_ > 0 && nowNs >= nextSnapshotNs_;
+        auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::string json;
+        if (telemetry_.build(Policy::kTelemetry, values, full, wallMs, json) == 0) {
+            telemetrySuppressed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!session_->publish(telemetryTopic_, json, 0, false)) return;
+
+        if (full) nextSnapshotNs_ = nowNs + snapshotIntervalNs_;
+        telemetry_.commit(values);
+        telemetryPublished_.fetch_add(1, std::memory_order_relaxed);
+        telemetryBytes_.fetch_add(json.size(), std::memory_order_relaxed);
+    }
+
+    /*
+     * 디바이스 스레드: 대기열을 비우면서 합친 뒤 순서대로 전송, 사이사이 텔레메트리 샘플
+     */
+    void workerLoop() {
+        typename Coalescer::Entry batch[kBatchCapacity];
+        int64_t nextSampleNs = bridge_detail::monotonicNs();
+        for (;;) {
+            if (telemetryEnabled()) {
+                int64_t now = bridge_detail::monotonicNs();
+                if (now >= nextSampleNs) {
+                    sampleTelemetry(now);
+                    nextSampleNs = now + telemetryIntervalNs_;
+                }
+            }
+
+            QueuedCommand item;
+            while (pending_.size() < kBatchCapacity && queue_.pop(item)) {
+                queueWait_.record(bridge_detail::monotonicNs() - item.queuedNs);
+                pending_.push(item.command, Policy::actuatorSlot(item.command));
+            }
+
+            if (pending_.empty()) {
+                if (stopping_.load(std::memory_order_acquire) && queue_.empty()) break;
+                int64_t waitMs = 1000;
+                if (telemetryEnabled()) {
+                    int64_t untilSample = (nextSampleNs - bridge_detail::monotonicNs()) / 1000000;
+                    waitMs = untilSample < 1 ? 1 : (untilSample < waitMs ? untilSample : waitMs);
+                }
+                queue_.wait(std::chrono::milliseconds(waitMs));
+                continue;
+            }
+
+            size_t n = pending_.take(batch);
+            for (size_t s = 0; s < Policy::kActuators; s++) {
+                coalesced_[s].store(pending_.coalesced(s), std::memory_order_relaxed);
+            }
+
+            size_t sent = 0;
+            for (size_t i = 0; i < n; i++) {
+                int64_t start = bridge_detail::monotonicNs();
+                if (sendCommand(batch[i].command)) sent++;
+                service_.record(bridge_detail::monotonicNs() - start);
+            }
+            std::cout << "명령 전송 완료: " << sent << "/" << n << "개" << std::endl;
+            if (sent > 0 && !statusTopic_.empty()) publishStatus();
+        }
+    }
+
+    MqttSession ownSession_;
+    MqttSession* session_ = &ownSession_;       // attach()면 게이트웨이 세션
+    std::string deviceId_;
+    std::string commandTopic_;
+    DevicePort device_;
+    std::string devicePath_;
+    std::string statusTopic_;
+    typename Policy::State state_;               // 디바이스 스레드 소유
+
+    std::string telemetryTopic_;
+    int64_t telemetryIntervalNs_ = 0;
+    int64_t snapshotIntervalNs_ = 0;
+    int64_t nextSnapshotNs_ = 0;
+    bool telemetryConnected_ = false;
+    TelemetryDelta<kTelemetryFields> telemetry_;
+
+    SpscQueue<QueuedCommand, kQueueCapacity> queue_;
+    Coalescer pending_;                          // 디바이스 스레드 소유
+    std::thread worker_;
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> commands_{0};
+    std::atomic<uint64_t> binaryCommands_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> coalesced_[Policy::kActuators > 0 ? Policy::kActuators : 1] = {};
+    std::atomic<size_t> maxQueueDepth_{0};
+    bridge_detail::DurationStat queueWait_;
+    bridge_detail::DurationStat service_;
+    std::atomic<uint64_t> telemetryPublished_{0};
+    std::atomic<uint64_t> telemetrySuppressed_{0};
+    std::atomic<uint64_t> telemetryBytes_{0};
+};
+
+/*
+ * 단독 브리지 프로그램 본체 - 연결 후 SIGINT/SIGTERM까지 이벤트 루프 실행
+ * - 시그널은 signalfd로 받으므로 바로 종료 (디바이스 스레드를 만들기 전에 막아 둠)
+ */
+template <typename Policy>
+int runBridge(const BridgeConfig& cfg) {
+    EventLoop loop;
+    if (!loop.valid() || !loop.addSignals({SIGINT, SIGTERM}, [&loop](int) { loop.stop(); })) return 1;
+
+    DeviceBridge<Policy> bridge;
+    if (!bridge.open(cfg)) return 1;
+
+    bridge.openDevice();
+    if (!bridge.connect(loop)) {
+        bridge.close();
+        return 1;
+    }
+
+    std::cout << Policy::kName << " MQTT TLS 클라이언트 실행 중... (Ctrl+C로 종료)" << std::endl;
+    std::cout << "Device ID: " << bridge.session().deviceId() << std::endl;
+    std::cout << "구독 토픽: " << bridge.session().formatTopic(cfg.commandTopic) << std::endl;
+
+    // 1분마다 지표 출력 (대기열 길이 / 명령 처리 시간)
+    int metricsTimer = loop.addTimer(60000, [&bridge] { std::cout << "[지표] " << bridge.metrics() << std::endl; });
+    loop.run();
+    loop.closeTimer(metricsTimer);
+
+    std::cout << "프로그램 종료 중..." << std::endl;
+    bridge.close();
+    std::cout << "[지표] " << bridge.metrics() << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,452 @@
+#ifndef DEVICE_POLICIES_HPP
+#define DEVICE_POLICIES_HPP
+
+#include "device_bridge.hpp"
+#include "telemetry.hpp"
+#include <string>
+#include <string_view>
+
+/*
+ * 장치별 브리지 정책 (명령 표 / 디바이스 파일 / 상태 파서)
+ * - 새 장치는 정책 타입만 추가하고 DeviceBridge<정책>으로 사용
+ * - 명령 표의 페이로드는 소문자, 같은 페이로드가 두 번 있으면 컴파일 오류 (완전 해시를 만들 수 없음)
+ */
+
+namespace policy_detail {
+
+/*
+ * 상태 텍스트에서 label 뒤의 정수들을 차례로 읽음 (숫자가 아닌 문자는 구분자)
+ * - 반환값: 읽은 정수 개수
+ */
+inline int readInts(std::string_view raw, std::string_view label, int* values, int count) {
+    size_t pos = raw.find(label);
+    if (pos == std::string_view::npos) return 0;
+
+    int found = 0;
+    size_t i = pos + label.size();
+    while (i < raw.size() && raw[i] != '\n' && found < count) {
+        bool negative = raw[i] == '-' && i + 1 < raw.size() && raw[i + 1] >= '0' && raw[i + 1] <= '9';
+        if (negative) i++;
+        if (raw[i] >= '0' && raw[i] <= '9') {
+            int v = 0;
+            while (i < raw.size() && raw[i] >= '0' && raw[i] <= '9') {
+                v = v * 10 + (raw[i] - '0');
+                i++;
+            }
+            values[found++] = negative ? -v : v;
+        } else {
+            i++;
+        }
+    }
+    return found;
+}
+
+/*
+ * label 뒤 값이 ON인지
+ */
+inline bool readOnOff(std::string_view raw, std::string_view label, bool fallback) {
+    size_t pos = raw.find(label);
+    if (pos == std::string_view::npos) return fallback;
+    std::string_view rest = raw.substr(pos + label.size());
+    while (!rest.empty() && rest.front() == ' ') rest.remove_prefix(1);
+    return rest.substr(0, 2) == "ON";
+}
+
+/*
+ * 인자 없는 명령: 명령 번호 → 드라이버 텍스트 (kOpText 표)
+ */
+template <size_t N>
+inline size_t formatFixed(const std::string_view (&opText)[N], const DeviceCommand& cmd, char* buf, size_t cap) {
+    if (cmd.op >= N) return 0;
+    return CommandWriter(buf, cap).text(opText[cmd.op]).size();
+}
+
+/*
+ * 인자 없는 명령: 명령 번호 → 바이너리 모드 명령 (modes 표, 명령 번호 순서)
+ */
+template <size_t N>
+inline bool modeRequest(const uint32_t (&modes)[N], const DeviceCommand& cmd, DriverRequest& req) {
+    if (cmd.op >= N) return false;
+    req = makeModeRequest(modes[cmd.op]);
+    return true;
+}
+
+}  // namespace policy_detail
+
+/*
+ * 컨베이어01 (conveyor_driver.c, /dev/conveyor_mqtt)
+ * - 드라이버 read(): 동작 여부 / 서보 각도 / 속도 / 스텝 / 판 번호
+ */
+struct ConveyorPolicy {
+    static constexpr const char* kName = "컨베이어";
+    static constexpr const char* kDevicePath = "/dev/conveyor_mqtt";
+    static constexpr const char* kDefaultDeviceId = "conveyor_03";
+    static constexpr bool kReadableStatus = true;
+    static constexpr bool kHasShutdown = false;
+    static constexpr DeviceCommand kShutdown = {};
+
+    enum Op : uint8_t { OP_ON, OP_OFF, OP_ERROR_MODE };
+    static constexpr std::string_view kOpText[] = {"on", "off", "error_mode"};
+
+    static constexpr CommandEntry kCommands[] = {
+        {"on", makeCommand(OP_ON)},
+        {"off", makeCommand(OP_OFF)},
+        {"error_mode", makeCommand(OP_ERROR_MODE)},
+    };
+
+    static bool parsePattern(std::string_view, DeviceCommand&) { return false; }
+
+    // 설정값 명령 없음 (모두 이산 명령)
+    static constexpr size_t kActuators = 0;
+    static int actuatorSlot(const DeviceCommand&) { return -1; }
+
+    static bool toRequest(const DeviceCommand& cmd, DriverRequest& req) {
+        static constexpr uint32_t kModes[] = {FACTORY_MODE_ON, FACTORY_MODE_OFF, FACTORY_MODE_ERROR};
+        return policy_detail::modeRequest(kModes, cmd, req);
+    }
+
+    static size_t format(const DeviceCommand& cmd, char* buf, size_t cap) {
+        return policy_detail::formatFixed(kOpText, cmd, buf, cap);
+    }
+
+    struct State {
+        bool running = false;
+        int servoAngle = 0;
+        int speed = 0;
+        int step = 0;
+        int targetSteps = 0;
+        int panel = 0;
+    };
+
+    static void onCommand(State& state, const DeviceCommand& cmd) {
+        state.running = cmd.op != OP_OFF;
+    }
+
+    static void parseStatus(State& state, std::string_view raw) {
+        int v[2];
+        state.running = policy_detail::readOnOff(raw, "컨베이어:", state.running);
+        if (policy_detail::readInts(raw, "서보 각도:", v, 1) == 1) state.servoAngle = v[0];
+        if (policy_detail::readInts(raw, "현재 속도:", v, 1) == 1) state.speed = v[0];
+        if (policy_detail::readInts(raw, "현재 스텝:", v, 2) == 2) {
+            state.step = v[0];
+            state.targetSteps = v[1];
+        }
+        if (policy_detail::readInts(raw, "현재 판:", v, 1) == 1) state.panel = v[0];
+    }
+
+    static void writeStatus(const State& state, std::string& status, std::string& metadata) {
+        status = state.running ? "running" : "stopped";
+        metadata = "{\"speed\":" + std::to_string(state.speed) +
+                   ",\"step\":" + std::to_string(state.step) +
+                   ",\"target_steps\":" + std::to_string(state.targetSteps) +
+                   ",\"panel\":" + std::to_string(state.panel) +
+                   ",\"servo_angle\":" + std::to_string(state.servoAngle) + "}";
+    }
+
+    static constexpr TelemetryField kTelemetry[] = {
+        {"running", true}, {"speed"}, {"step"}, {"target_steps"}, {"panel"}, {"servo_angle"},
+    };
+
+    static void sample(const State& state, int32_t* values) {
+        values[0] = state.running;
+        values[1] = state.speed;
+        values[2] = state.step;
+        values[3] = state.targetSteps;
+        values[4] = state.panel;
+        values[5] = state.servoAngle;
+    }
+};
+
+/*
+ * 피더 (feeder_driver.c, /dev/feeder_02) - 드라이버 read() 없음, 마지막 명령으로 상태 표시
+ */
+struct FeederPolicy {
+    static constexpr const char* kName = "피더";
+    static constexpr const char* kDevicePath = "/dev/feeder_02";
+    static constexpr const char* kDefaultDeviceId = "feeder_02";
+    static constexpr bool kReadableStatus = false;
+    static constexpr bool kHasShutdown = false;
+    static constexpr DeviceCommand kShutdown = {};
+
+    enum Op : uint8_t { OP_ON, OP_OFF, OP_REVERSE, OP_ERROR, OP_NORMAL };
+    static constexpr std::string_view kOpText[] = {"on", "off", "reverse", "error", "normal"};
+
+    static constexpr CommandEntry kCommands[] = {
+        {"on", makeCommand(OP_ON)},
+        {"off", makeCommand(OP_OFF)},
+        {"reverse", makeCommand(OP_REVERSE)},
+        {"error", makeCommand(OP_ERROR)},
+        {"normal", makeCommand(OP_NORMAL)},
+    };
+
+    static bool parsePattern(std::string_view, DeviceCommand&) { return false; }
+
+    // 설정값 명령 없음 (모두 이산 명령)
+    static constexpr size_t kActuators = 0;
+    static int actuatorSlot(const DeviceCommand&) { return -1; }
+
+    static bool toRequest(const DeviceCommand& cmd, DriverRequest& req) {
+        static constexpr uint32_t kModes[] = {FACTORY_MODE_ON, FACTORY_MODE_OFF, FACTORY_MODE_REVERSE,
+                                              FACTORY_MODE_ERROR, FACTORY_MODE_NORMAL};
+        return policy_detail::modeRequest(kModes, cmd, req);
+    }
+
+    static size_t format(const DeviceCommand& cmd, char* buf, size_t cap) {
+        return policy_detail::formatFixed(kOpText, cmd, buf, cap);
+    }
+
+    struct State {
+        uint8_t mode = OP_OFF;
+    };
+
+    static void onCommand(State& state, const DeviceCommand& cmd) {
+        state.mode = cmd.op;
+    }
+
+    static void parseStatus(State&, std::string_view) {}
+
+    static void writeStatus(const State& state, std::string& status, std::string& metadata) {
+        status = state.mode == OP_OFF ? "stopped" : "running";
+        metadata = "{\"mode\":\"" + std::string(kOpText[state.mode]) + "\"}";
+    }
+
+    // 드라이버 read()가 없으므로 보낸 명령 기준
+    static constexpr TelemetryField kTelemetry[] = {
+        {"running", true}, {"reverse", true}, {"error_mode", true},
+    };
+
+    static void sample(const State& state, int32_t* values) {
+        values[0] = state.mode != OP_OFF;
+        values[1] = state.mode == OP_REVERSE;
+        values[2] = state.mode == OP_ERROR;
+    }
+};
+
+/*
+ * 4축 로봇암 (robot_arm_driver.c, /dev/robot_arm)
+ * - 별칭(pickup/start, stop/halt)과 베이스 위치 명령은 표에서 바로 해당 명령으로 해석
+ * - servo<N> <각도>는 from_chars로 읽어서 범위 확인 (관절 0~3, 각도 0~250 - 드라이버와 같은 범위)
+ * - 드라이버 read(): 자동/수동 모드, 동작 단계, 관절 각도 4개
+ */
+struct RobotArmPolicy {
+    static constexpr const char* kName = "로봇암";
+    static constexpr const char* kDevicePath = "/dev/robot_arm";
+    static constexpr const char* kDefaultDeviceId = "robot_arm";
+    static constexpr bool kReadableStatus = true;
+    static constexpr bool kHasShutdown = false;
+    static constexpr DeviceCommand kShutdown = {};
+    static constexpr int kJoints = 4;
+    static constexpr int kMaxAngle = 250;
+
+    enum Op : uint8_t { OP_ON, OP_OFF, OP_INIT, OP_COME, OP_GO, OP_SERVO };
+    static constexpr std::string_view kOpText[] = {"on", "off", "init", "come", "go"};
+
+    static constexpr CommandEntry kCommands[] = {
+        {"on", makeCommand(OP_ON)},
+        {"off", makeCommand(OP_OFF)},
+        {"init", makeCommand(OP_INIT)},
+        {"come", makeCommand(OP_COME)},
+        {"go", makeCommand(OP_GO)},
+        {"pickup", makeCommand(OP_ON)},
+        {"start", makeCommand(OP_ON)},
+        {"stop", makeCommand(OP_OFF)},
+        {"halt", makeCommand(OP_OFF)},
+        {"base_left", makeCommand(OP_SERVO, 0, 30)},
+        {"base_right", makeCommand(OP_SERVO, 0, 150)},
+        {"base_center", makeCommand(OP_SERVO, 0, 90)},
+    };
+
+    static bool parsePattern(std::string_view cmd, DeviceCommand& out) {
+        if (cmd.substr(0, 5) != "servo") return false;
+        cmd.remove_prefix(5);
+        // 관절 번호는 servo 바로 뒤 ("servo 1 5"는 잘못된 명령 - parseIntArg가 앞 공백을 건너뛰므로 먼저 확인)
+        if (cmd.empty() || cmd.front() < '0' || cmd.front() > '9') return false;
+
+        int32_t joint = 0;
+        int32_t angle = 0;
+        if (!parseIntArg(cmd, joint) || cmd.empty() || cmd.front() != ' ' || !parseIntArg(cmd, angle)) return false;
+        if (!cmd.empty()) return false;
+        if (joint < 0 || joint >= kJoints || angle < 0 || angle > kMaxAngle) return false;
+
+        out = makeCommand(OP_SERVO, joint, angle);
+        return true;
+    }
+
+    // 관절마다 최신 각도만 남김 (servo<N>, base_*), 나머지는 이산 명령
+    static constexpr size_t kActuators = kJoints;
+    static int actuatorSlot(const DeviceCommand& cmd) {
+        return cmd.op == OP_SERVO ? cmd.args[0] : -1;
+    }
+
+    // come / go는 드라이버에 해당 동작이 없어 텍스트로 보냄 (드라이버가 무시)
+    static bool toRequest(const DeviceCommand& cmd, DriverRequest& req) {
+        if (cmd.op == OP_SERVO) {
+            req = makeServoRequest(static_cast<uint32_t>(cmd.args[0]), cmd.args[1]);
+            return true;
+        }
+        static constexpr uint32_t kModes[] = {FACTORY_MODE_ON, FACTORY_MODE_OFF, FACTORY_MODE_INIT};
+        return policy_detail::modeRequest(kModes, cmd, req);
+    }
+
+    static size_t format(const DeviceCommand& cmd, char* buf, size_t cap) {
+        if (cmd.op == OP_SERVO) {
+            return CommandWriter(buf, cap).text("servo").num(cmd.args[0]).ch(' ').num(cmd.args[1]).size();
+        }
+        return policy_detail::formatFixed(kOpText, cmd, buf, cap);
+    }
+
+    struct State {
+        bool autoMode = false;
+        bool userMode = false;
+        int sequence = 0;
+        int joints[kJoints] = {0, 0, 0, 0};
+    };
+
+    static void onCommand(State& state, const DeviceCommand& cmd) {
+        if (cmd.op == OP_ON) {
+            state.autoMode = true;
+            state.userMode = false;
+        } else if (cmd.op == OP_OFF) {
+            state.autoMode = false;
+            state.userMode = false;
+        } else if (cmd.op == OP_SERVO && state.userMode) {
+            state.joints[cmd.args[0]] = cmd.args[1];
+        }
+    }
+
+    static void parseStatus(State& state, std::string_view raw) {
+        state.autoMode = policy_detail::readOnOff(raw, "자동 모드:", state.autoMode);
+        state.userMode = policy_detail::readOnOff(raw, "수동 모드:", state.userMode);
+        int v[kJoints];
+        if (policy_detail::readInts(raw, "현재 동작단계:", v, 1) == 1) state.sequence = v[0];
+        // 라벨 "서보모터 각도(하단/중단/상단/그리퍼):" 뒤의 정수 4개
+        if (policy_detail::readInts(raw, "그리퍼):", v, kJoints) == kJoints) {
+            for (int i = 0; i < kJoints; i++) state.joints[i] = v[i];
+        }
+    }
+
+    static void writeStatus(const State& state, std::string& status, std::string& metadata) {
+        status = state.autoMode ? "auto" : (state.userMode ? "manual" : "idle");
+        metadata = "{\"sequence\":" + std::to_string(state.sequence) + ",\"joints\":[";
+        for (int i = 0; i < kJoints; i++) {
+            if (i > 0) metadata += ",";
+            metadata += std::to_string(state.joints[i]);
+        }
+        metadata += "]}";
+    }
+
+    static constexpr TelemetryField kTelemetry[] = {
+        {"auto_mode", true}, {"manual_mode", true}, {"sequence"},
+        {"joint0"}, {"joint1"}, {"joint2"}, {"joint3"},
+    };
+    static_assert(sizeof(kTelemetry) / sizeof(kTelemetry[0]) == 3 + kJoints, "관절 필드 수");
+
+    static void sample(const State& state, int32_t* values) {
+        values[0] = state.autoMode;
+        values[1] = state.userMode;
+        values[2] = state.sequence;
+        for (int i = 0; i < kJoints; i++) values[3 + i] = state.joints[i];
+    }
+};
+
+/*
+ * 컨베이어02 L298N 모터 (l298n_motor_driver.c, /dev/l298n_motor)
+ * - OP_MOTOR 인자: 모터('A'/'B'), 방향(-1/0/1), 속도(0~100) → 드라이버 명령 "<A|B> <방향> <속도>"
+ * - 드라이버 read()는 사용법 텍스트뿐이라 보낸 명령으로 모터 상태를 추적
+ */
+struct L298nPolicy {
+    static constexpr const char* kName = "L298N 컨베이어";
+    static constexpr const char* kDevicePath = "/dev/l298n_motor";
+    static constexpr const char* kDefaultDeviceId = "conveyor_02";
+    static constexpr bool kReadableStatus = false;
+
+    enum Op : uint8_t { OP_MOTOR, OP_STOP };
+
+    static constexpr bool kHasShutdown = true;
+    static constexpr DeviceCommand kShutdown = makeCommand(OP_STOP);
+
+    static constexpr CommandEntry kCommands[] = {
+        {"on", makeCommand(OP_MOTOR, 'A', 1, 99)},     // 모터A 정방향 99%
+        {"off", makeCommand(OP_STOP)},                 // 모터 정지
+    };
+
+    static bool parsePattern(std::string_view, DeviceCommand&) { return false; }
+
+    // 모터(A/B)마다 최신 방향/속도만 남김, 정지(S)는 이산 명령
+    static constexpr size_t kActuators = 2;
+    static int actuatorSlot(const DeviceCommand& cmd) {
+        if (cmd.op != OP_MOTOR) return -1;
+        if (cmd.args[0] == 'A' || cmd.args[0] == 'a') return 0;
+        if (cmd.args[0] == 'B' || cmd.args[0] == 'b') return 1;
+        return -1;
+    }
+
+    static bool toRequest(const DeviceCommand& cmd, DriverRequest& req) {
+        if (cmd.op == OP_STOP) {
+            req = makeModeRequest(FACTORY_MODE_OFF);
+            return true;
+        }
+        if (cmd.op != OP_MOTOR) return false;
+
+        int32_t motor = cmd.args[0];
+        if (motor == 'A' || motor == 'a') req = makeMotorRequest(FACTORY_MOTOR_A, cmd.args[1], cmd.args[2]);
+        else if (motor == 'B' || motor == 'b') req = makeMotorRequest(FACTORY_MOTOR_B, cmd.args[1], cmd.args[2]);
+        else return false;
+        return true;
+    }
+
+    static size_t format(const DeviceCommand& cmd, char* buf, size_t cap) {
+        if (cmd.op == OP_STOP) return CommandWriter(buf, cap).text("S 0 0").size();
+        if (cmd.op != OP_MOTOR) return 0;
+        return CommandWriter(buf, cap).ch(static_cast<char>(cmd.args[0])).ch(' ')
+                                      .num(cmd.args[1]).ch(' ').num(cmd.args[2]).size();
+    }
+
+    struct State {
+        int motorADir = 0;     // -1: 역방향, 0: 정지, 1: 정방향
+        int motorASpeed = 0;
+        int motorBDir = 0;
+        int motorBSpeed = 0;
+    };
+
+    static void onCommand(State& state, const DeviceCommand& cmd) {
+        if (cmd.op == OP_STOP) {
+            state = State();
+            return;
+        }
+
+        int dir = cmd.args[1];
+        int speed = dir == 0 ? 0 : cmd.args[2];
+        if (cmd.args[0] == 'A' || cmd.args[0] == 'a') {
+            state.motorADir = dir;
+            state.motorASpeed = speed;
+        } else if (cmd.args[0] == 'B' || cmd.args[0] == 'b') {
+            state.motorBDir = dir;
+            state.motorBSpeed = speed;
+        }
+    }
+
+    static void parseStatus(State&, std::string_view) {}
+
+    static void writeStatus(const State& state, std::string& status, std::string& metadata) {
+        status = (state.motorADir == 0 && state.motorBDir == 0) ? "stopped" : "running";
+        metadata = "{\"motor_a\":{\"direction\":" + std::to_string(state.motorADir) +
+                   ",\"speed\":" + std::to_string(state.motorASpeed) +
+                   "},\"motor_b\":{\"direction\":" + std::to_string(state.motorBDir) +
+                   ",\"speed\":" + std::to_string(state.motorBSpeed) + "}}";
+    }
+
+    // 드라이버 read()가 사용법 텍스트뿐이므로 보낸 명령 기준
+    static constexpr TelemetryField kTelemetry[] = {
+        {"motor_a_direction"}, {"motor_a_speed"}, {"motor_b_direction"}, {"motor_b_speed"},
+    };
+
+    static void sample(const State& state, int32_t* values) {
+        values[0] = state.motorADir;
+        values[1] = state.motorASpeed;
+        values[2] = state.motorBDir;
+        values[3] = state.motorBSpeed;
+    }
+};
+
+#endif
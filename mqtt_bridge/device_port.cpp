@@ -0,0 +1,121 @@
+#include "device_port.hpp"
+#include "factory_cmd_abi.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+DevicePort::~DevicePort() {
+    close();
+}
+
+bool DevicePort::open(const std::string& path, bool readable) {
+    close();
+    path_ = path;
+    flags_ = (readable ? O_RDWR : O_WRONLY) | O_CLOEXEC;
+    return reopen();
+}
+
+void DevicePort::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    binaryAbi_ = false;
+}
+
+bool DevicePort::reopen() {
+    close();
+    fd_ = ::open(path_.c_str(), flags_);
+    if (fd_ < 0) {
+        std::cerr << "디바이스 파일 열기 실패: " << path_ << " (" << strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    probeAbi();
+    return true;
+}
+
+void DevicePort::probeAbi() {
+    __u32 version = 0;
+    binaryAbi_ = ::ioctl(fd_, FACTORY_IOC_VERSION, &version) == 0 && version == FACTORY_CMD_ABI_VERSION;
+    if (binaryAbi_) {
+        std::cout << "바이너리 명령 사용: " << path_ << " (ABI v" << version << ")" << std::endl;
+    }
+}
+
+bool DevicePort::write(const char* data, size_t len) {
+    if (path_.empty()) return false;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (fd_ < 0) {
+            if (!reopen()) break;
+            reopens_++;
+        }
+
+        ssize_t n;
+        do {
+            n = ::write(fd_, data, len);
+        } while (n < 0 && errno == EINTR);
+        if (n == static_cast<ssize_t>(len)) return true;
+
+        std::cerr << "디바이스 쓰기 실패: " << path_ << " ("
+                  << (n < 0 ? strerror(errno) : "일부만 기록됨") << ")" << std::endl;
+        close();
+    }
+    writeFailures_++;
+    return false;
+}
+
+int DevicePort::control(unsigned long request, void* arg) {
+    if (path_.empty()) return EBADF;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (fd_ < 0) {
+            if (!reopen()) break;
+            reopens_++;
+        }
+
+        int rc;
+        do {
+            rc = ::ioctl(fd_, request, arg);
+        } while (rc < 0 && errno == EINTR);
+        if (rc == 0) return 0;
+
+        // 명령 자체를 거부한 경우(범위 / 모드 / 버전)는 fd 문제가 아니므로 그대로 돌려줌
+        int err = errno;
+        if (err != EBADF && err != ENODEV && err != ENXIO && err != EIO) return err;
+
+        std::cerr << "디바이스 ioctl 실패: " << path_ << " (" << strerror(err) << ")" << std::endl;
+        close();
+    }
+    writeFailures_++;
+    return EIO;
+}
+
+ssize_t DevicePort::readStatus(char* buf, size_t len) {
+    if (path_.empty() || (flags_ & O_ACCMODE) != O_RDWR) return -1;   // 쓰기 전용으로 연 포트
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (fd_ < 0) {
+            if (!reopen()) break;
+            reopens_++;
+        }
+
+        // 드라이버 read()는 offset 0에서만 상태를 돌려주므로 매번 처음부터 읽음
+        ssize_t n;
+        do {
+            n = ::pread(fd_, buf, len, 0);
+        } while (n < 0 && errno == EINTR);
+        if (n >= 0) return n;
+
+        // fd 문제(드라이버를 다시 올림 등)일 때만 다시 열기
+        int err = errno;
+        if (err != EBADF && err != ENODEV && err != ENXIO && err != EIO) return -1;
+
+        std::cerr << "디바이스 상태 읽기 실패: " << path_ << " (" << strerror(err) << ")" << std::endl;
+        close();
+    }
+    return -1;
+}
@@ -0,0 +1,72 @@
+#ifndef DEVICE_PORT_HPP
+#define DEVICE_PORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+/*
+ * 커널 드라이버 디바이스 파일 (브리지가 시작할 때 한 번 열어 두고 계속 사용)
+ * - write(): 명령 하나를 버퍼 없이 write() 한 번으로 전송
+ *   열려 있지 않거나 쓰기에 실패하면 다시 열고 한 번만 재시도
+ *   (드라이버를 다시 올려 장치 노드가 바뀐 경우, 시작할 때 드라이버가 없었던 경우 등)
+ * - control(): 바이너리 명령 ioctl 하나 (factory_cmd_abi.h)
+ *   열 때마다 FACTORY_IOC_VERSION으로 드라이버가 같은 ABI 버전을 지원하는지 확인 (binaryAbi())
+ * - readStatus(): 드라이버 read() 상태 텍스트를 pread(0)으로 읽음 (같은 fd를 계속 사용)
+ *   write()와 같이 열려 있지 않거나 fd가 끊겼으면 다시 열고 한 번만 재시도
+ *   → 명령이 없어도 텔레메트리 주기마다 드라이버 재적재 / 늦은 적재를 따라감
+ * - 열린 fd가 모듈 참조를 잡고 있으므로 드라이버를 내리려면(rmmod) 브리지를 먼저 종료할 것
+ * - 한 스레드에서만 사용 (DeviceBridge의 디바이스 스레드 - 명령 전송 / 상태 읽기 모두, 잠금 없음)
+ *   open() / close()는 디바이스 스레드를 시작하기 전 / 끝낸 뒤에만
+ */
+class DevicePort {
+public:
+    DevicePort() = default;
+    ~DevicePort();
+
+    DevicePort(const DevicePort&) = delete;
+    DevicePort& operator=(const DevicePort&) = delete;
+
+    /*
+     * readable: 상태 조회용으로 읽기/쓰기 모두 열기 (false면 쓰기 전용)
+     * - 실패해도 경로는 기억해 두고 다음 write()에서 다시 시도
+     */
+    bool open(const std::string& path, bool readable);
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+    const std::string& path() const { return path_; }
+
+    bool write(const char* data, size_t len);
+
+    /*
+     * 반환값: 0 또는 errno (ENOTTY/EPROTO면 드라이버가 바이너리 명령을 모르는 것 → 텍스트로 보낼 것)
+     */
+    int control(unsigned long request, void* arg);
+
+    /*
+     * 마지막으로 열었을 때 드라이버가 같은 바이너리 ABI 버전을 알려줬는지
+     */
+    bool binaryAbi() const { return binaryAbi_; }
+
+    /*
+     * 반환값: 읽은 바이트 (실패 시 -1)
+     */
+    ssize_t readStatus(char* buf, size_t len);
+
+    uint64_t reopens() const { return reopens_; }
+    uint64_t writeFailures() const { return writeFailures_; }
+
+private:
+    bool reopen();
+    void probeAbi();
+
+    int fd_ = -1;
+    int flags_ = 0;
+    std::string path_;
+    uint64_t reopens_ = 0;
+    uint64_t writeFailures_ = 0;
+    bool binaryAbi_ = false;
+};
+
+#endif
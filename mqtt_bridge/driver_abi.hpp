@@ -0,0 +1,57 @@
+#ifndef DRIVER_ABI_HPP
+#define DRIVER_ABI_HPP
+
+#include "factory_cmd_abi.h"
+#include <cstdint>
+
+/*
+ * 바이너리 명령 ABI (factory_cmd_abi.h) C++ 도우미
+ * - DriverRequest: ioctl 번호 + 인자 구조체 하나 (version은 만들 때 채움)
+ * - 정책의 toRequest()가 DeviceCommand를 DriverRequest로 바꾸고 DevicePort::control()로 전송
+ */
+struct DriverRequest {
+    unsigned long request = 0;
+    union {
+        factory_mode_cmd mode;
+        factory_motor_cmd motor;
+        factory_servo_cmd servo;
+        factory_speed_cmd speed;
+    } arg = {};
+};
+
+inline DriverRequest makeModeRequest(uint32_t mode) {
+    DriverRequest req;
+    req.request = FACTORY_IOC_MODE;
+    req.arg.mode.version = FACTORY_CMD_ABI_VERSION;
+    req.arg.mode.mode = mode;
+    return req;
+}
+
+inline DriverRequest makeMotorRequest(uint32_t motor, int32_t direction, int32_t speed) {
+    DriverRequest req;
+    req.request = FACTORY_IOC_MOTOR;
+    req.arg.motor.version = FACTORY_CMD_ABI_VERSION;
+    req.arg.motor.motor = motor;
+    req.arg.motor.direction = direction;
+    req.arg.motor.speed = speed;
+    return req;
+}
+
+inline DriverRequest makeServoRequest(uint32_t joint, int32_t angle) {
+    DriverRequest req;
+    req.request = FACTORY_IOC_SERVO;
+    req.arg.servo.version = FACTORY_CMD_ABI_VERSION;
+    req.arg.servo.joint = joint;
+    req.arg.servo.angle = angle;
+    return req;
+}
+
+inline DriverRequest makeSpeedRequest(int32_t speed) {
+    DriverRequest req;
+    req.request = FACTORY_IOC_SPEED;
+    req.arg.speed.version = FACTORY_CMD_ABI_VERSION;
+    req.arg.speed.speed = speed;
+    return req;
+}
+
+#endif
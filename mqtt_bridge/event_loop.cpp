@@ -0,0 +1,171 @@
+#include "event_loop.hpp"
+#include <iostream>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+EventLoop::EventLoop() {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        std::cerr << "epoll 생성 실패: " << strerror(errno) << std::endl;
+        return;
+    }
+    stopFd_ = addNotifier([] {});
+}
+
+EventLoop::~EventLoop() {
+    for (auto& entry : handlers_) {
+        if (entry.first == stopFd_ || entry.first == signalFd_) close(entry.first);
+    }
+    if (epollFd_ >= 0) close(epollFd_);
+}
+
+bool EventLoop::add(int fd, uint32_t events, Handler handler) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "epoll 등록 실패 (fd " << fd << "): " << strerror(errno) << std::endl;
+        return false;
+    }
+    handlers_[fd] = std::make_shared<Handler>(std::move(handler));
+    return true;
+}
+
+bool EventLoop::modify(int fd, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::remove(int fd) {
+    // 이미 닫힌 fd면 epoll에서 자동으로 빠져 있음 (오류 무시)
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    handlers_.erase(fd);
+}
+
+int EventLoop::createTimer(Callback callback) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) return -1;
+
+    bool ok = add(fd, EPOLLIN, [fd, callback = std::move(callback)](uint32_t) {
+        uint64_t expirations;
+        if (read(fd, &expirations, sizeof(expirations)) == sizeof(expirations)) callback();
+    });
+    if (!ok) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int EventLoop::addTimer(int intervalMs, Callback callback) {
+    int fd = createTimer(std::move(callback));
+    if (fd >= 0) armTimer(fd, intervalMs, intervalMs);
+    return fd;
+}
+
+bool EventLoop::armTimer(int timerFd, int64_t firstMs, int64_t intervalMs) {
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(firstMs / 1000);
+    spec.it_value.tv_nsec = static_cast<long>((firstMs % 1000) * 1000000);
+    spec.it_interval.tv_sec = static_cast<time_t>(intervalMs / 1000);
+    spec.it_interval.tv_nsec = static_cast<long>((intervalMs % 1000) * 1000000);
+    return timerfd_settime(timerFd, 0, &spec, nullptr) == 0;
+}
+
+void EventLoop::closeTimer(int timerFd) {
+    if (timerFd < 0) return;
+    remove(timerFd);
+    close(timerFd);
+}
+
+bool EventLoop::addSignals(std::initializer_list<int> signals, std::function<void(int)> callback) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (int signo : signals) sigaddset(&mask, signo);
+    if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) return false;
+
+    int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "signalfd 생성 실패: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    bool ok = add(fd, EPOLLIN, [fd, callback = std::move(callback)](uint32_t) {
+        signalfd_siginfo info;
+        while (read(fd, &info, sizeof(info)) == sizeof(info)) callback(static_cast<int>(info.ssi_signo));
+    });
+    if (!ok) {
+        close(fd);
+        return false;
+    }
+    signalFd_ = fd;
+    return true;
+}
+
+int EventLoop::addNotifier(Callback callback) {
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) return -1;
+
+    bool ok = add(fd, EPOLLIN, [fd, callback = std::move(callback)](uint32_t) {
+        uint64_t count;
+        if (read(fd, &count, sizeof(count)) == sizeof(count)) callback();
+    });
+    if (!ok) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void EventLoop::notify(int eventFd) {
+    if (eventFd < 0) return;
+    uint64_t one = 1;
+    ssize_t n = write(eventFd, &one, sizeof(one));
+    (void)n;   // 카운터가 가득 찬 경우(EAGAIN)에도 이미 깨어날 예정
+}
+
+void EventLoop::run() {
+    while (!stopped()) dispatch(-1);
+}
+
+bool EventLoop::runUntil(const std::function<bool()>& done, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!done() && !stopped()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) break;
+        dispatch(static_cast<int>(remaining));
+    }
+    return done();
+}
+
+void EventLoop::stop() {
+    stopped_.store(true, std::memory_order_release);
+    notify(stopFd_);
+}
+
+void EventLoop::dispatch(int timeoutMs) {
+    epoll_event events[16];
+    int n = epoll_wait(epollFd_, events, 16, timeoutMs);
+    if (n < 0) {
+        if (errno != EINTR) std::cerr << "epoll_wait 실패: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        // 앞 이벤트 처리 중에 remove()된 fd는 건너뜀, 처리 중 자기 자신을 지워도 되도록 참조를 잡아 둠
+        auto it = handlers_.find(events[i].data.fd);
+        if (it == handlers_.end()) continue;
+        std::shared_ptr<Handler> handler = it->second;
+        (*handler)(events[i].events);
+    }
+}
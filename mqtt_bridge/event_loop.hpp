@@ -0,0 +1,82 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <unordered_map>
+
+/*
+ * 단일 스레드 epoll 이벤트 루프 (브리지 / 게이트웨이 메인 스레드)
+ * - fd: MQTT 소켓 등 (EPOLLIN / EPOLLOUT)
+ * - timerfd: 주기 작업 (keepalive, 지표 출력), 한 번만 울리는 타이머 (재연결 대기)
+ * - signalfd: SIGINT / SIGTERM → 바로 종료 (sleep 주기를 기다리지 않음)
+ * - eventfd: 다른 스레드(디바이스 스레드) → 루프 알림 (notify()만 스레드 안전)
+ *
+ * add / remove / 타이머 설정은 루프 스레드에서만, stop() / notify()는 어느 스레드에서나
+ */
+class EventLoop {
+public:
+    using Handler = std::function<void(uint32_t events)>;
+    using Callback = std::function<void()>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool valid() const { return epollFd_ >= 0; }
+
+    /*
+     * fd 감시 (fd는 호출한 쪽 소유 - remove() 후 닫을 것)
+     */
+    bool add(int fd, uint32_t events, Handler handler);
+    bool modify(int fd, uint32_t events);
+    void remove(int fd);
+
+    /*
+     * timerfd 만들기 (처음에는 꺼져 있음, armTimer()로 설정) - 반환값: fd (실패 시 -1)
+     * addTimer(): 만들고 intervalMs 주기로 바로 설정
+     * closeTimer(): 감시 해제 + 닫기
+     */
+    int createTimer(Callback callback);
+    int addTimer(int intervalMs, Callback callback);
+    static bool armTimer(int timerFd, int64_t firstMs, int64_t intervalMs = 0);   // firstMs 0이면 끔
+    void closeTimer(int timerFd);
+
+    /*
+     * 시그널을 signalfd로 받기 (sigprocmask로 막음)
+     * - 다른 스레드를 만들기 전에 호출할 것 (새 스레드는 막힌 마스크를 물려받음)
+     */
+    bool addSignals(std::initializer_list<int> signals, std::function<void(int signo)> callback);
+
+    /*
+     * eventfd 알림 만들기 - 반환값: fd (notify()에 넘김, closeNotifier()로 해제)
+     */
+    int addNotifier(Callback callback);
+    static void notify(int eventFd);
+    void closeNotifier(int eventFd) { closeTimer(eventFd); }
+
+    /*
+     * stop()까지 실행
+     * runUntil(): done()이 true가 되거나 timeoutMs가 지나거나 stop()될 때까지 (반환값: done())
+     */
+    void run();
+    bool runUntil(const std::function<bool()>& done, int timeoutMs);
+    void stop();
+    bool stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+private:
+    void dispatch(int timeoutMs);
+
+    int epollFd_ = -1;
+    int stopFd_ = -1;
+    int signalFd_ = -1;
+    std::atomic<bool> stopped_{false};
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef FACTORY_CMD_ABI_H
+#define FACTORY_CMD_ABI_H
+
+/*
+ * 브리지 ↔ 커널 드라이버 바이너리 명령 ABI (unlocked_ioctl)
+ *
+ * - 커널 드라이버(C)와 브리지(C++)가 같이 include 하는 헤더
+ *   드라이버 Kbuild/Makefile: ccflags-y += -I$(src)/../mqtt_bridge
+ * - 텍스트 명령(write)은 그대로 두고, 같은 동작을 고정 크기 구조체로도 받음
+ *   → 명령마다 문자열 만들기(snprintf) / 해석(strncmp, sscanf)이 양쪽에서 모두 빠짐
+ * - 모든 구조체 첫 필드는 version (FACTORY_CMD_ABI_VERSION)
+ *   드라이버는 버전이 다르면 -EPROTO, 지원하지 않는 ioctl은 -ENOTTY
+ *   → 브리지는 이 두 경우 텍스트 명령으로 되돌아감
+ * - 구조체를 바꿀 때는 필드를 끝에만 추가하고 버전을 올릴 것 (ioctl 번호에 크기가 들어감)
+ */
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define FACTORY_CMD_ABI_VERSION 1
+#define FACTORY_CMD_IOC_MAGIC   'F'
+
+/* 모드 명령 (장치마다 지원하는 값만 받음, 나머지는 -EINVAL) */
+enum factory_mode {
+    FACTORY_MODE_OFF = 0,      /* 전 장치: 정지 */
+    FACTORY_MODE_ON = 1,       /* 컨베이어 / 피더: 가동, 로봇암: 자동 모드 */
+    FACTORY_MODE_REVERSE = 2,  /* 피더: 역방향 회전 */
+    FACTORY_MODE_ERROR = 3,    /* 컨베이어: error_mode, 피더: error */
+    FACTORY_MODE_NORMAL = 4,   /* 피더: 속도 복구 */
+    FACTORY_MODE_USER = 5,     /* 로봇암: 수동 모드 */
+    FACTORY_MODE_INIT = 6,     /* 로봇암: 초기 자세 */
+};
+
+/* 모터 번호 (L298N) */
+enum factory_motor {
+    FACTORY_MOTOR_A = 0,
+    FACTORY_MOTOR_B = 1,
+};
+
+struct factory_mode_cmd {
+    __u32 version;
+    __u32 mode;        /* enum factory_mode */
+};
+
+/* DC 모터 하나 (L298N): 방향 -1/0/1, 속도 0~100 */
+struct factory_motor_cmd {
+    __u32 version;
+    __u32 motor;       /* enum factory_motor */
+    __s32 direction;
+    __s32 speed;
+};
+
+/* 서보 하나 (로봇암 관절 0~3, 각도 0~250 - 수동 모드에서만 동작) */
+struct factory_servo_cmd {
+    __u32 version;
+    __u32 joint;
+    __s32 angle;
+    __u32 reserved;
+};
+
+/* 이송 속도 (컨베이어 스테퍼: 1~100) */
+struct factory_speed_cmd {
+    __u32 version;
+    __s32 speed;
+};
+
+#define FACTORY_IOC_VERSION _IOR(FACTORY_CMD_IOC_MAGIC, 0, __u32)
+#define FACTORY_IOC_MODE    _IOW(FACTORY_CMD_IOC_MAGIC, 1, struct factory_mode_cmd)
+#define FACTORY_IOC_MOTOR   _IOW(FACTORY_CMD_IOC_MAGIC, 2, struct factory_motor_cmd)
+#define FACTORY_IOC_SERVO   _IOW(FACTORY_CMD_IOC_MAGIC, 3, struct factory_servo_cmd)
+#define FACTORY_IOC_SPEED   _IOW(FACTORY_CMD_IOC_MAGIC, 4, struct factory_speed_cmd)
+
+#endif
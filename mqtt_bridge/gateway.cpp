@@ -0,0 +1,195 @@
+#include "gateway.hpp"
+#include "device_policies.hpp"
+#include <fstream>
+#include <sstream>
+
+std::unique_ptr<GatewayDevice> makeGatewayDevice(std::string_view kind) {
+    if (kind == "conveyor") return std::make_unique<GatewayAdapter<ConveyorPolicy>>();
+    if (kind == "feeder") return std::make_unique<GatewayAdapter<FeederPolicy>>();
+    if (kind == "robot_arm") return std::make_unique<GatewayAdapter<RobotArmPolicy>>();
+    if (kind == "l298n") return std::make_unique<GatewayAdapter<L298nPolicy>>();
+    return nullptr;
+}
+
+bool TopicRouter::add(std::string_view topic, GatewayDevice* device) {
+    if (!device || find(topic)) return false;
+    if ((count_ + 1) * 2 > slots_.size()) grow();
+
+    uint32_t hash = hashTopic(topic);
+    size_t mask = slots_.size() - 1;
+    size_t i = hash & mask;
+    while (slots_[i].device) i = (i + 1) & mask;
+
+    slots_[i].topic = std::string(topic);
+    slots_[i].hash = hash;
+    slots_[i].device = device;
+    count_++;
+    return true;
+}
+
+GatewayDevice* TopicRouter::find(std::string_view topic) const {
+    uint32_t hash = hashTopic(topic);
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask; slots_[i].device; i = (i + 1) & mask) {
+        if (slots_[i].hash == hash && slots_[i].topic == topic) return slots_[i].device;
+    }
+    return nullptr;
+}
+
+void TopicRouter::grow() {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+    size_t mask = slots_.size() - 1;
+    for (Slot& slot : old) {
+        if (!slot.device) continue;
+        size_t i = slot.hash & mask;
+        while (slots_[i].device) i = (i + 1) & mask;
+        slots_[i] = std::move(slot);
+    }
+}
+
+bool loadGatewayConfig(const std::string& path, const BridgeConfig& base, std::vector<GatewayDeviceConfig>& devices) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "게이트웨이 설정 파일을 열 수 없음: " << path << std::endl;
+        return false;
+    }
+
+    devices.clear();
+    std::string line;
+    for (int lineNo = 1; std::getline(file, line); lineNo++) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream fields(line);
+        GatewayDeviceConfig device;
+        device.bridge = base;
+        if (!(fields >> device.kind)) continue;   // 빈 줄
+        if (!(fields >> device.bridge.deviceId)) {
+            std::cerr << path << ":" << lineNo << ": device_id 없음" << std::endl;
+            return false;
+        }
+
+        std::string option;
+        while (fields >> option) {
+            size_t eq = option.find('=');
+            std::string key = option.substr(0, eq);
+            std::string value = eq == std::string::npos ? std::string() : option.substr(eq + 1);
+            if (key == "dev") device.bridge.devicePath = value;
+            else if (key == "cmd") device.bridge.commandTopic = value;
+            else if (key == "status") device.bridge.statusTopic = value;
+            else if (key == "telemetry") device.bridge.telemetryTopic = value;
+            else {
+                std::cerr << path << ":" << lineNo << ": 알 수 없는 옵션 " << option << std::endl;
+                return false;
+            }
+        }
+        devices.push_back(std::move(device));
+    }
+
+    if (devices.empty()) {
+        std::cerr << "게이트웨이 설정에 장치가 없음: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Gateway::open(const BridgeConfig& sessionCfg, const std::vector<GatewayDeviceConfig>& devices) {
+    close();
+
+    BridgeConfig cfg = sessionCfg;
+    cfg.commandTopic.clear();
+    if (!session_.open(cfg, "gateway")) return false;
+
+    devices_.clear();
+    router_ = TopicRouter();
+    for (const GatewayDeviceConfig& config : devices) {
+        std::unique_ptr<GatewayDevice> device = makeGatewayDevice(config.kind);
+        if (!device) {
+            std::cerr << "알 수 없는 장치 종류: " << config.kind
+                      << " (conveyor / feeder / robot_arm / l298n)" << std::endl;
+            session_.close();
+            return false;
+        }
+
+        device->attach(session_, config.bridge);
+        if (device->commandTopic().empty() || !router_.add(device->commandTopic(), device.get())) {
+            std::cerr << "명령 토픽이 비었거나 다른 장치와 겹침: " << device->deviceId()
+                      << " (" << device->commandTopic() << ")" << std::endl;
+            session_.close();
+            return false;
+        }
+        session_.addSubscription(device->commandTopic());
+        std::cout << "장치 등록: " << device->deviceId() << " (" << device->kind() << ") ← "
+                  << device->commandTopic() << std::endl;
+        devices_.push_back(std::move(device));
+    }
+
+    session_.setMessageHandler([this](const char* topic, const char* payload, size_t len) {
+        route(topic, payload, len);
+    });
+    opened_ = true;
+    return true;
+}
+
+bool Gateway::connect(EventLoop& loop) {
+    if (!opened_) return false;
+
+    for (auto& device : devices_) {
+        device->openDevice();   // 실패해도 명령을 받을 때 다시 시도
+        device->start();
+    }
+    return session_.connect(loop);
+}
+
+void Gateway::close() {
+    if (!opened_) return;
+
+    session_.disconnect();
+    for (auto& device : devices_) device->closeDevice();
+    session_.close();
+    opened_ = false;
+}
+
+void Gateway::route(const char* topic, const char* payload, size_t len) {
+    GatewayDevice* device = router_.find(topic);
+    if (!device) {
+        unrouted_.fetch_add(1, std::memory_order_relaxed);
+        std::cerr << "등록되지 않은 토픽: " << topic << std::endl;
+        return;
+    }
+    device->handlePayload(payload, len);
+}
+
+void Gateway::printMetrics() const {
+    for (const auto& device : devices_) {
+        std::cout << "[지표] " << device->deviceId() << " (" << device->kind() << ") " << device->metrics() << std::endl;
+    }
+    if (unrouted() > 0) std::cout << "[지표] 등록되지 않은 토픽 메시지 " << unrouted() << std::endl;
+}
+
+int runGateway(const BridgeConfig& sessionCfg, const std::vector<GatewayDeviceConfig>& devices) {
+    // 시그널은 장치별 디바이스 스레드를 만들기 전에 막고 signalfd로 받음
+    EventLoop loop;
+    if (!loop.valid() || !loop.addSignals({SIGINT, SIGTERM}, [&loop](int) { loop.stop(); })) return 1;
+
+    Gateway gateway;
+    if (!gateway.open(sessionCfg, devices)) return 1;
+    if (!gateway.connect(loop)) {
+        gateway.close();
+        return 1;
+    }
+
+    std::cout << "게이트웨이 실행 중... 장치 " << gateway.devices().size() << "개, MQTT 연결 1개 (Ctrl+C로 종료)"
+              << std::endl;
+    std::cout << "Client ID: " << gateway.session().deviceId() << std::endl;
+
+    int metricsTimer = loop.addTimer(60000, [&gateway] { gateway.printMetrics(); });
+    loop.run();
+    loop.closeTimer(metricsTimer);
+
+    std::cout << "프로그램 종료 중..." << std::endl;
+    gateway.close();
+    gateway.printMetrics();
+    return 0;
+}
@@ -0,0 +1,159 @@
+#ifndef GATEWAY_HPP
+#define GATEWAY_HPP
+
+#include "device_bridge.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * 한 호스트의 여러 장치를 TLS 연결 하나로 처리하는 게이트웨이
+ *
+ * - MqttSession 하나 (TLS 핸드셰이크 / 세션 메모리 / keepalive가 호스트당 하나)
+ * - 장치마다 어댑터(GatewayAdapter<정책> = DeviceBridge<정책>)를 세션에 attach()
+ *   장치별 명령 토픽을 모두 구독하고, 수신 토픽 → 어댑터는 TopicRouter(해시 표)로 찾음
+ * - 장치마다 SPSC 대기열 + 디바이스 스레드가 따로 있음 → 한 드라이버가 느려도 다른 장치 명령은 막히지 않음
+ */
+
+/*
+ * 게이트웨이가 다루는 장치 하나 (정책 타입을 숨긴 인터페이스)
+ */
+class GatewayDevice {
+public:
+    virtual ~GatewayDevice() = default;
+
+    virtual const char* kind() const = 0;
+    virtual void attach(MqttSession& session, const BridgeConfig& cfg) = 0;
+    virtual bool openDevice() = 0;
+    virtual void start() = 0;
+    virtual void closeDevice() = 0;
+
+    /*
+     * 이벤트 루프 스레드에서 호출 (장치별 대기열의 유일한 생산자)
+     */
+    virtual bool handlePayload(const char* payload, size_t len) = 0;
+
+    virtual const std::string& deviceId() const = 0;
+    virtual const std::string& commandTopic() const = 0;
+    virtual BridgeMetrics metrics() const = 0;
+};
+
+template <typename Policy>
+class GatewayAdapter : public GatewayDevice {
+public:
+    const char* kind() const override { return Policy::kName; }
+    void attach(MqttSession& session, const BridgeConfig& cfg) override { bridge_.attach(session, cfg); }
+    bool openDevice() override { return bridge_.openDevice(); }
+    void start() override { bridge_.start(); }
+    void closeDevice() override { bridge_.closeDevice(); }
+    bool handlePayload(const char* payload, size_t len) override { return bridge_.handlePayload(payload, len); }
+    const std::string& deviceId() const override { return bridge_.deviceId(); }
+    const std::string& commandTopic() const override { return bridge_.commandTopic(); }
+    BridgeMetrics metrics() const override { return bridge_.metrics(); }
+
+    DeviceBridge<Policy>& bridge() { return bridge_; }
+
+private:
+    DeviceBridge<Policy> bridge_;
+};
+
+/*
+ * 장치 종류 이름 → 어댑터 (conveyor / feeder / robot_arm / l298n, 모르는 이름이면 nullptr)
+ */
+std::unique_ptr<GatewayDevice> makeGatewayDevice(std::string_view kind);
+
+/*
+ * 명령 토픽 → 장치 (개방 주소 해시 표, 선형 탐사)
+ * - add()는 연결 전에만, find()는 연결 후 이벤트 루프 스레드에서 (표가 바뀌지 않으므로 잠금 없음)
+ * - 조회 = FNV-1a 해시 한 번 + 보통 문자열 비교 한 번, 할당 없음
+ */
+class TopicRouter {
+public:
+    TopicRouter() : slots_(16) {}
+
+    /*
+     * 반환값: 같은 토픽이 이미 있으면 false
+     */
+    bool add(std::string_view topic, GatewayDevice* device);
+    GatewayDevice* find(std::string_view topic) const;
+    size_t size() const { return count_; }
+
+private:
+    struct Slot {
+        std::string topic;
+        uint32_t hash = 0;
+        GatewayDevice* device = nullptr;   // nullptr: 빈 슬롯
+    };
+
+    static uint32_t hashTopic(std::string_view topic) { return commandHash(topic, 0); }
+    void grow();
+
+    std::vector<Slot> slots_;   // 크기는 2의 거듭제곱, 사용률 50% 이하
+    size_t count_ = 0;
+};
+
+/*
+ * 게이트웨이 설정 파일의 장치 한 줄
+ *   <종류> <device_id> [dev=<디바이스 파일>] [cmd=<명령 토픽>] [status=<상태 토픽>] [telemetry=<텔레메트리 토픽>]
+ * - 토픽에는 {device_id} 사용 가능, 생략하면 게이트웨이 공통 설정값
+ */
+struct GatewayDeviceConfig {
+    std::string kind;
+    BridgeConfig bridge;
+};
+
+/*
+ * 설정 파일 읽기 (# 주석, 빈 줄 무시)
+ * - base: 장치별 BridgeConfig 기본값 (토픽 템플릿 / 텔레메트리 주기)
+ * - 형식 오류가 있으면 줄 번호와 함께 출력하고 false
+ */
+bool loadGatewayConfig(const std::string& path, const BridgeConfig& base, std::vector<GatewayDeviceConfig>& devices);
+
+class Gateway {
+public:
+    Gateway() = default;
+    ~Gateway() { close(); }
+
+    Gateway(const Gateway&) = delete;
+    Gateway& operator=(const Gateway&) = delete;
+
+    /*
+     * 세션 준비 + 장치 어댑터 생성 / 라우팅 표 등록 / 명령 토픽 구독 등록
+     * - sessionCfg.commandTopic은 쓰지 않음 (장치별 명령 토픽만 구독)
+     * - 모르는 종류이거나 명령 토픽이 겹치면 false
+     */
+    bool open(const BridgeConfig& sessionCfg, const std::vector<GatewayDeviceConfig>& devices);
+
+    /*
+     * 디바이스 파일 열기 + 장치별 디바이스 스레드 시작 후 브로커 연결 (네트워크 처리는 loop에서)
+     */
+    bool connect(EventLoop& loop);
+
+    /*
+     * 연결 해제 후 장치별로 대기 중인 명령을 보내고 종료 명령 전송
+     */
+    void close();
+
+    MqttSession& session() { return session_; }
+    const std::vector<std::unique_ptr<GatewayDevice>>& devices() const { return devices_; }
+    uint64_t unrouted() const { return unrouted_.load(std::memory_order_relaxed); }
+
+    void printMetrics() const;
+
+private:
+    void route(const char* topic, const char* payload, size_t len);
+
+    MqttSession session_;
+    std::vector<std::unique_ptr<GatewayDevice>> devices_;
+    TopicRouter router_;
+    std::atomic<uint64_t> unrouted_{0};
+    bool opened_ = false;
+};
+
+/*
+ * 게이트웨이 데몬 본체 - 연결 후 SIGINT/SIGTERM까지 이벤트 루프 실행
+ */
+int runGateway(const BridgeConfig& sessionCfg, const std::vector<GatewayDeviceConfig>& devices);
+
+#endif
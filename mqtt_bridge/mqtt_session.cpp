@@ -0,0 +1,349 @@
+#include "mqtt_session.hpp"
+#include "cert_utils.hpp"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+BridgeConfig certConfigFromEnv(const std::string& defaultCertDir, const std::string& certName) {
+    BridgeConfig cfg;
+    std::string certDir = defaultCertDir;
+    const char* envCertPath = getenv("CERT_PATH");
+    if (envCertPath != nullptr) {
+        certDir = envCertPath;
+    }
+
+    cfg.caPath = certDir + "/ca.crt";
+    cfg.certPath = certDir + "/" + certName + ".crt";
+    cfg.keyPath = certDir + "/" + certName + ".key";
+
+    const char* envInterval = getenv("TELEMETRY_INTERVAL_MS");
+    if (envInterval != nullptr) {
+        cfg.telemetryIntervalMs = atoi(envInterval);
+    }
+    const char* envSnapshot = getenv("TELEMETRY_SNAPSHOT_SEC");
+    if (envSnapshot != nullptr) {
+        cfg.snapshotIntervalSec = atoi(envSnapshot);
+    }
+    const char* envReconnectMax = getenv("RECONNECT_MAX_MS");
+    if (envReconnectMax != nullptr && atoi(envReconnectMax) > 0) {
+        cfg.reconnect.maxDelayMs = atoi(envReconnectMax);
+    }
+    return cfg;
+}
+
+MqttSession::~MqttSession() {
+    close();
+}
+
+bool MqttSession::open(const BridgeConfig& cfg, const std::string& defaultDeviceId) {
+    close();
+    tlsCache_.clear();
+    cfg_ = cfg;
+
+    if (cfg_.useTls) {
+        std::cout << "사용할 인증서 경로:" << std::endl;
+        std::cout << "  CA: " << cfg_.caPath << std::endl;
+        std::cout << "  인증서: " << cfg_.certPath << std::endl;
+        std::cout << "  키: " << cfg_.keyPath << std::endl;
+
+        bool caExists = std::ifstream(cfg_.caPath).good();
+        if (!caExists) {
+            std::cerr << "CA 인증서 파일 없음: " << cfg_.caPath << std::endl;
+        }
+        if (!CertUtils::validateCertFiles(cfg_.certPath, cfg_.keyPath) || !caExists) {
+            std::cerr << "인증서 파일을 열 수 없습니다. 경로를 확인하세요." << std::endl;
+            return false;
+        }
+    }
+
+    // device_id: 설정값 → 인증서 CN → 기본값
+    deviceId_ = cfg_.deviceId;
+    if (deviceId_.empty() && cfg_.useTls) {
+        deviceId_ = CertUtils::extractDeviceIdFromCert(cfg_.certPath);
+    }
+    if (deviceId_.empty()) {
+        deviceId_ = defaultDeviceId;
+    }
+    subscriptions_.clear();
+    if (!cfg_.commandTopic.empty()) {
+        subscriptions_.push_back(formatTopic(cfg_.commandTopic));
+    }
+    backoff_ = ReconnectBackoff(cfg_.reconnect);
+
+    mosquitto_lib_init();
+    mosq_ = mosquitto_new(deviceId_.c_str(), true, this);
+    if (!mosq_) {
+        std::cerr << "MQTT 클라이언트 생성 실패" << std::endl;
+        mosquitto_lib_cleanup();
+        return false;
+    }
+
+    // 네트워크 I/O는 루프 스레드에서만 → 다른 스레드의 발행은 패킷을 넣기만 하고 루프가 보냄
+    mosquitto_threaded_set(mosq_, true);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mosquitto_connect_callback_set(mosq_, onConnect);
+    mosquitto_message_callback_set(mosq_, onMessage);
+    mosquitto_disconnect_callback_set(mosq_, onDisconnect);
+    mosquitto_subscribe_callback_set(mosq_, onSubscribe);
+
+    if (cfg_.useTls) {
+        std::cout << "TLS 설정 중..." << std::endl;
+        int rc = mosquitto_tls_set(mosq_, cfg_.caPath.c_str(), nullptr,
+                                   cfg_.certPath.c_str(), cfg_.keyPath.c_str(), nullptr);
+        if (rc != MOSQ_ERR_SUCCESS) {
+            std::cerr << "TLS 설정 실패: " << mosquitto_strerror(rc) << std::endl;
+            close();
+            return false;
+        }
+
+        rc = mosquitto_tls_opts_set(mosq_, 1, "tlsv1.2", nullptr);
+        if (rc != MOSQ_ERR_SUCCESS) {
+            std::cerr << "TLS 옵션 설정 실패: " << mosquitto_strerror(rc) << std::endl;
+        }
+        mosquitto_tls_insecure_set(mosq_, false);
+
+        // 세션 재사용용 SSL_CTX (CA / 인증서 / 검증은 위 설정을 mosquitto가 그대로 적용)
+        SSL_CTX* ctx = tlsCache_.createContext();
+        if (ctx) {
+            mosquitto_int_option(mosq_, MOSQ_OPT_SSL_CTX_WITH_DEFAULTS, 1);
+            rc = mosquitto_void_option(mosq_, MOSQ_OPT_SSL_CTX, ctx);
+            if (rc != MOSQ_ERR_SUCCESS) {
+                std::cerr << "TLS 세션 재사용 설정 실패 (매번 전체 핸드셰이크): " << mosquitto_strerror(rc) << std::endl;
+            }
+            SSL_CTX_free(ctx);   // mosquitto가 참조를 따로 잡고 있음
+        }
+    }
+    return true;
+}
+
+void MqttSession::close() {
+    disconnect();
+    if (mosq_) {
+        mosquitto_destroy(mosq_);
+        mosq_ = nullptr;
+        mosquitto_lib_cleanup();
+    }
+    if (wakeFd_ >= 0) {
+        ::close(wakeFd_);
+        wakeFd_ = -1;
+    }
+}
+
+bool MqttSession::connect(EventLoop& loop) {
+    if (!mosq_) return false;
+    disconnect();
+
+    loop_ = &loop;
+    backoff_.reset();
+    disconnectedNs_ = 0;
+    loop_->add(wakeFd_, EPOLLIN, [this](uint32_t) {
+        uint64_t count;
+        if (read(wakeFd_, &count, sizeof(count)) == sizeof(count)) updateInterest();
+    });
+    miscTimerFd_ = loop_->addTimer(1000, [this] { onMiscTimer(); });
+    retryTimerFd_ = loop_->createTimer([this] { onRetryTimer(); });
+
+    // 소켓 연결만 하고 바로 반환 (TLS 핸드셰이크 / CONNECT는 루프에서 진행)
+    // 시작할 때 브로커가 없거나 DNS 조회가 실패해도 끊김과 같이 대기 시간 뒤 재시도 (주소는 mosquitto가 기억)
+    std::cout << "MQTT 브로커에 연결 중: " << cfg_.brokerHost << ":" << cfg_.brokerPort << std::endl;
+    int rc = mosquitto_connect_async(mosq_, cfg_.brokerHost.c_str(), cfg_.brokerPort, cfg_.keepalive);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        std::cerr << "연결 실패: " << mosquitto_strerror(rc) << std::endl;
+        connectionLost(rc);
+    } else if (!watchSocket()) {
+        connectionLost(MOSQ_ERR_NO_CONN);
+    }
+    return true;
+}
+
+bool MqttSession::waitConnected(int timeoutMs) {
+    if (!loop_) return false;
+    return loop_->runUntil([this] { return isConnected(); }, timeoutMs);
+}
+
+void MqttSession::disconnect() {
+    if (!mosq_ || !loop_) return;
+
+    // DISCONNECT 패킷을 바로 보내 봄 (소켓이 막혀 있으면 포기, 브로커는 keepalive로 정리)
+    mosquitto_disconnect(mosq_);
+    if (socketFd_ >= 0) mosquitto_loop_write(mosq_, 1);
+
+    unwatchSocket();
+    loop_->remove(wakeFd_);
+    loop_->closeTimer(miscTimerFd_);
+    loop_->closeTimer(retryTimerFd_);
+    miscTimerFd_ = -1;
+    retryTimerFd_ = -1;
+    loop_ = nullptr;
+    connected_.store(false, std::memory_order_release);
+}
+
+/*
+ * mosquitto 소켓을 루프에 등록 (연결 / 재연결할 때마다 fd가 바뀔 수 있음)
+ */
+bool MqttSession::watchSocket() {
+    unwatchSocket();
+    int fd = mosquitto_socket(mosq_);
+    if (fd < 0) return false;
+
+    socketEvents_ = EPOLLIN | (mosquitto_want_write(mosq_) ? EPOLLOUT : 0u);
+    if (!loop_->add(fd, socketEvents_, [this](uint32_t events) { onSocketEvent(events); })) return false;
+    socketFd_ = fd;
+    return true;
+}
+
+void MqttSession::unwatchSocket() {
+    if (socketFd_ < 0) return;
+    loop_->remove(socketFd_);
+    socketFd_ = -1;
+}
+
+/*
+ * 보낼 패킷이 있을 때만 EPOLLOUT 감시 (없으면 쓰기 가능 이벤트로 계속 깨어나지 않게)
+ */
+void MqttSession::updateInterest() {
+    if (socketFd_ < 0) return;
+    if (mosquitto_socket(mosq_) != socketFd_) {
+        connectionLost(MOSQ_ERR_CONN_LOST);   // mosquitto가 소켓을 닫음 (keepalive 초과 등)
+        return;
+    }
+
+    uint32_t events = EPOLLIN | (mosquitto_want_write(mosq_) ? EPOLLOUT : 0u);
+    if (events != socketEvents_ && loop_->modify(socketFd_, events)) socketEvents_ = events;
+}
+
+void MqttSession::onSocketEvent(uint32_t events) {
+    // 연결 전(TCP 연결 완료 → TLS 핸드셰이크 → CONNACK)에는 어떤 이벤트든 읽기 경로로 진행
+    // - 비동기 연결의 TLS 핸드셰이크는 mosquitto_loop_read()에서만 진행되고 loop_write()는 그냥 반환함
+    //   (mosquitto_loop()도 쓰기 가능하면 핸드셰이크를 진행) - 안 그러면 EPOLLOUT만 계속 울리며 연결이 안 됨
+    bool connecting = !connected_.load(std::memory_order_acquire);
+    int rc = MOSQ_ERR_SUCCESS;
+    if (connecting || (events & (EPOLLIN | EPOLLERR | EPOLLHUP))) rc = mosquitto_loop_read(mosq_, 1);
+    if (rc == MOSQ_ERR_SUCCESS && (events & EPOLLOUT)) rc = mosquitto_loop_write(mosq_, 1);
+
+    if (rc != MOSQ_ERR_SUCCESS) connectionLost(rc);
+    else updateInterest();
+}
+
+void MqttSession::onMiscTimer() {
+    if (socketFd_ < 0) return;
+    int rc = mosquitto_loop_misc(mosq_);
+    if (rc != MOSQ_ERR_SUCCESS) connectionLost(rc);
+    else updateInterest();
+}
+
+/*
+ * 끊김: 소켓 감시 해제 후 대기 시간 뒤 재연결 (one-shot timerfd)
+ */
+void MqttSession::connectionLost(int rc) {
+    unwatchSocket();
+    markDisconnected();
+
+    int delayMs = backoff_.nextDelayMs();
+    std::cout << "MQTT 재연결 대기: " << delayMs << "ms (" << backoff_.attempts() << "번째 시도, "
+              << mosquitto_strerror(rc) << ")" << std::endl;
+    EventLoop::armTimer(retryTimerFd_, delayMs > 0 ? delayMs : 1);
+}
+
+void MqttSession::onRetryTimer() {
+    reconnects_.fetch_add(1, std::memory_order_relaxed);
+    int rc = mosquitto_reconnect_async(mosq_);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        std::cerr << "재연결 실패: " << mosquitto_strerror(rc) << std::endl;
+        connectionLost(rc);
+        return;
+    }
+    if (!watchSocket()) connectionLost(MOSQ_ERR_NO_CONN);
+}
+
+void MqttSession::markDisconnected() {
+    connected_.store(false, std::memory_order_release);
+    if (disconnectedNs_ == 0) disconnectedNs_ = steadyNs();
+}
+
+bool MqttSession::publish(const std::string& topic, const std::string& payload, int qos, bool retain) {
+    if (!mosq_ || !isConnected()) return false;
+
+    int rc = mosquitto_publish(mosq_, nullptr, topic.c_str(), static_cast<int>(payload.size()),
+                               payload.data(), qos, retain);
+    if (rc != MOSQ_ERR_SUCCESS) {
+        std::cerr << "발행 실패: " << topic << " (" << mosquitto_strerror(rc) << ")" << std::endl;
+        return false;
+    }
+    EventLoop::notify(wakeFd_);   // 루프가 EPOLLOUT을 켜고 바로 보냄
+    return true;
+}
+
+std::string MqttSession::formatTopic(const std::string& topicTemplate, const std::string& deviceId) {
+    static const std::string placeholder = "{device_id}";
+    std::string result = topicTemplate;
+    size_t pos = result.find(placeholder);
+    if (pos != std::string::npos) {
+        result.replace(pos, placeholder.size(), deviceId);
+    }
+    return result;
+}
+
+void MqttSession::onConnect(struct mosquitto* mosq, void* self, int reasonCode) {
+    MqttSession* session = static_cast<MqttSession*>(self);
+    if (reasonCode != 0) {
+        std::cerr << "연결 실패: " << mosquitto_connack_string(reasonCode) << std::endl;
+        return;
+    }
+
+    std::cout << "MQTT 브로커에 TLS로 연결 성공!" << std::endl;
+    session->connected_.store(true, std::memory_order_release);
+    session->connectAttempts_ = session->backoff_.attempts();
+    session->backoff_.reset();
+
+    // SUBACK은 보낸 순서대로 오므로 마지막 구독의 SUBACK = 전체 재구독 완료
+    for (const std::string& topic : session->subscriptions_) {
+        int rc = mosquitto_subscribe(mosq, &session->subscribeMid_, topic.c_str(), 1);
+        if (rc == MOSQ_ERR_SUCCESS) {
+            std::cout << "토픽 구독 성공: " << topic << std::endl;
+        } else {
+            std::cerr << "토픽 구독 실패: " << topic << " (" << mosquitto_strerror(rc) << ")" << std::endl;
+        }
+    }
+}
+
+void MqttSession::onDisconnect(struct mosquitto*, void* self, int reasonCode) {
+    MqttSession* session = static_cast<MqttSession*>(self);
+    session->markDisconnected();
+    std::cout << "MQTT 연결 해제: " << mosquitto_strerror(reasonCode) << std::endl;
+}
+
+void MqttSession::onSubscribe(struct mosquitto*, void* self, int mid, int, const int*) {
+    MqttSession* session = static_cast<MqttSession*>(self);
+    if (mid != session->subscribeMid_ || session->disconnectedNs_ == 0) return;
+
+    // 재연결 후 명령 토픽 재구독까지 완료 → 이때부터 명령을 다시 받음
+    int64_t elapsedMs = (steadyNs() - session->disconnectedNs_) / 1000000;
+    session->disconnectedNs_ = 0;
+    session->lastResubscribeMs_.store(elapsedMs, std::memory_order_relaxed);
+    std::cout << "재연결 후 재구독 완료: " << elapsedMs << "ms (재시도 " << session->connectAttempts_ << "회, "
+              << (!session->cfg_.useTls ? "TLS 없음"
+                  : session->tlsCache_.lastResumed() ? "TLS 세션 재사용" : "전체 TLS 핸드셰이크") << ")"
+              << std::endl;
+}
+
+void MqttSession::onMessage(struct mosquitto*, void* self, const struct mosquitto_message* message) {
+    MqttSession* session = static_cast<MqttSession*>(self);
+    if (session->handler_) {
+        session->handler_(message->topic, static_cast<const char*>(message->payload),
+                          static_cast<size_t>(message->payloadlen));
+    }
+}
@@ -0,0 +1,166 @@
+#ifndef MQTT_SESSION_HPP
+#define MQTT_SESSION_HPP
+
+#include "event_loop.hpp"
+#include "reconnect_backoff.hpp"
+#include "tls_session_cache.hpp"
+#include <mosquitto.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * 브리지 공통 설정
+ * - deviceId: 비어 있으면 인증서 CN → 정책 기본값 순으로 결정
+ * - commandTopic / statusTopic: {device_id}를 실제 device_id로 바꿔서 사용
+ *   commandTopic이 비어 있으면 구독하지 않음 (게이트웨이처럼 addSubscription()으로만 구독할 때)
+ *   statusTopic이 비어 있으면 상태를 발행하지 않음
+ * - devicePath: 비어 있으면 정책의 기본 디바이스 파일
+ * - telemetryTopic: 드라이버 상태를 telemetryIntervalMs마다 읽어 바뀐 필드만 발행 (비어 있거나 주기가 0이면 끔)
+ *   snapshotIntervalSec마다 전체 필드 발행
+ * - reconnect: 연결이 끊겼을 때 재시도 간격 (첫 재시도는 빠르게, 이후 지수 증가 + 지터)
+ */
+struct BridgeConfig {
+    std::string brokerHost = "mqtt.kwon.pics";
+    int brokerPort = 8883;
+    std::string caPath;
+    std::string certPath;
+    std::string keyPath;
+    int keepalive = 60;
+    bool useTls = true;
+    std::string deviceId;
+    std::string commandTopic = "{device_id}/cmd";
+    std::string statusTopic;
+    std::string devicePath;
+    std::string telemetryTopic = "{device_id}/telemetry";
+    int telemetryIntervalMs = 1000;
+    int snapshotIntervalSec = 30;
+    ReconnectPolicy reconnect;
+};
+
+/*
+ * 인증서 디렉토리 기준 설정 (CERT_PATH 환경 변수가 있으면 그 디렉토리 사용)
+ * - <dir>/ca.crt, <dir>/<certName>.crt, <dir>/<certName>.key
+ * - TELEMETRY_INTERVAL_MS / TELEMETRY_SNAPSHOT_SEC 환경 변수로 텔레메트리 주기 변경 (0이면 끔)
+ * - RECONNECT_MAX_MS 환경 변수로 재연결 최대 대기 시간 변경
+ */
+BridgeConfig certConfigFromEnv(const std::string& defaultCertDir, const std::string& certName);
+
+/*
+ * mosquitto TLS 클라이언트 한 개 (연결 / 구독 / 발행)
+ * - 연결될 때마다 명령 토픽(+ addSubscription() 토픽)을 다시 구독
+ * - 네트워크 처리는 EventLoop 스레드에서 (전용 스레드 없음)
+ *   소켓은 epoll로 감시해서 읽을 것이 있을 때 mosquitto_loop_read(), 보낼 것이 있을 때만 EPOLLOUT → mosquitto_loop_write()
+ *   keepalive / 재전송은 1초 timerfd → mosquitto_loop_misc()
+ * - 수신 메시지는 setMessageHandler()로 넘긴 함수가 루프 스레드에서 처리
+ * - publish()는 어느 스레드에서나 가능 (보낼 패킷을 넣고 eventfd로 루프를 깨움 → 바로 전송)
+ * - 끊기면 ReconnectBackoff 간격의 one-shot timerfd로 재연결 (TLS 세션 재사용)
+ *   끊긴 시점부터 명령 토픽 재구독(SUBACK)까지 걸린 시간을 기록
+ */
+class MqttSession {
+public:
+    using MessageHandler = std::function<void(const char* topic, const char* payload, size_t len)>;
+
+    MqttSession() = default;
+    ~MqttSession();
+
+    MqttSession(const MqttSession&) = delete;
+    MqttSession& operator=(const MqttSession&) = delete;
+
+    /*
+     * 클라이언트 생성 + TLS 설정 (아직 연결하지 않음)
+     * - 인증서 파일이 없거나 TLS 설정에 실패하면 원인을 출력하고 false
+     */
+    bool open(const BridgeConfig& cfg, const std::string& defaultDeviceId);
+    void close();
+
+    /*
+     * 브로커 연결 요청 후 loop에 소켓 / keepalive 타이머 / 재연결 타이머 등록
+     * - 반환값: open()하지 않았으면 false
+     *   첫 연결 요청이 실패해도(브로커 없음, DNS 실패) 끊김과 같이 대기 시간 뒤 재시도하고 true
+     *   (CONNACK은 waitConnected() 또는 loop.run() 중에 옴)
+     * - loop는 disconnect() / close()까지 살아 있어야 함
+     */
+    bool connect(EventLoop& loop);
+
+    /*
+     * 루프를 돌리면서 CONNACK 대기 (루프 스레드에서 호출, 연결되면 바로 반환)
+     */
+    bool waitConnected(int timeoutMs);
+
+    /*
+     * DISCONNECT를 보내고 루프에서 해제 (루프 스레드에서 호출)
+     */
+    void disconnect();
+    bool isConnected() const { return connected_.load(std::memory_order_acquire); }
+
+    void setMessageHandler(MessageHandler handler) { handler_ = std::move(handler); }
+
+    /*
+     * 명령 토픽 외에 같이 구독할 토픽 추가 (connect() 전에만 호출)
+     */
+    void addSubscription(const std::string& topic) { subscriptions_.push_back(topic); }
+    bool publish(const std::string& topic, const std::string& payload, int qos = 1, bool retain = false);
+
+    const std::string& deviceId() const { return deviceId_; }
+    const BridgeConfig& config() const { return cfg_; }
+
+    /*
+     * 토픽 템플릿의 {device_id} 치환
+     */
+    std::string formatTopic(const std::string& topicTemplate) const { return formatTopic(topicTemplate, deviceId_); }
+    static std::string formatTopic(const std::string& topicTemplate, const std::string& deviceId);
+
+    /*
+     * 재연결 지표 (어느 스레드에서나 조회 가능)
+     * - lastResubscribeMs: 마지막으로 끊긴 시점 → 재구독 완료까지 (-1: 아직 재연결 없음)
+     */
+    uint64_t reconnects() const { return reconnects_.load(std::memory_order_relaxed); }
+    int64_t lastResubscribeMs() const { return lastResubscribeMs_.load(std::memory_order_relaxed); }
+    uint64_t tlsHandshakes() const { return tlsCache_.handshakes(); }
+    uint64_t tlsResumed() const { return tlsCache_.resumed(); }
+
+private:
+    static void onConnect(struct mosquitto* mosq, void* self, int reasonCode);
+    static void onDisconnect(struct mosquitto* mosq, void* self, int reasonCode);
+    static void onSubscribe(struct mosquitto* mosq, void* self, int mid, int qosCount, const int* grantedQos);
+    static void onMessage(struct mosquitto* mosq, void* self, const struct mosquitto_message* message);
+
+    bool watchSocket();
+    void unwatchSocket();
+    void updateInterest();
+    void onSocketEvent(uint32_t events);
+    void onMiscTimer();
+    void onRetryTimer();
+    void connectionLost(int rc);
+    void markDisconnected();
+
+    BridgeConfig cfg_;
+    std::string deviceId_;
+    std::vector<std::string> subscriptions_;    // 명령 토픽 + addSubscription()
+    TlsSessionCache tlsCache_;
+    struct mosquitto* mosq_ = nullptr;
+    std::atomic<bool> connected_{false};
+    MessageHandler handler_;
+
+    int wakeFd_ = -1;                // eventfd: 다른 스레드 발행 → 루프 깨우기 (open() ~ close())
+
+    // 아래는 루프 스레드(mosquitto 콜백 포함)만 사용
+    EventLoop* loop_ = nullptr;
+    int socketFd_ = -1;
+    uint32_t socketEvents_ = 0;
+    int miscTimerFd_ = -1;
+    int retryTimerFd_ = -1;
+    ReconnectBackoff backoff_;
+    int64_t disconnectedNs_ = 0;     // 0: 끊긴 상태 아님
+    int connectAttempts_ = 0;        // 이번 연결까지 재시도 횟수
+    int subscribeMid_ = -1;
+
+    std::atomic<uint64_t> reconnects_{0};
+    std::atomic<int64_t> lastResubscribeMs_{-1};
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef QT_RECONNECT_HPP
+#define QT_RECONNECT_HPP
+
+#include "reconnect_backoff.hpp"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QtMqtt/QMqttClient>
+#include <QtMqtt/QMqttSubscription>
+
+/*
+ * Qt MQTT 클라이언트(QMqttClient) 자동 재연결
+ * - 연결이 끊기거나 연결 시도가 실패하면 ReconnectBackoff 간격으로 connectToHost() 다시 호출
+ *   (첫 재시도는 빠르게, 이후 지수 증가 + 지터, 연결되면 처음부터)
+ * - trackSubscription(): connected 핸들러에서 다시 구독한 QMqttSubscription을 넘기면
+ *   끊긴 시점부터 구독 완료까지 걸린 시간을 로그로 출력
+ * - client보다 나중에 선언할 것 (먼저 소멸되면서 연결한 시그널도 같이 끊김)
+ */
+class QtMqttReconnect {
+public:
+    explicit QtMqttReconnect(QMqttClient& client, const ReconnectPolicy& policy = ReconnectPolicy())
+        : client_(client), backoff_(policy) {
+        timer_.setSingleShot(true);
+        QObject::connect(&timer_, &QTimer::timeout, &timer_, [this]() {
+            if (client_.state() == QMqttClient::Disconnected) client_.connectToHost();
+        });
+
+        // timer_를 컨텍스트로 연결 → 이 객체가 소멸되면 자동 해제
+        QObject::connect(&client_, &QMqttClient::disconnected, &timer_, [this]() { scheduleRetry(); });
+        QObject::connect(&client_, &QMqttClient::connected, &timer_, [this]() {
+            connectAttempts_ = backoff_.attempts();
+            backoff_.reset();
+            timer_.stop();
+        });
+    }
+
+    QtMqttReconnect(const QtMqttReconnect&) = delete;
+    QtMqttReconnect& operator=(const QtMqttReconnect&) = delete;
+
+    void trackSubscription(QMqttSubscription* subscription) {
+        if (!subscription) return;
+        QObject::connect(subscription, &QMqttSubscription::stateChanged, &timer_,
+                         [this](QMqttSubscription::SubscriptionState state) {
+            if (state != QMqttSubscription::Subscribed || !disconnectedAt_.isValid()) return;
+            qInfo() << "재연결 후 재구독 완료:" << disconnectedAt_.elapsed() << "ms (재시도"
+                    << connectAttempts_ << "회)";
+            disconnectedAt_.invalidate();
+        });
+    }
+
+    /*
+     * 의도적으로 끊을 때 (disconnectFromHost() 전에 호출하면 재연결하지 않음)
+     */
+    void stop() {
+        stopped_ = true;
+        timer_.stop();
+    }
+
+private:
+    void scheduleRetry() {
+        if (stopped_ || timer_.isActive()) return;
+        if (!disconnectedAt_.isValid()) disconnectedAt_.start();
+
+        int delayMs = backoff_.nextDelayMs();
+        qInfo() << "MQTT 재연결 대기:" << delayMs << "ms (" << backoff_.attempts() << "번째 시도)";
+        timer_.start(delayMs);
+    }
+
+    QMqttClient& client_;
+    ReconnectBackoff backoff_;
+    QTimer timer_;
+    QElapsedTimer disconnectedAt_;
+    int connectAttempts_ = 0;
+    bool stopped_ = false;
+};
+
+#endif
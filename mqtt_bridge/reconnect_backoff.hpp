@@ -0,0 +1,56 @@
+#ifndef RECONNECT_BACKOFF_HPP
+#define RECONNECT_BACKOFF_HPP
+
+#include <cstdint>
+#include <random>
+
+/*
+ * 재연결 대기 시간 (mosquitto 브리지와 Qt 클라이언트가 같이 사용)
+ * - 첫 재시도는 빠르게 (firstDelayMs, 브로커 재시작 / 순간 끊김은 대부분 바로 붙음)
+ * - 이후 baseDelayMs × 2^(n-1), 최대 maxDelayMs
+ * - 각 대기 시간을 [1 - jitter, 1] 비율로 무작위로 줄임 → 브로커가 재시작해도 장치들이 한꺼번에 붙지 않음
+ */
+struct ReconnectPolicy {
+    int firstDelayMs = 100;
+    int baseDelayMs = 500;
+    int maxDelayMs = 30000;
+    double jitter = 0.5;
+};
+
+class ReconnectBackoff {
+public:
+    explicit ReconnectBackoff(const ReconnectPolicy& policy = ReconnectPolicy())
+        : policy_(policy), rng_(std::random_device{}()) {}
+
+    /*
+     * 다음 재시도까지 기다릴 시간 (호출할 때마다 시도 횟수 증가)
+     */
+    int nextDelayMs() {
+        int64_t delay;
+        if (attempts_ == 0) {
+            delay = policy_.firstDelayMs;
+        } else {
+            delay = policy_.baseDelayMs;
+            for (int i = 1; i < attempts_ && delay < policy_.maxDelayMs; i++) delay *= 2;
+            if (delay > policy_.maxDelayMs) delay = policy_.maxDelayMs;
+        }
+        attempts_++;
+
+        std::uniform_real_distribution<double> scale(1.0 - policy_.jitter, 1.0);
+        return static_cast<int>(static_cast<double>(delay) * scale(rng_));
+    }
+
+    /*
+     * 연결 성공 시 호출 (다음 끊김은 다시 빠른 첫 재시도부터)
+     */
+    void reset() { attempts_ = 0; }
+
+    int attempts() const { return attempts_; }
+
+private:
+    ReconnectPolicy policy_;
+    std::mt19937 rng_;
+    int attempts_ = 0;
+};
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+ * MQTT 콜백 스레드 → 디바이스 스레드 명령 전달용 lock-free 단일 생산자 / 단일 소비자 링 버퍼
+ * - push(): 생산자(MQTT 콜백 스레드) 전용, 락 / 할당 / 시스템 콜 없음 (소비자가 자고 있을 때만 futex 깨우기)
+ * - pop() / wait(): 소비자(디바이스 스레드) 전용
+ * - 가득 차면 push()가 false (버린 수는 생산자가 셈)
+ * - Capacity는 2의 거듭제곱
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity는 2의 거듭제곱");
+
+public:
+    bool push(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tailCache_ == Capacity) {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head - tailCache_ == Capacity) return false;
+        }
+        items_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) futexWake();
+        return true;
+    }
+
+    bool pop(T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == headCache_) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail == headCache_) return false;
+        }
+        item = items_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * 소비자: 항목이 들어오거나 stop() 될 때까지 대기
+     * - 반환값: 항목이 있으면 true (timeout 또는 stop 시 false)
+     */
+    bool wait(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            if (!empty()) return true;
+            if (stopped_.load(std::memory_order_acquire)) return false;
+
+            auto remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero()) return false;
+
+            // seq를 읽은 뒤 다시 확인 → 그 사이 push()가 있으면 futex가 바로 반환됨
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            const uint32_t seq = seq_.load(std::memory_order_seq_cst);
+            if (empty() && !stopped_.load(std::memory_order_acquire)) {
+                futexWait(seq, remaining);
+            }
+            waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    /*
+     * 현재 대기 중인 항목 수 (어느 스레드에서나 조회 가능, 근사값)
+     */
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    void stop() {
+        stopped_.store(true, std::memory_order_release);
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        futexWake();
+    }
+
+    /*
+     * 소비자 스레드를 다시 시작하기 전에 호출 (stop() 해제)
+     */
+    void reset() { stopped_.store(false, std::memory_order_release); }
+
+private:
+    void futexWait(uint32_t expected, std::chrono::steady_clock::duration remaining) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+    }
+
+    void futexWake() {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    T items_[Capacity];
+
+    alignas(64) std::atomic<size_t> head_{0};    // 생산자가 씀
+    size_t tailCache_ = 0;                       // 생산자 소유
+    alignas(64) std::atomic<size_t> tail_{0};    // 소비자가 씀
+    size_t headCache_ = 0;                       // 소비자 소유
+
+    alignas(64) std::atomic<uint32_t> seq_{0};   // futex 주소 (push/stop마다 증가)
+    std::atomic<int> waiters_{0};
+    std::atomic<bool> stopped_{false};
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * 주기 텔레메트리 (바뀐 필드만 발행)
+ * - 정책이 상태를 정수 필드 배열로 내보내면(kTelemetry + sample()) 마지막으로 발행한 값과 비교
+ * - 평소에는 바뀐 필드만, snapshot 주기마다(또는 첫 발행) 전체 필드 발행
+ *   {"timestamp":..,"full":false,"fields":{"step":120,"panel":3}}
+ */
+struct TelemetryField {
+    std::string_view name;
+    bool boolean = false;     // JSON에 true/false로 출력
+};
+
+template <size_t N>
+class TelemetryDelta {
+public:
+    /*
+     * 발행할 JSON 만들기
+     * - full: 전체 필드 요청 (첫 발행이면 true로 바뀜)
+     * - 반환값: 포함한 필드 수 (0이면 발행할 것 없음)
+     */
+    size_t build(const TelemetryField (&fields)[N], const int32_t (&values)[N], bool& full,
+                 long long timestampMs, std::string& json) const {
+        full = full || !valid_;
+        json = "{\"timestamp\":" + std::to_string(timestampMs) + ",\"full\":" + (full ? "true" : "false") +
+               ",\"fields\":{";
+        size_t count = 0;
+        for (size_t i = 0; i < N; i++) {
+            if (!full && values[i] == last_[i]) continue;
+            if (count++ > 0) json += ',';
+            json += '"';
+            json += fields[i].name;
+            json += "\":";
+            if (fields[i].boolean) json += values[i] ? "true" : "false";
+            else json += std::to_string(values[i]);
+        }
+        json += "}}";
+        return count;
+    }
+
+    /*
+     * 발행에 성공한 값을 기준으로 저장 (실패하면 호출하지 않음 → 다음 발행에 다시 포함)
+     */
+    void commit(const int32_t (&values)[N]) {
+        for (size_t i = 0; i < N; i++) last_[i] = values[i];
+        valid_ = true;
+    }
+
+    void reset() { valid_ = false; }
+
+private:
+    int32_t last_[N] = {};
+    bool valid_ = false;
+};
+
+#endif
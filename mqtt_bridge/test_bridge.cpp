@@ -0,0 +1,340 @@
+/*
+ * mqtt_bridge 순수 구성 요소 단위 테스트 (브로커 / 드라이버 없이 실행)
+ * - 명령 표 완전 해시 + 페이로드 해석 (DeviceBridge<정책>::decode)
+ * - CommandCoalescer: 액추에이터별 최신 값 / 이산 명령 경계 / 가득 참
+ * - SpscQueue: 가득 참 / 순환 / wait 시간 초과 / 생산자-소비자 두 스레드
+ *
+ * 빌드 / 실행: make test (실패한 검사가 있으면 종료 코드 1)
+ */
+
+#include "device_policies.hpp"
+#include "command_coalescer.hpp"
+#include "spsc_queue.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static int g_checks = 0;
+static int g_failures = 0;
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        g_checks++;                                                                   \
+        if (!(cond)) {                                                                \
+            g_failures++;                                                             \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": 실패: " #cond << std::endl; \
+        }                                                                             \
+    } while (0)
+
+static bool sameCommand(const DeviceCommand& a, const DeviceCommand& b) {
+    if (a.op != b.op || a.argc != b.argc) return false;
+    for (int i = 0; i < a.argc; i++) {
+        if (a.args[i] != b.args[i]) return false;
+    }
+    return true;
+}
+
+template <typename Policy>
+static bool decode(const std::string& payload, DeviceCommand& out) {
+    char folded[DeviceBridge<Policy>::kMaxCommandLen];
+    size_t foldedLen = 0;
+    out = DeviceCommand();
+    return DeviceBridge<Policy>::decode(payload.data(), payload.size(), folded, foldedLen, out);
+}
+
+template <typename Policy>
+static bool decodesTo(const std::string& payload, const DeviceCommand& expected) {
+    DeviceCommand cmd;
+    return decode<Policy>(payload, cmd) && sameCommand(cmd, expected);
+}
+
+template <typename Policy>
+static bool rejects(const std::string& payload) {
+    DeviceCommand cmd;
+    return !decode<Policy>(payload, cmd);
+}
+
+static std::string upper(std::string s) {
+    for (char& c : s) {
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    }
+    return s;
+}
+
+/*
+ * 표의 모든 항목: 그대로 / 대문자 / 앞뒤 공백·개행이 붙어도 같은 명령
+ */
+template <typename Policy>
+static void testTableRoundTrip() {
+    static_assert(DeviceBridge<Policy>::kTable.valid, "완전 해시 seed 없음");
+    for (const CommandEntry& entry : Policy::kCommands) {
+        std::string payload(entry.payload);
+        CHECK(decodesTo<Policy>(payload, entry.command));
+        CHECK(decodesTo<Policy>(upper(payload), entry.command));
+        CHECK(decodesTo<Policy>(" \t" + payload + "\r\n", entry.command));
+    }
+
+    CHECK(rejects<Policy>(""));
+    CHECK(rejects<Policy>("   \r\n"));
+    CHECK(rejects<Policy>("o"));
+    CHECK(rejects<Policy>("onn"));
+    CHECK(rejects<Policy>("o n"));
+    CHECK(rejects<Policy>(std::string(DeviceBridge<Policy>::kMaxCommandLen, 'a')));
+}
+
+static void testCommandTable() {
+    testTableRoundTrip<ConveyorPolicy>();
+    testTableRoundTrip<FeederPolicy>();
+    testTableRoundTrip<RobotArmPolicy>();
+    testTableRoundTrip<L298nPolicy>();
+
+    // 슬롯 충돌이 없는지 (항목마다 서로 다른 슬롯)
+    constexpr auto& table = DeviceBridge<RobotArmPolicy>::kTable;
+    constexpr size_t n = sizeof(RobotArmPolicy::kCommands) / sizeof(RobotArmPolicy::kCommands[0]);
+    size_t used = 0;
+    for (size_t s = 0; s < table.kSlots; s++) {
+        if (table.slots[s] >= 0) used++;
+    }
+    CHECK(used == n);
+}
+
+static void testRobotArmDecode() {
+    using P = RobotArmPolicy;
+
+    // 이전 이름(별칭) - 대소문자 / 공백과 무관
+    CHECK(decodesTo<P>("PICKUP", makeCommand(P::OP_ON)));
+    CHECK(decodesTo<P>("Start", makeCommand(P::OP_ON)));
+    CHECK(decodesTo<P>("STOP", makeCommand(P::OP_OFF)));
+    CHECK(decodesTo<P>("Halt\n", makeCommand(P::OP_OFF)));
+    CHECK(decodesTo<P>("Base_Left", makeCommand(P::OP_SERVO, 0, 30)));
+    CHECK(decodesTo<P>("BASE_RIGHT", makeCommand(P::OP_SERVO, 0, 150)));
+    CHECK(decodesTo<P>("  base_Center\r\n", makeCommand(P::OP_SERVO, 0, 90)));
+
+    // servo<N> <각도>
+    CHECK(decodesTo<P>("servo0 0", makeCommand(P::OP_SERVO, 0, 0)));
+    CHECK(decodesTo<P>("servo3 250", makeCommand(P::OP_SERVO, 3, 250)));
+    CHECK(decodesTo<P>("SERVO2 45", makeCommand(P::OP_SERVO, 2, 45)));
+    CHECK(decodesTo<P>("Servo1  90\r\n", makeCommand(P::OP_SERVO, 1, 90)));
+
+    CHECK(rejects<P>("servo4 10"));      // 관절 범위 밖
+    CHECK(rejects<P>("servo1 90x"));     // 숫자 뒤 남은 문자
+    CHECK(rejects<P>("servo-1 5"));      // 음수 관절
+    CHECK(rejects<P>("servo 1 5"));      // servo 뒤에 관절 번호가 바로 와야 함
+    CHECK(rejects<P>("servo1 -5"));
+    CHECK(rejects<P>("servo1 251"));
+    CHECK(rejects<P>("servo1 +5"));
+    CHECK(rejects<P>("servo1"));
+    CHECK(rejects<P>("servo1 "));
+    CHECK(rejects<P>("servo1\t5"));
+    CHECK(rejects<P>("servo15"));
+    CHECK(rejects<P>("servo99999999999 5"));
+    CHECK(rejects<P>("servox 5"));
+    CHECK(rejects<P>("servo"));
+
+    // 다른 정책은 servo 패턴이 없음
+    CHECK(rejects<ConveyorPolicy>("servo1 90"));
+}
+
+static void testOtherPolicies() {
+    CHECK(decodesTo<ConveyorPolicy>("Error_Mode", makeCommand(ConveyorPolicy::OP_ERROR_MODE)));
+    CHECK(decodesTo<FeederPolicy>("REVERSE", makeCommand(FeederPolicy::OP_REVERSE)));
+    CHECK(decodesTo<L298nPolicy>("ON", makeCommand(L298nPolicy::OP_MOTOR, 'A', 1, 99)));
+    CHECK(decodesTo<L298nPolicy>("off", L298nPolicy::kShutdown));
+}
+
+static void testCoalescer() {
+    using P = RobotArmPolicy;
+    using Coalescer = CommandCoalescer<P::kActuators, 8>;
+    Coalescer::Entry out[8];
+
+    // 같은 관절은 최신 값만, 처음 들어온 자리 유지
+    {
+        Coalescer c;
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 10), 0));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 20), 0));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 1, 5), 1));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 30), 0));
+        CHECK(c.size() == 2);
+        CHECK(c.coalesced() == 2);
+        CHECK(c.coalesced(0) == 2);
+        CHECK(c.coalesced(1) == 0);
+
+        size_t n = c.take(out);
+        CHECK(n == 2);
+        CHECK(sameCommand(out[0].command, makeCommand(P::OP_SERVO, 0, 30)) && out[0].slot == 0);
+        CHECK(sameCommand(out[1].command, makeCommand(P::OP_SERVO, 1, 5)) && out[1].slot == 1);
+        CHECK(c.empty());
+
+        // take() 뒤에는 새 항목으로 쌓임
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 40), 0));
+        CHECK(c.size() == 1);
+        CHECK(c.coalesced(0) == 2);
+    }
+
+    // 이산 명령은 경계 - 경계 앞의 값은 경계 뒤의 값으로 덮이지 않음
+    {
+        Coalescer c;
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 10), 0));
+        CHECK(c.push(makeCommand(P::OP_OFF), -1));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 20), 0));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 25), 0));
+        CHECK(c.push(makeCommand(P::OP_ON), -1));
+        CHECK(c.push(makeCommand(P::OP_ON), -1));
+
+        size_t n = c.take(out);
+        CHECK(n == 5);
+        CHECK(sameCommand(out[0].command, makeCommand(P::OP_SERVO, 0, 10)));
+        CHECK(sameCommand(out[1].command, makeCommand(P::OP_OFF)) && out[1].slot == -1);
+        CHECK(sameCommand(out[2].command, makeCommand(P::OP_SERVO, 0, 25)));
+        CHECK(sameCommand(out[3].command, makeCommand(P::OP_ON)));
+        CHECK(sameCommand(out[4].command, makeCommand(P::OP_ON)));   // 이산 명령은 합치지 않음
+        CHECK(c.coalesced() == 1);
+    }
+
+    // 범위 밖 슬롯은 이산 명령으로 처리
+    {
+        Coalescer c;
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 10), 0));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 20), static_cast<int>(P::kActuators)));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 0, 30), 0));
+        size_t n = c.take(out);
+        CHECK(n == 3);
+        CHECK(out[1].slot == -1);
+        CHECK(c.coalesced() == 0);
+    }
+
+    // 가득 차면 새 항목은 버리지만 대기 중인 관절 값은 계속 덮어씀
+    {
+        Coalescer c;
+        for (int i = 0; i < 7; i++) CHECK(c.push(makeCommand(P::OP_INIT), -1));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 2, 10), 2));
+        CHECK(c.size() == 8);
+        CHECK(!c.push(makeCommand(P::OP_OFF), -1));
+        CHECK(!c.push(makeCommand(P::OP_SERVO, 3, 10), 3));
+        CHECK(c.push(makeCommand(P::OP_SERVO, 2, 99), 2));
+        CHECK(c.dropped() == 2);
+
+        size_t n = c.take(out);
+        CHECK(n == 8);
+        CHECK(sameCommand(out[7].command, makeCommand(P::OP_SERVO, 2, 99)));
+    }
+
+    // 해석 → actuatorSlot → 합치기 (L298N: 모터 A/B별 최신 값, 정지는 경계)
+    {
+        using L = L298nPolicy;
+        CommandCoalescer<L::kActuators, 8> c;
+        CommandCoalescer<L::kActuators, 8>::Entry lout[8];
+        const DeviceCommand cmds[] = {
+            makeCommand(L::OP_MOTOR, 'A', 1, 10), makeCommand(L::OP_MOTOR, 'b', -1, 20),
+            makeCommand(L::OP_MOTOR, 'a', 1, 50), makeCommand(L::OP_STOP),
+            makeCommand(L::OP_MOTOR, 'A', 1, 70),
+        };
+        for (const DeviceCommand& cmd : cmds) CHECK(c.push(cmd, L::actuatorSlot(cmd)));
+        size_t n = c.take(lout);
+        CHECK(n == 4);
+        CHECK(sameCommand(lout[0].command, cmds[2]));
+        CHECK(sameCommand(lout[1].command, cmds[1]));
+        CHECK(sameCommand(lout[2].command, cmds[3]));
+        CHECK(sameCommand(lout[3].command, cmds[4]));
+    }
+
+    // 설정값 명령이 없는 정책 (Slots = 0)
+    {
+        CommandCoalescer<ConveyorPolicy::kActuators, 4> c;
+        CommandCoalescer<ConveyorPolicy::kActuators, 4>::Entry cout_[4];
+        CHECK(c.push(makeCommand(ConveyorPolicy::OP_ON), 0));
+        CHECK(c.push(makeCommand(ConveyorPolicy::OP_ON), 0));
+        CHECK(c.take(cout_) == 2);
+        CHECK(cout_[0].slot == -1);
+    }
+}
+
+static void testSpscQueue() {
+    // 가득 참 / 순서 / 인덱스가 Capacity를 여러 번 넘어가는 순환
+    {
+        SpscQueue<int, 4> q;
+        int v = 0;
+        CHECK(q.empty());
+        CHECK(!q.pop(v));
+        for (int i = 0; i < 4; i++) CHECK(q.push(i));
+        CHECK(!q.push(4));
+        CHECK(q.size() == 4);
+        for (int i = 0; i < 4; i++) CHECK(q.pop(v) && v == i);
+        CHECK(!q.pop(v));
+
+        int next = 100;
+        int expect = 100;
+        bool ordered = true;
+        for (int round = 0; round < 50; round++) {
+            for (int k = 0; k < 3; k++) ordered &= q.push(next++);
+            for (int k = 0; k < 3; k++) ordered &= q.pop(v) && v == expect++;
+        }
+        CHECK(ordered);
+        CHECK(q.empty());
+    }
+
+    // wait(): 비어 있으면 시간 초과, 항목이 있으면 바로, stop() 뒤에는 false
+    {
+        SpscQueue<int, 4> q;
+        auto t0 = std::chrono::steady_clock::now();
+        CHECK(!q.wait(std::chrono::milliseconds(20)));
+        CHECK(std::chrono::steady_clock::now() - t0 >= std::chrono::milliseconds(20));
+
+        CHECK(q.push(1));
+        CHECK(q.wait(std::chrono::milliseconds(0)));
+
+        int v = 0;
+        CHECK(q.pop(v));
+        q.stop();
+        CHECK(!q.wait(std::chrono::seconds(5)));
+        q.reset();
+        CHECK(!q.wait(std::chrono::milliseconds(1)));
+    }
+
+    // 두 스레드: 생산자는 가득 차면 다시 시도, 소비자는 wait()로 잠들었다 깨면서 순서대로 받음
+    {
+        constexpr uint32_t kCount = 200000;
+        SpscQueue<uint32_t, 64> q;
+        std::thread producer([&] {
+            for (uint32_t i = 1; i <= kCount; i++) {
+                while (!q.push(i)) std::this_thread::yield();
+                if ((i & 0x3FFF) == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+
+        uint32_t expect = 1;
+        bool ordered = true;
+        while (expect <= kCount) {
+            if (!q.wait(std::chrono::seconds(5))) {
+                ordered = false;
+                break;
+            }
+            uint32_t v = 0;
+            while (q.pop(v)) {
+                if (v != expect) ordered = false;
+                expect++;
+            }
+        }
+        producer.join();
+        CHECK(ordered);
+        CHECK(expect == kCount + 1);
+        CHECK(q.empty());
+    }
+}
+
+int main() {
+    testCommandTable();
+    testRobotArmDecode();
+    testOtherPolicies();
+    testCoalescer();
+    testSpscQueue();
+
+    if (g_failures > 0) {
+        std::cerr << "실패 " << g_failures << " / 검사 " << g_checks << std::endl;
+        return 1;
+    }
+    std::cout << "통과: 검사 " << g_checks << "개" << std::endl;
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include "tls_session_cache.hpp"
+
+TlsSessionCache::~TlsSessionCache() {
+    clear();
+}
+
+int TlsSessionCache::exIndex() {
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+SSL_CTX* TlsSessionCache::createContext() {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_client_method());
+    if (!ctx) return nullptr;
+
+    // 클라이언트 캐시는 콜백으로 직접 보관 (내부 저장소는 클라이언트에서 쓰이지 않음)
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, onNewSession);
+    SSL_CTX_set_info_callback(ctx, onInfo);
+    SSL_CTX_set_ex_data(ctx, exIndex(), this);
+    return ctx;
+}
+
+void TlsSessionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session_) {
+        SSL_SESSION_free(session_);
+        session_ = nullptr;
+    }
+}
+
+TlsSessionCache* TlsSessionCache::fromSsl(const SSL* ssl) {
+    return static_cast<TlsSessionCache*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), exIndex()));
+}
+
+int TlsSessionCache::onNewSession(SSL* ssl, SSL_SESSION* session) {
+    TlsSessionCache* cache = fromSsl(ssl);
+    if (!cache) return 0;
+
+    // 1 반환 → session 참조를 가져옴 (이전 세션은 해제)
+    std::lock_guard<std::mutex> lock(cache->mutex_);
+    if (cache->session_) SSL_SESSION_free(cache->session_);
+    cache->session_ = session;
+    return 1;
+}
+
+void TlsSessionCache::onInfo(const SSL* ssl, int where, int) {
+    TlsSessionCache* cache = fromSsl(ssl);
+    if (!cache) return;
+
+    // 첫 핸드셰이크 시작 (ClientHello 만들기 전)에만 세션 지정
+    if ((where & SSL_CB_HANDSHAKE_START) && SSL_in_before(ssl)) {
+        std::lock_guard<std::mutex> lock(cache->mutex_);
+        if (cache->session_ && SSL_SESSION_is_resumable(cache->session_)) {
+            SSL_set_session(const_cast<SSL*>(ssl), cache->session_);
+        }
+    }
+
+    if ((where & SSL_CB_HANDSHAKE_DONE) && !SSL_is_server(ssl)) {
+        bool reused = SSL_session_reused(const_cast<SSL*>(ssl)) == 1;
+        cache->handshakes_.fetch_add(1, std::memory_order_relaxed);
+        if (reused) cache->resumed_.fetch_add(1, std::memory_order_relaxed);
+        cache->lastResumed_.store(reused, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef TLS_SESSION_CACHE_HPP
+#define TLS_SESSION_CACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <openssl/ssl.h>
+
+/*
+ * 재연결할 때 TLS 세션 재사용 (전체 핸드셰이크 + 클라이언트 인증서 서명 생략)
+ * - createContext(): 세션 캐시 콜백을 단 SSL_CTX 생성 → mosquitto에 MOSQ_OPT_SSL_CTX로 넘김
+ *   (MOSQ_OPT_SSL_CTX_WITH_DEFAULTS라서 CA / 인증서 / 검증 설정은 mosquitto_tls_set() 값을 그대로 씀)
+ * - 핸드셰이크가 끝나면 서버가 준 세션(TLS 1.2 세션 ID / 1.3 티켓 - 브리지는 TLS 1.2 고정)을 보관하고,
+ *   다음 핸드셰이크 시작 때 SSL_set_session()으로 넣어서 재개 요청
+ * - 서버가 재개를 거절하면 보통 핸드셰이크로 진행 (연결은 그대로 됨)
+ */
+class TlsSessionCache {
+public:
+    TlsSessionCache() = default;
+    ~TlsSessionCache();
+
+    TlsSessionCache(const TlsSessionCache&) = delete;
+    TlsSessionCache& operator=(const TlsSessionCache&) = delete;
+
+    /*
+     * 반환값: 새 SSL_CTX (호출한 쪽이 SSL_CTX_free, 이 객체보다 먼저 해제되거나 같이 해제될 것)
+     */
+    SSL_CTX* createContext();
+
+    /*
+     * 보관 중인 세션 버리기 (서버 인증서가 바뀌었을 때 등)
+     */
+    void clear();
+
+    uint64_t handshakes() const { return handshakes_.load(std::memory_order_relaxed); }
+    uint64_t resumed() const { return resumed_.load(std::memory_order_relaxed); }
+    bool lastResumed() const { return lastResumed_.load(std::memory_order_relaxed); }
+
+private:
+    static int onNewSession(SSL* ssl, SSL_SESSION* session);
+    static void onInfo(const SSL* ssl, int where, int ret);
+    static TlsSessionCache* fromSsl(const SSL* ssl);
+    static int exIndex();
+
+    std::mutex mutex_;
+    SSL_SESSION* session_ = nullptr;
+    std::atomic<uint64_t> handshakes_{0};
+    std::atomic<uint64_t> resumed_{0};
+    std::atomic<bool> lastResumed_{false};
+};
+
+#endif
@@ -7,6 +7,8 @@
 #include <linux/delay.h>
 #include <linux/slab.h>
 
+#include "factory_cmd_abi.h" // 바이너리 명령 ABI (../mqtt_bridge)
+
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("VIsionCraft_jang");
 MODULE_DESCRIPTION("Robot Arm Driver with Servo Control");
@@ -187,23 +189,10 @@ static int robot_motion_thread(void *data)
     return 0;
 }
 
-// 사용자가 디바이스 파일에 명령어를 입력할 때 호출되는 함수
-static ssize_t robot_arm_write(struct file *file, const char __user *buf, size_t len, loff_t *offset)
+// 모드 변경 -> 텍스트 명령(on/off/user/init)이랑 ioctl(FACTORY_IOC_MODE)이 같이 사용
+static int robot_arm_set_mode(int mode)
 {
-    int servo_id, angle;
-
-    // 명령어가 주어진 버퍼보다 길면 에러처리
-    if (len > BUF_LEN - 1)
-        return -1;
-
-    // 사용자 공간에서 사용자가 입력한 명령어를 커널 공간으로 복사하기
-    if (copy_from_user(command_buffer, buf, len))
-        return -1;
-
-    command_buffer[len] = '\0';
-
-    // 명령어 처리
-    if (strncmp(command_buffer, "on", 2) == 0)
+    if (mode == FACTORY_MODE_ON)
     {
         // on 명령 - 자동 모드 시작
         auto_mode = true;
@@ -211,7 +200,7 @@ static ssize_t robot_arm_write(struct file *file, const char __user *buf, size_t
         current_sequence = 0;
         printk(KERN_INFO "Robot Arm: Auto mode ON - starting continuous operation\n");
     }
-    else if (strncmp(command_buffer, "off", 3) == 0)
+    else if (mode == FACTORY_MODE_OFF)
     {
         // off 명령 - 모든 모드 비활성화
         auto_mode = false;
@@ -224,14 +213,14 @@ static ssize_t robot_arm_write(struct file *file, const char __user *buf, size_t
         //move_servo_smooth(0, 0, 1);
         printk(KERN_INFO "Robot Arm: All modes OFF - returning to home position\n");
     }
-    else if (strncmp(command_buffer, "user", 4) == 0)
+    else if (mode == FACTORY_MODE_USER)
     {
         // user 명령 - 수동 모드 시작
         auto_mode = false;
         user_mode = true;
         printk(KERN_INFO "Robot Arm: User mode ON - manual control enabled\n");
     }
-    else if (strncmp(command_buffer, "init", 4) == 0)
+    else if (mode == FACTORY_MODE_INIT)
     {
         // 모든 서보모터를 초기 위치로 돌려서 초기화시키기
         move_servo_smooth(3, 0, 1); //엔드
@@ -240,19 +229,54 @@ static ssize_t robot_arm_write(struct file *file, const char __user *buf, size_t
         move_servo_smooth(0, 0, 1);
         printk(KERN_INFO "Robot Arm: Initialized to default position\n");
     }
-    else if (sscanf(command_buffer, "servo%d %d", &servo_id, &angle) == 2)
-    {
-        // 수동 모드에서만 개별 서보모터 제어 가능
-        if (user_mode) {
-            if (servo_id >= 0 && servo_id < NUM_SERVOS && angle >= 0 && angle <= 250) {
-                servos[servo_id].current_angle = angle;
-                set_servo_pwm(servo_id, angle);  // 직접 PWM 신호 보내기
-                printk(KERN_INFO "Robot Arm: Servo%d moved to %d degrees\n", servo_id, angle);
-            }
-        } else {
-            printk(KERN_INFO "Robot Arm: Manual control disabled - use 'user' command first\n");
-        }
+    else
+        return -EINVAL;
+
+    return 0;
+}
+
+// 서보모터 하나 움직이기 -> 수동 모드에서만 가능 (아니면 -EPERM)
+static int robot_arm_set_servo(int servo_id, int angle)
+{
+    if (!user_mode) {
+        printk(KERN_INFO "Robot Arm: Manual control disabled - use 'user' command first\n");
+        return -EPERM;
     }
+    if (servo_id < 0 || servo_id >= NUM_SERVOS || angle < 0 || angle > 250)
+        return -EINVAL;
+
+    servos[servo_id].current_angle = angle;
+    set_servo_pwm(servo_id, angle);  // 직접 PWM 신호 보내기
+    printk(KERN_INFO "Robot Arm: Servo%d moved to %d degrees\n", servo_id, angle);
+    return 0;
+}
+
+// 사용자가 디바이스 파일에 명령어를 입력할 때 호출되는 함수
+static ssize_t robot_arm_write(struct file *file, const char __user *buf, size_t len, loff_t *offset)
+{
+    int servo_id, angle;
+
+    // 명령어가 주어진 버퍼보다 길면 에러처리
+    if (len > BUF_LEN - 1)
+        return -1;
+
+    // 사용자 공간에서 사용자가 입력한 명령어를 커널 공간으로 복사하기
+    if (copy_from_user(command_buffer, buf, len))
+        return -1;
+
+    command_buffer[len] = '\0';
+
+    // 명령어 처리
+    if (strncmp(command_buffer, "on", 2) == 0)
+        robot_arm_set_mode(FACTORY_MODE_ON);
+    else if (strncmp(command_buffer, "off", 3) == 0)
+        robot_arm_set_mode(FACTORY_MODE_OFF);
+    else if (strncmp(command_buffer, "user", 4) == 0)
+        robot_arm_set_mode(FACTORY_MODE_USER);
+    else if (strncmp(command_buffer, "init", 4) == 0)
+        robot_arm_set_mode(FACTORY_MODE_INIT);
+    else if (sscanf(command_buffer, "servo%d %d", &servo_id, &angle) == 2)
+        robot_arm_set_servo(servo_id, angle);
     else
     {
         // 명령어 잘못 입력한 경우 -> 강사님이 printk는 리소스 많이 잡아먹는다고 하셔서 따로 안 적음...
@@ -288,12 +312,43 @@ static ssize_t robot_arm_read(struct file *file, char __user *buf, size_t len, l
     return status_len;
 }
 
+// 바이너리 명령 (factory_cmd_abi.h) -> 브리지가 문자열 없이 구조체로 보냄 (모드 / 서보)
+static long robot_arm_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    struct factory_mode_cmd mode_cmd;
+    struct factory_servo_cmd servo_cmd;
+
+    switch (cmd)
+    {
+    case FACTORY_IOC_VERSION:
+        return put_user((__u32)FACTORY_CMD_ABI_VERSION, (__u32 __user *)arg);
+
+    case FACTORY_IOC_MODE:
+        if (copy_from_user(&mode_cmd, (void __user *)arg, sizeof(mode_cmd)))
+            return -EFAULT;
+        if (mode_cmd.version != FACTORY_CMD_ABI_VERSION)
+            return -EPROTO;
+        return robot_arm_set_mode(mode_cmd.mode);
+
+    case FACTORY_IOC_SERVO:
+        if (copy_from_user(&servo_cmd, (void __user *)arg, sizeof(servo_cmd)))
+            return -EFAULT;
+        if (servo_cmd.version != FACTORY_CMD_ABI_VERSION)
+            return -EPROTO;
+        return robot_arm_set_servo(servo_cmd.joint, servo_cmd.angle);
+
+    default:
+        return -ENOTTY;
+    }
+}
+
 // 캐릭터 디바이스 파일의 명령어 -> 사용자 프로그램이 /dev/robot_arm에 읽거나 쓸 때 호출될 함수들
 static struct file_operations fops =
     {
         .owner = THIS_MODULE,
         .write = robot_arm_write, // write할 때
         .read = robot_arm_read,   // read할 때
+        .unlocked_ioctl = robot_arm_ioctl, // 바이너리 명령
 };
 
 // insmod할 때 호출되는 초기화 함수